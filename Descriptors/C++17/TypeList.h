@@ -64,11 +64,15 @@ struct TypeList
   static constexpr auto accumulate(F func) { return (TypeList<>{} + ... + func(TypeBox<Ts>{})); }
   
   template<typename F>
-  static inline void foreach(F func) { (func(TypeBox<Ts> {}), ...); }
+  static inline void foreach([[maybe_unused]] F func) { (func(TypeBox<Ts> {}), ...); }
   
   template<auto I, typename T>
   static constexpr auto generate() { return generate_<T>(std::make_index_sequence<I>{}); }
   
+  // Список из I типов, i-й тип задает func(ValueBox<i>{})
+  template<auto I, typename F>
+  static constexpr auto generate(F func) { return generate_f_(func, std::make_index_sequence<I>{}); }
+  
   template<typename F>
   static constexpr auto transform(F func) { return TypeList<type_unbox<decltype(func(TypeBox<Ts>{}))>...>{}; }
   
@@ -82,7 +86,7 @@ struct TypeList
   //static consteval auto filter(TypeBox<T> box, auto pred) { return filter<T>(pred); }
   
   template<typename T>
-  static constexpr auto filter(T pred)
+  static constexpr auto filter([[maybe_unused]] T pred)
   {
     return (TypeList<>{} + ... + std::conditional_t<pred(TypeBox<Ts>{}), TypeList<Ts>, TypeList<>>{});
   }
@@ -96,6 +100,9 @@ private:
   
   template<typename T, auto... Is>
   static constexpr auto generate_(std::index_sequence<Is...>) { return TypeList<type_unbox<decltype((Is, TypeBox<T>{}))>...>{}; }
+
+  template<typename F, auto... Is>
+  static constexpr auto generate_f_(F func, std::index_sequence<Is...>) { return TypeList<type_unbox<decltype(func(ValueBox<Is>{}))>...>{}; }
   
   
   template<typename F>
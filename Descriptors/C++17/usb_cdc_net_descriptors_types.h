@@ -0,0 +1,182 @@
+#pragma once
+
+//==============================================================================
+// NTB Parameters (CDC NCM 1.0 spec. Table 6-3, ответ на GET_NTB_PARAMETERS)
+// Размеры NTB кратны wMaxPacketSize: NTB максимального размера не требует ZLP
+//==============================================================================
+template<USB_SPEED speed,
+         uint32_t ntb_in_max = 16384,     // желаемый размер NTB, байт (округляется вниз)
+         uint32_t ntb_out_max = 16384,
+         uint16_t ndp_divisor = 4,        // выравнивание начала датаграмм
+         uint16_t ndp_alignment = 4,      // выравнивание NDP
+         uint16_t out_max_datagrams = 0>  // 0 - без ограничения
+class NCM_NTB_PARAMETERS
+{
+  static_assert(speed != USB_SPEED::SUPER, "SuperSpeed requires endpoint companion descriptors");
+  static constexpr uint32_t Round(uint32_t size) { return size / BulkMaxPacketSize() * BulkMaxPacketSize(); }
+  static constexpr bool IsPow2(uint32_t x) { return x && !(x & (x - 1)); }
+public:
+  static constexpr USB_SPEED Speed() { return speed; }
+  static constexpr uint16_t BulkMaxPacketSize() { return (speed == USB_SPEED::FULL) ? 64 : 512; }
+  static constexpr uint32_t NtbInMaxSize() { return Round(ntb_in_max); }
+  static constexpr uint32_t NtbOutMaxSize() { return Round(ntb_out_max); }
+  static constexpr uint16_t NdpDivisor() { return ndp_divisor; }
+  static constexpr uint16_t NdpAlignment() { return ndp_alignment; }
+  static constexpr uint16_t NtbOutMaxDatagrams() { return out_max_datagrams; }
+  // Датаграмм максимального размера в одном NTB IN (NTH16 12 байт, NDP16 8 + 4 на датаграмму)
+  static constexpr uint32_t DatagramsPerNtbIn(uint16_t segment = 1514)
+  {
+    uint32_t slot = (segment + ndp_divisor - 1) / ndp_divisor * ndp_divisor + 4;
+    return (NtbInMaxSize() - 12 - 8 - 4 - ndp_alignment) / slot;
+  }
+
+  static_assert(NtbInMaxSize() >= 2048, "dwNtbInMaxSize less than 2048");
+  static_assert((NtbInMaxSize() <= 0xFFFF) && (NtbOutMaxSize() <= 0xFFFF), "NTB-16 size exceeds 65535");
+  static_assert(NtbOutMaxSize() >= 12 + 16 + 1514, "dwNtbOutMaxSize less than one Ethernet frame");
+  static_assert(IsPow2(ndp_divisor) && (ndp_divisor >= 4), "Wrong wNdpDivisor");
+  static_assert(IsPow2(ndp_alignment) && (ndp_alignment >= 4), "Wrong wNdpAlignment");
+
+  constexpr NCM_NTB_PARAMETERS()
+  {
+    uint8_t* p = buf;
+    auto put = [&p](uint32_t value, uint8_t size) { for (uint8_t i = 0; i < size; ++i) *p++ = uint8_t(value >> (8 * i)); };
+    put(sizeof(buf), 2);            // wLength
+    put(1, 2);                      // bmNtbFormatsSupported: NTB-16
+    put(NtbInMaxSize(), 4);         // dwNtbInMaxSize
+    put(ndp_divisor, 2);            // wNdpInDivisor
+    put(0, 2);                      // wNdpInPayloadRemainder
+    put(ndp_alignment, 2);          // wNdpInAlignment
+    put(0, 2);                      // wReserved
+    put(NtbOutMaxSize(), 4);        // dwNtbOutMaxSize
+    put(ndp_divisor, 2);            // wNdpOutDivisor
+    put(0, 2);                      // wNdpOutPayloadRemainder
+    put(ndp_alignment, 2);          // wNdpOutAlignment
+    put(out_max_datagrams, 2);      // wNtbOutMaxDatagrams
+  }
+  uint8_t buf[28]{};
+};
+
+//==============================================================================
+// Data интерфейс: alt 0 - без точек (сеть отключена), alt 1 - bulk IN/OUT.
+// Хост включает сеть SET_INTERFACE(alt 1), переход - Delta(0, 1)
+//==============================================================================
+template<typename TbDataInterface,
+         USB_SPEED speed,
+         uint8_t data_protocol,
+         typename TDataOutEp,
+         typename TDataInEp>
+class CDC_NET_DATA_INTERFACE : public INTERFACE_ALTERNATES<
+  INTERFACE<TbDataInterface, bAlternateSetting<0>, bInterfaceClass<0x0A>,
+    bInterfaceSubClass<0>, bInterfaceProtocol<data_protocol>, iInterface<0>>,
+
+  INTERFACE<TbDataInterface, bAlternateSetting<1>, bInterfaceClass<0x0A>,
+    bInterfaceSubClass<0>, bInterfaceProtocol<data_protocol>, iInterface<0>,
+
+    ENDPOINT_DESCRIPTOR
+    < TDataOutEp,
+      bmAttributes<epTYPE::Bulk>,
+      wMaxPacketSize<(speed == USB_SPEED::FULL) ? 64 : 512>,
+      bInterval<0> >,
+
+    ENDPOINT_DESCRIPTOR
+    < TDataInEp,
+      bmAttributes<epTYPE::Bulk>,
+      wMaxPacketSize<(speed == USB_SPEED::FULL) ? 64 : 512>,
+      bInterval<0> > >
+  > { };
+
+//==============================================================================
+// CDC Ethernet функция: Communication интерфейс + Data интерфейс
+//==============================================================================
+template<uint8_t subclass,               // 0x06 - ECM, 0x0D - NCM
+         uint8_t data_protocol,          // 0x00 - ECM, 0x01 - NCM Data
+         typename TbControlInterface,
+         typename TbDataInterface,
+         USB_SPEED speed,
+         uint8_t iMAC,                   // строка MAC адреса, 12 hex символов
+         typename TNotifyEp,
+         typename TDataOutEp,
+         typename TDataInEp,
+         typename... FDS>           // дополнительные функциональные дескрипторы
+class CDC_NET_FUNCTION : public INTERFACE_ASSOCIATION
+< bFunctionClass<2>, bFunctionSubClass<subclass>, bFunctionProtocol<0>, iFunction<0>,
+
+  INTERFACE<TbControlInterface, bAlternateSetting<0>, bInterfaceClass<2>,
+    bInterfaceSubClass<subclass>, bInterfaceProtocol<0>, iInterface<0>,
+
+    CDC_HEADER_FUNCTIONAL_DESCRIPTOR
+    < bDescriptorSubType<0x00>,    // Header Functional Descriptor
+      bcdCDC<0x01'20> >,           // CDC Version 1.20
+
+    CDC_UNION_FUNCTIONAL_DESCRIPTOR
+    < bDescriptorSubType<0x06>,    // Union Functional Descriptor
+      bControlInterface<TbControlInterface{}.value()>,
+      bSubordinateInterface0<TbDataInterface{}.value()> >,
+
+    CDC_ETHERNET_NETWORKING_FUNCTIONAL_DESCRIPTOR
+    < bDescriptorSubType<0x0F>,    // Ethernet Networking Functional Descriptor
+      iMACAddress<iMAC>,
+      bmEthernetStatistics<0>,
+      wMaxSegmentSize<1514>,
+      wNumberMCFilters<0>,
+      bNumberPowerFilters<0> >,
+
+    FDS...,
+
+    ENDPOINT_DESCRIPTOR            // NETWORK_CONNECTION / CONNECTION_SPEED_CHANGE
+    < TNotifyEp,
+      bmAttributes<epTYPE::Interrupt>,
+      wMaxPacketSize<16>,
+      bInterval<POLLING<epTYPE::Interrupt, speed>::template ForRate<32>()> > >,
+
+  CDC_NET_DATA_INTERFACE<TbDataInterface, speed, data_protocol, TDataOutEp, TDataInEp>
+>
+{
+  static_assert(is_bInterfaceNumber<TbControlInterface>() && is_bInterfaceNumber<TbDataInterface>(), "Not bInterfaceNumber record");
+  static_assert(is_bEndpointAddress<TNotifyEp>() && is_bEndpointAddress<TDataOutEp>() && is_bEndpointAddress<TDataInEp>(),
+                "Not bEndpointAddress record");
+  static_assert(speed != USB_SPEED::SUPER, "SuperSpeed requires endpoint companion descriptors");
+  static_assert(TNotifyEp::GetEpAddress() & (uint8_t)epDIR::IN, "Notification endpoint must be IN");
+  static_assert(!(TDataOutEp::GetEpAddress() & (uint8_t)epDIR::IN), "Wrong data OUT endpoint direction");
+  static_assert(TDataInEp::GetEpAddress() & (uint8_t)epDIR::IN, "Wrong data IN endpoint direction");
+public:
+  // SET_INTERFACE Data интерфейса: Delta(cur, alt)
+  using DATA_INTERFACE = CDC_NET_DATA_INTERFACE<TbDataInterface, speed, data_protocol, TDataOutEp, TDataInEp>;
+};
+
+//==============================================================================
+// CDC ECM (Ethernet Control Model)
+//==============================================================================
+template<typename TbControlInterface,
+         typename TbDataInterface,
+         USB_SPEED speed,
+         uint8_t iMAC,
+         typename TNotifyEp,
+         typename TDataOutEp,
+         typename TDataInEp>
+class CDC_ECM_FUNCTION : public CDC_NET_FUNCTION<0x06, 0x00, TbControlInterface, TbDataInterface,
+  speed, iMAC, TNotifyEp, TDataOutEp, TDataInEp> {};
+
+//==============================================================================
+// CDC NCM (Network Control Model): датаграммы агрегируются в NTB
+//==============================================================================
+template<typename TbControlInterface,
+         typename TbDataInterface,
+         USB_SPEED speed,
+         uint8_t iMAC,
+         typename TNotifyEp,
+         typename TDataOutEp,
+         typename TDataInEp,
+         typename TNtb = NCM_NTB_PARAMETERS<speed>,
+         uint8_t network_capabilities = 0>   // bmNetworkCapabilities
+class CDC_NCM_FUNCTION : public CDC_NET_FUNCTION<0x0D, 0x01, TbControlInterface, TbDataInterface,
+  speed, iMAC, TNotifyEp, TDataOutEp, TDataInEp,
+  CDC_NCM_FUNCTIONAL_DESCRIPTOR
+  < bDescriptorSubType<0x1A>,      // NCM Functional Descriptor
+    bcdNcmVersion<0x01'00>,
+    bmNetworkCapabilities<network_capabilities> > >
+{
+  static_assert(TNtb::Speed() == speed, "NTB parameters for another bus speed");
+public:
+  using NTB_PARAMETERS = TNtb;
+};
@@ -5,6 +5,8 @@ template<typename T> constexpr bool is_Descriptor() { return std::is_base_of_v<D
 template<typename T> constexpr bool is_DescriptorList() { return std::is_base_of_v<DESCRIPTOR_LIST_BASE, T>; }
 template<typename T> constexpr bool is_DescriptorListElement() { return is_Descriptor<T>() || is_DescriptorList<T>(); }
 template<typename T> constexpr bool is_ConfigurationDescriptor() { return std::is_base_of_v<CONFIGURATION_DESCRIPTOR_BASE,T>; }
+template<typename T> constexpr bool is_DeviceConfiguration() { return std::is_base_of_v<DEVICE_CONFIGURATION_BASE,T>; }
+template<typename T> constexpr bool is_GatheredConfiguration() { return std::is_base_of_v<GATHERED_CONFIGURATION_BASE,T>; }
 template<typename T> constexpr bool is_InterfaceDescriptor() { return std::is_base_of_v<INTERFACE_DESCRIPTOR_BASE,T>; }
 template<typename T> constexpr bool is_EndpointDescriptor() { return std::is_base_of_v<ENDPOINT_DESCRIPTOR_BASE,T>; }
 template<typename T> constexpr bool is_Interface() { return std::is_base_of_v<INTERFACE_BASE, T>; }
@@ -18,6 +20,10 @@ template<typename T> constexpr bool is_bmAttributes_CONFIG()
 {
   return is_bmAttributes<T>() && std::is_same_v<typename T::sub_type, cfg_Attr>;
 }
+template<typename T> constexpr bool is_bmAttributes_DFU()
+{
+  return is_bmAttributes<T>() && std::is_same_v<typename T::sub_type, dfu_Attr>;
+}
 template<typename RCRD>
 constexpr auto copy_buf(RCRD rcrd, uint8_t **p)
 {
@@ -80,9 +86,10 @@ public:
   {
     return GetEndpoints().size();
   }
-  static constexpr uint8_t InterfacesCount()
+  static constexpr uint8_t InterfacesCount() // Альтернативные настройки не считаются
   {
-    return GetInterfaces().size();
+    return GetInterfaces().filter([](auto x) 
+                                  { return type_unbox<decltype(x)>::GetAlternateSetting() == 0; }).size();
   }
   
   uint8_t buf[(sizeof(DSCS::buf)+...)]{};
@@ -122,7 +129,8 @@ class DEVICE_DESCRIPTOR : public DESCRIPTOR<DescriptorType::DEVICE,
   static_assert(is_bNumConfigurations<TbNumConfigurations>(), "Not bNumConfigurations record");
   static constexpr auto ep0sz =  TbMaxPacketSize0{}.value();    
   static_assert( (ep0sz==8)||(ep0sz==16)||(ep0sz==32)||(ep0sz==64),"Wrong TbMaxPacketSize0 size");
-  
+public:
+  static constexpr uint8_t GetMaxPacketSize0() { return ep0sz; }
 };
 
 //==============================================================================
@@ -151,7 +159,8 @@ struct DEVICE_QUALIFIER_DESCRIPTOR : public DESCRIPTOR<DescriptorType::DEVICE_QU
 //==============================================================================
 template<auto... args> class bmAttributes : public BMATTRIBUTES_BASE
 {
-  static_assert((sizeof...(args)>0)&&(sizeof...(args)<4),"Wrong bmAttributes arguments");
+  static constexpr bool dfu = (std::is_same_v<decltype(args),dfu_Attr> && ...);
+  static_assert((sizeof...(args)>0)&&((sizeof...(args)<4)||dfu),"Wrong bmAttributes arguments");
 
   template<auto arg1> static constexpr auto Chek1Args()
   {
@@ -173,7 +182,8 @@ template<auto... args> class bmAttributes : public BMATTRIBUTES_BASE
   }
   static constexpr auto CheckArgs()
   {
-    if constexpr (sizeof...(args)==1) return Chek1Args<args...>();
+    if constexpr (dfu) return dfu_Attr{};   // DFU: любая комбинация атрибутов
+    else if constexpr (sizeof...(args)==1) return Chek1Args<args...>();
     else if constexpr (sizeof...(args)==2) return Chek2Args<args...>();
     else if constexpr (sizeof...(args)==3) return Chek3Args<args...>();
     else return;
@@ -220,7 +230,7 @@ template<typename TbConfigurationValue,
          typename TbmAttributes,
          typename TbMaxPower,
          typename...DSCS>
-class DEVICE_CONFIGURATION_DESCRIPTOR
+class DEVICE_CONFIGURATION_DESCRIPTOR : public DEVICE_CONFIGURATION_BASE
 {
   static_assert(is_bConfigurationValue<TbConfigurationValue>(), "Not bConfigurationValue record");
   static_assert(is_iConfiguration<TiConfiguration>(),    "Not iConfiguration record");
@@ -237,19 +247,49 @@ class DEVICE_CONFIGURATION_DESCRIPTOR
                                              TbmAttributes,
                                              TbMaxPower>;
   
-  static_assert(DESCRIPTOR_LIST<DSCS...>::GetEndpoints().transform(
-                  [](auto eps)
-                  { 
-                    return TypeBox<typename type_unbox<decltype(eps)>::bEndpointAddress>{}; 
-                  }).is_unique(), "Duplicate Endpoints!"); 
+  struct EP_OWNER { bool is_if; uint8_t num; uint8_t alt; uint8_t ep; };
+
+  template<typename T>
+  static constexpr EP_OWNER Owner()
+  {
+    if constexpr (is_InterfaceDescriptor<T>()) return { true, T::GetInterfaceNumber(), T::GetAlternateSetting(), 0 };
+    else if constexpr (is_EndpointDescriptor<T>()) return { false, 0, 0, T::GetEpAddress() };
+    else return { false, 0, 0, 0 };
+  }
+
+  // Точка может повторяться только в разных альтернативных настройках одного интерфейса
+  template<typename... ITEMS>
+  static constexpr bool UniqueEndpoints(TypeList<ITEMS...>)
+  {
+    constexpr EP_OWNER dsc[] { Owner<ITEMS>()... };
+    int16_t owner_if[256]{}, owner_alt[256]{};
+    for (auto& x : owner_if) x = -1;
+    uint8_t num = 0, alt = 0;
+    for (auto& d : dsc)
+    {
+      if (d.is_if) { num = d.num; alt = d.alt; }
+      else if (d.ep)
+      {
+        if ((owner_if[d.ep] >= 0) && ((owner_if[d.ep] != num) || (owner_alt[d.ep] == alt))) return false;
+        owner_if[d.ep] = num;
+        owner_alt[d.ep] = alt;
+      }
+    }
+    return true;
+  }
+
+  static_assert(UniqueEndpoints(DESCRIPTOR_LIST<CFG_DESCR, DSCS...>::GetDescriptors()), "Duplicate Endpoints!");
   static_assert(DESCRIPTOR_LIST<DSCS...>::GetInterfaces().transform(
                   [](auto eps)
                   { 
-                    return TypeBox<typename type_unbox<decltype(eps)>::bInterfaceNumber>{}; 
+                    using T = type_unbox<decltype(eps)>;
+                    return TypeBox<TypeList<typename T::bInterfaceNumber, typename T::bAlternateSetting>>{};
                   }).is_unique(), "Duplicate Interfaces!");  
 public:
+  using HEADER = CFG_DESCR;
   
   static constexpr auto GetDescriptorList() { return DESCRIPTOR_LIST<CFG_DESCR, DSCS...>{}; }
+  static constexpr uint8_t GetConfigurationValue() { return TbConfigurationValue{}.value(); }
   
   constexpr DEVICE_CONFIGURATION_DESCRIPTOR()
   {
@@ -283,6 +323,9 @@ struct INTERFACE_DESCRIPTOR : public DESCRIPTOR<DescriptorType::INTERFACE,
   static_assert(is_iInterface<TiInterface>(),                "Not iInterface record");
   
   using bInterfaceNumber = TbInterfaceNumber;
+  using bAlternateSetting = TbAlternateSetting;
+  static constexpr uint8_t GetInterfaceNumber() { return bInterfaceNumber{}.value(); }
+  static constexpr uint8_t GetAlternateSetting() { return bAlternateSetting{}.value(); }
 };
 
 //==============================================================================
@@ -306,7 +349,7 @@ class INTERFACE : public DESCRIPTOR_LIST<
   
   using IF_DESCR = INTERFACE_DESCRIPTOR<TbInterfaceNumber,
                                         TbAlternateSetting,
-                                        bNumEndpoints<DESCRIPTOR_LIST<DSCS...>::EndpointsCount()>,
+                                        bNumEndpoints<INTERFACE::EndpointsCount()>,
                                         TbInterfaceClass,
                                         TbInterfaceSubClass,
                                         TbInterfaceProtocol,
@@ -349,7 +392,122 @@ struct ENDPOINT_DESCRIPTOR : public DESCRIPTOR<DescriptorType::ENDPOINT,
   static_assert(is_bInterval<TbInterval>(), "Not bInterfaceNumber record");
   
   using bEndpointAddress = TbEndpointAddress;  
+  using bmAttributes = TbmAttributes;
+  using wMaxPacketSize = TwMaxPacketSize;
+  using bInterval = TbInterval;
   static constexpr auto GetEpAddress() { return bEndpointAddress::GetEpAddress(); }
+  static constexpr auto GetEpType() { return epTYPE(bmAttributes{}.buf[0] & 3); }
+  static constexpr bool IsIn() { return GetEpAddress() & (uint8_t)epDIR::IN; }
+  static constexpr uint8_t GetAttributes() { return bmAttributes{}.buf[0]; }
+  static constexpr uint16_t GetMaxPacketSize() { return wMaxPacketSize{}.value(); }
+  static constexpr uint8_t GetInterval() { return bInterval{}.value(); }
+};
+
+//==============================================================================
+// SuperSpeed Endpoint Companion Descriptor Type (следует за Endpoint Descriptor)
+//==============================================================================
+template<typename TbMaxBurst,
+         typename TbMaxStreams,
+         typename TwBytesPerInterval>
+struct SS_ENDPOINT_COMPANION_DESCRIPTOR : public DESCRIPTOR<DescriptorType::SS_ENDPOINT_COMPANION,
+  TbMaxBurst, TbMaxStreams, TwBytesPerInterval>, SS_ENDPOINT_COMPANION_DESCRIPTOR_BASE
+{
+  static_assert(is_bMaxBurst<TbMaxBurst>(), "Not bMaxBurst record");
+  static_assert(is_bMaxStreams<TbMaxStreams>(), "Not bMaxStreams record");
+  static_assert(is_wBytesPerInterval<TwBytesPerInterval>(), "Not wBytesPerInterval record");
+  static_assert(TbMaxBurst{}.value() <= 15, "bMaxBurst: 0...15");
+  static_assert(TbMaxStreams{}.value() <= 16, "MaxStreams: 0...16 (2^n streams)");
+};
+
+//==============================================================================
+// Interface Alternates: альтернативные настройки одного интерфейса (alt 0, 1, ...)
+// Для SET_INTERFACE заранее вычислены разности наборов точек from -> to:
+// обработчик выключает точки disable, затем включает enable, не разбирая дескрипторы.
+// Точка с измененными параметрами попадает в оба списка
+//==============================================================================
+struct EP_PARAMS
+{
+  uint8_t address;
+  uint8_t attributes;   // bmAttributes: тип, синхронизация, использование
+  uint16_t size;        // wMaxPacketSize
+  uint8_t interval;
+};
+
+template<typename... ALTS>
+class INTERFACE_ALTERNATES : public DESCRIPTOR_LIST<ALTS...>
+{
+  using LIST = DESCRIPTOR_LIST<ALTS...>;
+  static constexpr uint8_t alts = LIST::GetInterfaces().size();
+  static constexpr uint8_t eps = LIST::EndpointsCount() ? LIST::EndpointsCount() : 1;
+public:
+  struct SETTING { uint8_t count; EP_PARAMS ep[eps]; };
+  struct DELTA { uint8_t disable_count; uint8_t enable_count; uint8_t disable[eps]; EP_PARAMS enable[eps]; };
+private:
+  struct ITEM { bool is_if; uint8_t num; uint8_t alt; EP_PARAMS ep; };
+  struct TABLE { bool ok; uint8_t num; SETTING setting[alts]; DELTA delta[alts][alts]; };
+
+  template<typename T>
+  static constexpr ITEM Item()
+  {
+    if constexpr (is_InterfaceDescriptor<T>()) return { true, T::GetInterfaceNumber(), T::GetAlternateSetting(), {} };
+    else if constexpr (is_EndpointDescriptor<T>())
+      return { false, 0, 0, { T::GetEpAddress(), T::GetAttributes(), T::GetMaxPacketSize(), T::GetInterval() } };
+    else return { false, 0, 0, {} };
+  }
+
+  static constexpr bool Contains(const SETTING& s, const EP_PARAMS& ep)
+  {
+    for (uint8_t i = 0; i < s.count; ++i)
+      if ((s.ep[i].address == ep.address) && (s.ep[i].attributes == ep.attributes) &&
+          (s.ep[i].size == ep.size) && (s.ep[i].interval == ep.interval)) return true;
+    return false;
+  }
+
+  template<typename... ITEMS>
+  static constexpr TABLE Build(TypeList<ITEMS...>)
+  {
+    constexpr ITEM dsc[] { Item<ITEMS>()... };
+    TABLE t{};
+    int16_t alt = -1;
+    for (auto& d : dsc)
+    {
+      if (d.is_if)
+      {
+        if (alt < 0) t.num = d.num;
+        if ((d.num != t.num) || (d.alt != alt + 1)) return t;  // ok = false
+        alt = d.alt;
+      }
+      else if (d.ep.address)
+      {
+        if (alt < 0) return t;
+        SETTING& s = t.setting[alt];
+        s.ep[s.count++] = d.ep;
+      }
+    }
+    for (uint8_t from = 0; from < alts; ++from)
+      for (uint8_t to = 0; to < alts; ++to)
+      {
+        DELTA& d = t.delta[from][to];
+        const SETTING& a = t.setting[from];
+        const SETTING& b = t.setting[to];
+        for (uint8_t i = 0; i < a.count; ++i)
+          if (!Contains(b, a.ep[i])) d.disable[d.disable_count++] = a.ep[i].address;
+        for (uint8_t i = 0; i < b.count; ++i)
+          if (!Contains(a, b.ep[i])) d.enable[d.enable_count++] = b.ep[i];
+      }
+    t.ok = true;
+    return t;
+  }
+
+  static constexpr TABLE table = Build(LIST::GetDescriptors());
+  static_assert(table.ok, "Alternate settings must share bInterfaceNumber and follow 0, 1, 2...");
+public:
+  static constexpr uint8_t InterfaceNumber() { return table.num; }
+  static constexpr uint8_t AltSettingsCount() { return alts; }
+  // Точки альтернативной настройки alt
+  static constexpr const SETTING& Setting(uint8_t alt) { return table.setting[alt]; }
+  // Переход SET_INTERFACE from -> to
+  static constexpr const DELTA& Delta(uint8_t from, uint8_t to) { return table.delta[from][to]; }
 };
 
 //==============================================================================
@@ -466,6 +624,41 @@ struct CDC_CALL_MANAGEMENT_FUNCTIONAL_DESCRIPTOR : public DESCRIPTOR<DescriptorT
   static_assert(is_bDataInterface<TbDataInterface>(), "Not bDataInterface record");
 };
 
+//==============================================================================
+// CDC Ethernet Networking Functional Descriptor Type
+//==============================================================================
+template<typename TbDescriptorSubType,
+         typename TiMACAddress,
+         typename TbmEthernetStatistics,
+         typename TwMaxSegmentSize,
+         typename TwNumberMCFilters,
+         typename TbNumberPowerFilters>
+struct CDC_ETHERNET_NETWORKING_FUNCTIONAL_DESCRIPTOR : public DESCRIPTOR<DescriptorType::CS_INTERFACE,
+  TbDescriptorSubType, TiMACAddress, TbmEthernetStatistics, TwMaxSegmentSize,
+  TwNumberMCFilters, TbNumberPowerFilters>, CDC_ETHERNET_NETWORKING_FUNCTIONAL_DESCRIPTOR_BASE
+{
+  static_assert(is_bDescriptorSubType<TbDescriptorSubType>(), "Not bDescriptorSubType record");
+  static_assert(is_iMACAddress<TiMACAddress>(), "Not iMACAddress record");
+  static_assert(is_bmEthernetStatistics<TbmEthernetStatistics>(), "Not bmEthernetStatistics record");
+  static_assert(is_wMaxSegmentSize<TwMaxSegmentSize>(), "Not wMaxSegmentSize record");
+  static_assert(is_wNumberMCFilters<TwNumberMCFilters>(), "Not wNumberMCFilters record");
+  static_assert(is_bNumberPowerFilters<TbNumberPowerFilters>(), "Not bNumberPowerFilters record");
+};
+
+//==============================================================================
+// CDC NCM Functional Descriptor Type
+//==============================================================================
+template<typename TbDescriptorSubType,
+         typename TbcdNcmVersion,
+         typename TbmNetworkCapabilities>
+struct CDC_NCM_FUNCTIONAL_DESCRIPTOR : public DESCRIPTOR<DescriptorType::CS_INTERFACE,
+  TbDescriptorSubType, TbcdNcmVersion, TbmNetworkCapabilities>, CDC_NCM_FUNCTIONAL_DESCRIPTOR_BASE
+{
+  static_assert(is_bDescriptorSubType<TbDescriptorSubType>(), "Not bDescriptorSubType record");
+  static_assert(is_bcdNcmVersion<TbcdNcmVersion>(), "Not bcdNcmVersion record");
+  static_assert(is_bmNetworkCapabilities<TbmNetworkCapabilities>(), "Not bmNetworkCapabilities record");
+};
+
 //==============================================================================
 // Custom HID Descriptor Type
 //==============================================================================
@@ -495,3 +688,18 @@ struct IRQBox
   static_assert(ep_num < 16, "Wrong ep_num");
 };
 
+//==============================================================================
+// ID сущностей класса (Audio/Video): по порядку в списке, начиная с 1
+//==============================================================================
+template<typename... ENTITIES>
+struct ENTITY_IDS
+{
+  template<typename TAG> static constexpr uint8_t Get()
+  {
+    constexpr bool match[] { std::is_same_v<TAG, typename ENTITIES::tag>... };
+    uint8_t id = 0;
+    for (uint8_t i = 0; i < sizeof...(ENTITIES); ++i) if (match[i]) id = i + 1;
+    return id;
+  }
+  template<typename TAG> static constexpr bool Contains() { return Get<TAG>() != 0; }
+};
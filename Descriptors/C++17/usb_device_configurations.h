@@ -0,0 +1,201 @@
+#pragma once
+
+//==============================================================================
+// Device Configurations: несколько конфигураций устройства
+// Задает bNumConfigurations, отдает GET_DESCRIPTOR(CONFIGURATION, index) и для
+// каждой конфигурации хранит программу SET_CONFIGURATION: точки всех alt с
+// буферами в памяти пакетов, точки alt 0 помечены для включения. Драйвер
+// применяет программу циклом, не разбирая дескрипторы
+//==============================================================================
+struct EP_INIT
+{
+  uint8_t address;
+  uint8_t attributes;   // bmAttributes
+  uint16_t size;        // наибольший wMaxPacketSize по всем alt
+  uint16_t buffer;      // смещение буфера в памяти пакетов
+  bool enable;          // точка есть в alt 0
+};
+
+struct EP_INIT_PROGRAM
+{
+  uint8_t count;
+  const EP_INIT* ep;
+};
+
+struct CONFIGURATION_BLOB
+{
+  const uint8_t* data;
+  uint16_t size;
+};
+
+//==============================================================================
+// Gather List: конфигурация как заголовок и список фрагментов во flash
+// EP0 передает ее пакетами через границы фрагментов, не собирая в RAM
+// (Device/usb_ep0_stream.hpp)
+//==============================================================================
+struct GATHER_LIST
+{
+  const CONFIGURATION_BLOB* fragments;
+  uint8_t count;
+  uint16_t size;        // wTotalLength
+};
+
+// Байты типа T - один экземпляр на всю программу
+template<typename T> inline constexpr T shared_fragment{};
+
+template<typename... Ts>
+inline constexpr CONFIGURATION_BLOB fragment_table[] { { shared_fragment<Ts>.buf, sizeof(Ts::buf) }... };
+
+//==============================================================================
+// Gathered Configuration Descriptor: параметры как у DEVICE_CONFIGURATION_DESCRIPTOR
+// Своих байтов у конфигурации только 9 - заголовок, каждый элемент DSCS (функции
+// FUNCTION_ALLOCATION - по отдельности) хранится общим фрагментом: одна и та же
+// функция в нескольких конфигурациях и личностях занимает flash один раз
+//==============================================================================
+template<typename TbConfigurationValue,
+         typename TiConfiguration,
+         typename TbmAttributes,
+         typename TbMaxPower,
+         typename... DSCS>
+class GATHERED_CONFIGURATION_DESCRIPTOR : public DEVICE_CONFIGURATION_BASE, GATHERED_CONFIGURATION_BASE
+{
+  // Проверки и заголовок - от непрерывной конфигурации, ее байты не создаются
+  using CONFIG = DEVICE_CONFIGURATION_DESCRIPTOR<TbConfigurationValue, TiConfiguration, TbmAttributes, TbMaxPower, DSCS...>;
+
+  template<typename T>
+  static constexpr auto Split()
+  {
+    if constexpr (is_FunctionAllocation<T>()) return typename T::functions{};
+    else return TypeList<T>{};
+  }
+
+  template<typename... Ts>
+  static constexpr GATHER_LIST List(TypeList<Ts...>)
+  {
+    return { fragment_table<Ts...>, sizeof...(Ts), sizeof(CONFIG::buf) };
+  }
+
+  static constexpr GATHER_LIST list = List((TypeList<typename CONFIG::HEADER>{} + ... + Split<DSCS>()));
+public:
+  static constexpr auto GetDescriptorList() { return CONFIG::GetDescriptorList(); }
+  static constexpr uint8_t GetConfigurationValue() { return CONFIG::GetConfigurationValue(); }
+  static constexpr GATHER_LIST Gather() { return list; }
+};
+
+template<const auto& cfg>
+inline constexpr CONFIGURATION_BLOB whole_configuration[] { { cfg.buf, sizeof(cfg.buf) } };
+
+// Список для объекта конфигурации профиля, непрерывная - один фрагмент
+template<const auto& cfg>
+constexpr GATHER_LIST GatherList()
+{
+  using T = std::remove_cv_t<std::remove_reference_t<decltype(cfg)>>;
+  if constexpr (is_GatheredConfiguration<T>()) return T::Gather();
+  else return { whole_configuration<cfg>, 1, sizeof(cfg.buf) };
+}
+
+template<uint16_t buffer_base,     // начало свободной памяти пакетов (после буферов EP0)
+         uint16_t buffer_end,      // конец памяти пакетов
+         typename... CONFIGS>
+class DEVICE_CONFIGURATIONS
+{
+  static_assert(sizeof...(CONFIGS) > 0, "No configurations");
+  static_assert((is_DeviceConfiguration<CONFIGS>() && ...), "Not DEVICE_CONFIGURATION_DESCRIPTOR");
+
+  template<typename TConfig>
+  class PROGRAM
+  {
+    using LIST = decltype(TConfig::GetDescriptorList());
+    static constexpr uint8_t eps = LIST::EndpointsCount() ? LIST::EndpointsCount() : 1;
+
+    struct ITEM { bool is_if; uint8_t alt; EP_INIT ep; };
+    struct TABLE { uint8_t count; EP_INIT ep[eps]; uint16_t end; };
+
+    template<typename T>
+    static constexpr ITEM Item()
+    {
+      if constexpr (is_InterfaceDescriptor<T>()) return { true, T::GetAlternateSetting(), {} };
+      else if constexpr (is_EndpointDescriptor<T>())
+        return { false, 0, { T::GetEpAddress(), T::GetAttributes(), T::GetMaxPacketSize(), 0, false } };
+      else return { false, 0, {} };
+    }
+
+    template<typename... ITEMS>
+    static constexpr TABLE Build(TypeList<ITEMS...>)
+    {
+      constexpr ITEM dsc[] { Item<ITEMS>()... };
+      TABLE t{};
+      uint8_t alt = 0;
+      for (auto& d : dsc)
+      {
+        if (d.is_if) { alt = d.alt; continue; }
+        if (!d.ep.address) continue;
+        uint8_t i = 0;
+        while ((i < t.count) && (t.ep[i].address != d.ep.address)) ++i;
+        if (i == t.count) t.ep[t.count++] = d.ep;
+        if (t.ep[i].size < d.ep.size) t.ep[i].size = d.ep.size;
+        if (alt == 0) { t.ep[i].enable = true; t.ep[i].attributes = d.ep.attributes; }
+      }
+      // Буфер на точку, выравнивание 4 байта
+      uint16_t buffer = buffer_base;
+      for (uint8_t i = 0; i < t.count; ++i)
+      {
+        t.ep[i].buffer = buffer;
+        buffer += (t.ep[i].size + 3) & ~3;
+      }
+      t.end = buffer;
+      return t;
+    }
+  public:
+    static constexpr TABLE table = Build(LIST::GetDescriptors());
+    static_assert(table.end <= buffer_end, "Endpoint buffers exceed packet memory");
+  };
+
+  static constexpr bool ValuesInOrder()
+  {
+    constexpr uint8_t values[] { CONFIGS::GetConfigurationValue()... };
+    for (uint8_t i = 0; i < sizeof...(CONFIGS); ++i)
+      if (values[i] != i + 1) return false;
+    return true;
+  }
+  static_assert(ValuesInOrder(), "bConfigurationValue must be 1, 2, ... in order");
+
+  template<typename T>
+  static constexpr GATHER_LIST List()
+  {
+    if constexpr (is_GatheredConfiguration<T>()) return T::Gather();
+    else return { fragment_table<T>, 1, sizeof(T::buf) };
+  }
+
+  static constexpr GATHER_LIST lists[] { List<CONFIGS>()... };
+  static constexpr EP_INIT_PROGRAM programs[] { { PROGRAM<CONFIGS>::table.count, PROGRAM<CONFIGS>::table.ep }... };
+public:
+  using NUM_CONFIGURATIONS = bNumConfigurations<sizeof...(CONFIGS)>;
+
+  static constexpr uint8_t Count() { return sizeof...(CONFIGS); }
+
+  // GET_DESCRIPTOR(CONFIGURATION, index)
+  static constexpr GATHER_LIST Descriptor(uint8_t index)
+  {
+    return (index < Count()) ? lists[index] : GATHER_LIST{ nullptr, 0, 0 };
+  }
+
+  // SET_CONFIGURATION(value): 0 - ненастроенное состояние, точек нет
+  static constexpr EP_INIT_PROGRAM Program(uint8_t value)
+  {
+    return (value && (value <= Count())) ? programs[value - 1] : EP_INIT_PROGRAM{ 0, nullptr };
+  }
+};
+
+//==============================================================================
+// Personality: полный набор дескрипторов одного профиля устройства.
+// Таблица личностей позволяет выбрать профиль при старте или перед повторным
+// подключением к шине индексом, строки общего пользования хранятся один раз
+//==============================================================================
+struct USB_PERSONALITY
+{
+  const uint8_t* device;                       // Device Descriptor
+  const GATHER_LIST* configurations;           // bNumConfigurations элементов
+  const uint8_t* const* strings;               // bIndex, затем String Descriptor
+  uint8_t strings_count;
+};
@@ -0,0 +1,142 @@
+#pragma once
+
+//==============================================================================
+// Автоматическое назначение номеров интерфейсов и точек составного устройства
+// Функция объявляет число интерфейсов в interfaces, точки - абстрактно
+// в endpoints = TypeList<EP_REQUEST...>, а дескрипторы - шаблоном
+// descriptors<first_if, ENDPOINT_DESCRIPTOR...>: first_if - номер ее первого
+// интерфейса, точки в порядке endpoints. Ссылки на интерфейсы в классовых
+// дескрипторах (CDC Union, Call Management) задаются относительно first_if
+//==============================================================================
+template<epTYPE type, epDIR dir, uint16_t size, uint8_t interval = 0>
+struct EP_REQUEST : public EP_REQUEST_BASE
+{
+  static constexpr epTYPE Type() { return type; }
+  static constexpr epDIR Dir() { return dir; }
+  static constexpr uint16_t Size() { return size; }
+  static constexpr uint8_t Interval() { return interval; }
+};
+
+template<typename T> constexpr bool is_EpRequest() { return std::is_base_of_v<EP_REQUEST_BASE, T>; }
+
+template<typename T> constexpr bool is_FunctionAllocation() { return std::is_base_of_v<FUNCTION_ALLOCATION_BASE, T>; }
+
+template<uint8_t hw_endpoints,    // двунаправленных точек контроллера, включая EP0 (STM32 FS - 8)
+         typename... FUNCS>
+class FUNCTION_ALLOCATOR
+{
+  static_assert((hw_endpoints > 1) && (hw_endpoints <= 16), "Wrong hardware endpoints count");
+
+  static constexpr uint8_t count = (FUNCS::endpoints::size() + ... + 0);
+
+  struct REQ { uint8_t func; epTYPE type; epDIR dir; uint16_t size; uint8_t interval; uint8_t number; };
+  struct TABLE { REQ r[count ? count : 1]; uint8_t base[sizeof...(FUNCS) + 1]; uint8_t first_if[sizeof...(FUNCS)]; uint8_t used; };
+
+  template<typename... EPS>
+  static constexpr void Fill(TypeList<EPS...>, TABLE& t, uint8_t f, uint8_t& n)
+  {
+    static_assert((is_EpRequest<EPS>() && ...), "Only EP_REQUEST in endpoints");
+    ((t.r[n++] = REQ{ f, EPS::Type(), EPS::Dir(), EPS::Size(), EPS::Interval(), 0 }), ...);
+  }
+
+  template<size_t... Fs>
+  static constexpr TABLE Allocate(std::index_sequence<Fs...>)
+  {
+    TABLE t{};
+    uint8_t n = 0, if_num = 0;
+    // Интерфейсы нумеруются по порядку функций
+    ((t.first_if[Fs] = if_num, if_num += FUNCS::interfaces), ...);
+    ((t.base[Fs] = n, Fill(typename FUNCS::endpoints{}, t, Fs, n)), ...);
+    t.base[sizeof...(FUNCS)] = n;
+
+    uint8_t next = 1;
+    // OUT и IN одного типа в одной функции - на общий номер
+    for (uint8_t i = 0; i < count; ++i)
+    {
+      if (t.r[i].dir != epDIR::OUT) continue;
+      for (uint8_t j = 0; j < count; ++j)
+        if ((t.r[j].dir == epDIR::IN) && !t.r[j].number && (t.r[j].func == t.r[i].func) && (t.r[j].type == t.r[i].type))
+        {
+          t.r[i].number = t.r[j].number = next++;
+          break;
+        }
+    }
+    // Оставшиеся OUT и IN одного типа (в том числе разных функций) - тоже на
+    // общий номер, остальные - каждая на свой: тип точки задается на номер
+    // (STM32 FS EPnR.EP_TYPE)
+    for (uint8_t i = 0; i < count; ++i)
+    {
+      if ((t.r[i].dir != epDIR::OUT) || t.r[i].number) continue;
+      for (uint8_t j = 0; j < count; ++j)
+        if ((t.r[j].dir == epDIR::IN) && !t.r[j].number && (t.r[j].type == t.r[i].type))
+        {
+          t.r[i].number = t.r[j].number = next++;
+          break;
+        }
+    }
+    for (uint8_t i = 0; i < count; ++i)
+      if (!t.r[i].number) t.r[i].number = next++;
+    t.used = next - 1;
+    return t;
+  }
+
+  static constexpr TABLE table = Allocate(std::make_index_sequence<sizeof...(FUNCS)>());
+
+  static constexpr REQ Req(uint8_t f, uint8_t j) { return table.r[table.base[f] + j]; }
+
+  template<typename F, size_t f, size_t... Js>
+  static constexpr auto Resolve(std::index_sequence<Js...>)
+  {
+    using T = typename F::template descriptors<table.first_if[f], ENDPOINT_DESCRIPTOR
+      < bEndpointAddress<Req(f, Js).number, Req(f, Js).dir>,
+        bmAttributes<Req(f, Js).type>,
+        wMaxPacketSize<Req(f, Js).size>,
+        bInterval<Req(f, Js).interval> >...>;
+    static_assert(T::InterfacesCount() == F::interfaces, "Function interfaces count mismatch");
+    return TypeBox<T>{};
+  }
+
+  template<size_t... Fs>
+  static constexpr auto Build(std::index_sequence<Fs...>)
+  {
+    return TypeList<type_unbox<decltype(Resolve<FUNCS, Fs>(std::make_index_sequence<FUNCS::endpoints::size()>()))>...>{};
+  }
+
+  template<typename... Ts>
+  static constexpr auto List(TypeList<Ts...>) { return TypeBox<DESCRIPTOR_LIST<Ts...>>{}; }
+
+  template<size_t f, typename T, typename... Ts>
+  static constexpr auto At(TypeList<T, Ts...>)
+  {
+    if constexpr (f == 0) return TypeBox<T>{};
+    else return At<f - 1>(TypeList<Ts...>{});
+  }
+public:
+  // Дескрипторы функций с назначенными номерами, по порядку FUNCS
+  using functions = decltype(Build(std::make_index_sequence<sizeof...(FUNCS)>()));
+  using type = type_unbox<decltype(List(functions{}))>;
+  // Дескрипторы f-й функции - их можно повторить в другой конфигурации
+  template<uint8_t f> using function = type_unbox<decltype(At<f>(functions{}))>;
+
+  // Занято номеров точек (без EP0)
+  static constexpr uint8_t NumbersUsed() { return table.used; }
+  // Номер первого интерфейса f-й функции
+  static constexpr uint8_t FirstInterface(uint8_t f) { return table.first_if[f]; }
+  // Адрес j-й точки f-й функции для настройки контроллера
+  static constexpr uint8_t EpAddress(uint8_t f, uint8_t j) { return uint8_t(Req(f, j).dir) | Req(f, j).number; }
+
+  static_assert(NumbersUsed() < hw_endpoints, "Not enough hardware endpoints");
+};
+
+template<uint8_t hw_endpoints, typename... FUNCS>
+class FUNCTION_ALLOCATION : public FUNCTION_ALLOCATOR<hw_endpoints, FUNCS...>::type, FUNCTION_ALLOCATION_BASE
+{
+  using ALLOCATOR = FUNCTION_ALLOCATOR<hw_endpoints, FUNCS...>;
+public:
+  using functions = typename ALLOCATOR::functions;
+  template<uint8_t f> using function = typename ALLOCATOR::template function<f>;
+
+  static constexpr uint8_t NumbersUsed() { return ALLOCATOR::NumbersUsed(); }
+  static constexpr uint8_t FirstInterface(uint8_t f) { return ALLOCATOR::FirstInterface(f); }
+  static constexpr uint8_t EpAddress(uint8_t f, uint8_t j) { return ALLOCATOR::EpAddress(f, j); }
+};
@@ -0,0 +1,141 @@
+#pragma once
+
+//==============================================================================
+// Mass Storage Class: alt 0 - Bulk-Only Transport, alt 1 (только при uas) -
+// USB Attached SCSI (MSC BOT 1.0, UAS 1.0 spec. Chapter 5.3)
+//==============================================================================
+enum class UAS_PIPE : uint8_t { Command = 1, Status = 2, DataIn = 3, DataOut = 4 };
+
+template<typename TbInterfaceNumber,
+         USB_SPEED speed,
+         bool uas,              // alt 1 - UAS
+         typename TDataInEp,    // BOT Bulk-In  / UAS Data-In
+         typename TDataOutEp,   // BOT Bulk-Out / UAS Data-Out
+         typename TStatusEp,    // UAS Status
+         typename TCommandEp,   // UAS Command
+         uint8_t max_streams = 5,          // SuperSpeed: 2^n потоков на Status/Data pipe
+         uint8_t max_burst = 15>           // SuperSpeed: пакетов в пачке
+class MSC_INTERFACE_BUILDER
+{
+public:
+  static constexpr uint16_t MaxPacketSize()
+  {
+    return (speed == USB_SPEED::FULL) ? 64 : ((speed == USB_SPEED::HIGH) ? 512 : 1024);
+  }
+private:
+
+  template<typename TEp>
+  using BULK_EP = ENDPOINT_DESCRIPTOR
+  < TEp,
+    bmAttributes<epTYPE::Bulk>,
+    wMaxPacketSize<MaxPacketSize()>,
+    bInterval<0> >;
+
+  // SuperSpeed: за каждой точкой следует Companion с числом потоков
+  template<typename TEp, uint8_t streams>
+  static constexpr auto Pipe()
+  {
+    if constexpr (speed == USB_SPEED::SUPER)
+      return TypeBox<DESCRIPTOR_LIST<BULK_EP<TEp>,
+        SS_ENDPOINT_COMPANION_DESCRIPTOR<bMaxBurst<max_burst>, bMaxStreams<streams>, wBytesPerInterval<0>>>>{};
+    else
+      return TypeBox<DESCRIPTOR_LIST<BULK_EP<TEp>>>{};
+  }
+
+  template<typename TEp>
+  using BOT_PIPE = type_unbox<decltype(Pipe<TEp, 0>())>;
+
+  template<typename TEp, UAS_PIPE id, uint8_t streams>
+  using UAS_PIPE_DSC = DESCRIPTOR_LIST<type_unbox<decltype(Pipe<TEp, streams>())>,
+    DESCRIPTOR<DescriptorType::CS_INTERFACE,  // Pipe Usage Descriptor
+      bPipeID<(uint8_t)id>,
+      bReserved<0>>>;
+
+  using BOT_ALT = INTERFACE<TbInterfaceNumber, bAlternateSetting<0>,
+    bInterfaceClass<8>,        // MSC Class
+    bInterfaceSubClass<6>,     // SCSI transparent
+    bInterfaceProtocol<0x50>,  // BULK-ONLY transport
+    iInterface<0>,
+    BOT_PIPE<TDataInEp>,
+    BOT_PIPE<TDataOutEp>>;
+
+  using UAS_ALT = INTERFACE<TbInterfaceNumber, bAlternateSetting<1>,
+    bInterfaceClass<8>,        // MSC Class
+    bInterfaceSubClass<6>,     // SCSI transparent
+    bInterfaceProtocol<0x62>,  // UAS
+    iInterface<0>,
+    UAS_PIPE_DSC<TCommandEp, UAS_PIPE::Command, 0>,
+    UAS_PIPE_DSC<TStatusEp, UAS_PIPE::Status, max_streams>,
+    UAS_PIPE_DSC<TDataInEp, UAS_PIPE::DataIn, max_streams>,
+    UAS_PIPE_DSC<TDataOutEp, UAS_PIPE::DataOut, max_streams>>;
+
+  static constexpr auto Alternates()
+  {
+    if constexpr (uas)
+      return TypeBox<INTERFACE_ALTERNATES<BOT_ALT, UAS_ALT>>{};
+    else
+      return TypeBox<INTERFACE_ALTERNATES<BOT_ALT>>{};
+  }
+public:
+  using type = type_unbox<decltype(Alternates())>;
+};
+
+template<typename TbInterfaceNumber,
+         USB_SPEED speed,
+         bool uas,
+         typename TDataInEp,
+         typename TDataOutEp,
+         typename TStatusEp,
+         typename TCommandEp,
+         uint8_t max_streams,
+         uint8_t max_burst>
+class MSC_INTERFACE_BASE : public MSC_INTERFACE_BUILDER<TbInterfaceNumber, speed, uas,
+  TDataInEp, TDataOutEp, TStatusEp, TCommandEp, max_streams, max_burst>::type
+{
+  static_assert(is_bInterfaceNumber<TbInterfaceNumber>(), "Not bInterfaceNumber record");
+  static_assert(is_bEndpointAddress<TDataInEp>() && is_bEndpointAddress<TDataOutEp>(), "Not bEndpointAddress record");
+  static_assert(TDataInEp::GetEpAddress() & (uint8_t)epDIR::IN, "Data-In pipe must be IN");
+  static_assert(!(TDataOutEp::GetEpAddress() & (uint8_t)epDIR::IN), "Data-Out pipe must be OUT");
+public:
+  // Точки и размер пакета для BOT/UAS движка
+  static constexpr uint8_t DataInEp() { return TDataInEp::GetEpAddress(); }
+  static constexpr uint8_t DataOutEp() { return TDataOutEp::GetEpAddress(); }
+  static constexpr uint16_t MaxPacketSize()
+  {
+    return MSC_INTERFACE_BUILDER<TbInterfaceNumber, speed, uas, TDataInEp, TDataOutEp, TStatusEp, TCommandEp,
+                                 max_streams, max_burst>::MaxPacketSize();
+  }
+};
+
+//==============================================================================
+// Только BOT: устройство с движком MSC::BOT
+//==============================================================================
+template<typename TbInterfaceNumber,
+         USB_SPEED speed,
+         typename TDataInEp,
+         typename TDataOutEp,
+         uint8_t max_burst = 15>
+class MSC_INTERFACE : public MSC_INTERFACE_BASE<TbInterfaceNumber, speed, false,
+  TDataInEp, TDataOutEp, TDataInEp, TDataOutEp, 0, max_burst> { };
+
+//==============================================================================
+// BOT + UAS: alt 1 объявлять, только если движок устройства понимает UAS
+//==============================================================================
+template<typename TbInterfaceNumber,
+         USB_SPEED speed,
+         typename TDataInEp,
+         typename TDataOutEp,
+         typename TStatusEp,
+         typename TCommandEp,
+         uint8_t max_streams = 5,
+         uint8_t max_burst = 15>
+class MSC_UAS_INTERFACE : public MSC_INTERFACE_BASE<TbInterfaceNumber, speed, true,
+  TDataInEp, TDataOutEp, TStatusEp, TCommandEp, max_streams, max_burst>
+{
+  static_assert(is_bEndpointAddress<TStatusEp>() && is_bEndpointAddress<TCommandEp>(), "Not bEndpointAddress record");
+  static_assert(TStatusEp::GetEpAddress() & (uint8_t)epDIR::IN, "Status pipe must be IN");
+  static_assert(!(TCommandEp::GetEpAddress() & (uint8_t)epDIR::IN), "Command pipe must be OUT");
+public:
+  static constexpr uint8_t StatusEp() { return TStatusEp::GetEpAddress(); }
+  static constexpr uint8_t CommandEp() { return TCommandEp::GetEpAddress(); }
+};
@@ -64,7 +64,7 @@ public:
 
   static consteval auto accumulate(auto func) { return (TypeList<>{} + ... + func(TypeBox<Ts>{})); }
  
-  static inline void foreach(auto func) { (func(TypeBox<Ts> {}), ...); }
+  static inline void foreach([[maybe_unused]] auto func) { (func(TypeBox<Ts> {}), ...); }
 
   template<auto I, typename T>
   static consteval auto generate()
@@ -75,10 +75,20 @@ public:
     } (std::make_index_sequence<I>());
   }
 
+  // Список из I типов, i-й тип задает func(ValueBox<i>{})
+  template<auto I>
+  static consteval auto generate(auto func)
+  {
+    return[]<auto... Is>(std::index_sequence<Is...>, auto f)
+    {
+      return TypeList < TypeUnBox < f(ValueBox<Is>{}) > ... > {};
+    } (std::make_index_sequence<I>(), func);
+  }
+
   static consteval auto transform(auto func) { return TypeList<TypeUnBox<func(TypeBox<Ts>{})>...>{}; }
 
   template<typename T>
-  static consteval auto filter(auto pred)
+  static consteval auto filter([[maybe_unused]] auto pred)
   {
     return (TypeList<>{}+ ... +std::conditional_t<pred(TypeBox<T>{}, TypeBox<Ts>{}),TypeList<Ts>,TypeList<>>{});
   }
@@ -86,7 +96,7 @@ public:
   template<typename T>
   static consteval auto filter(TypeBox<T> box, auto pred) { return filter<T>(pred); }
 	
-  static consteval auto filter(auto pred)
+  static consteval auto filter([[maybe_unused]] auto pred)
   {
     return (TypeList<>{} + ... + std::conditional_t<pred(TypeBox<Ts>{}), TypeList<Ts>, TypeList<>>{});
   }
@@ -0,0 +1,168 @@
+#pragma once
+
+//==============================================================================
+// Periodic Bandwidth (USB 2.0 spec. Chapter 5.11.3)
+//==============================================================================
+enum class USB_SPEED : uint8_t { FULL, HIGH, SUPER };
+
+// Время шины на одну транзакцию, нс (формулы bit-time из спецификации)
+struct BUS_TIME
+{
+  // floor(3.167 + BitStuffTime(bc)), BitStuffTime = 7*8*bc/6
+  static constexpr uint32_t BitStuffBits(uint32_t bc) { return (3167u * 6u + 56000u * bc) / 6000u; }
+
+  static constexpr uint32_t FullSpeed(epTYPE type, bool in, uint32_t bc, uint32_t host_delay)
+  {
+    uint32_t base = (type != epTYPE::Isochronous) ? 9107'000u : (in ? 7268'000u : 6265'000u);
+    return (base + 83540u * BitStuffBits(bc) + 999u) / 1000u + host_delay;
+  }
+
+  static constexpr uint32_t HighSpeed(epTYPE type, uint32_t bc, uint32_t host_delay)
+  {
+    uint32_t base = (type != epTYPE::Isochronous) ? 55u * 8u * 2083u : 38u * 8u * 2083u;
+    return (base + 2083u * BitStuffBits(bc) + 999u) / 1000u + host_delay;
+  }
+};
+
+template<typename TConfiguration,
+         USB_SPEED speed,
+         uint32_t host_delay = (speed == USB_SPEED::FULL) ? 1000 : 5> // нс, зависит от хоста
+class PERIODIC_BANDWIDTH
+{
+  static_assert(speed != USB_SPEED::SUPER, "SuperSpeed periodic scheduling is not modelled");
+
+  template<is_EndpointDescriptor EP>
+  static constexpr bool IsPeriodic()
+  {
+    return (EP::GetEpType() == epTYPE::Interrupt) || (EP::GetEpType() == epTYPE::Isochronous);
+  }
+
+  template<is_EndpointDescriptor EP>
+  static consteval uint32_t EpTime()
+  {
+    if constexpr (!IsPeriodic<EP>()) return 0;
+    else
+    {
+      constexpr uint32_t size = EP::GetMaxPacketSize() & 0x7FF;
+      constexpr uint32_t mult = ((EP::GetMaxPacketSize() >> 11) & 3) + 1;
+      if constexpr (speed == USB_SPEED::FULL)
+      {
+        static_assert(size <= ((EP::GetEpType() == epTYPE::Isochronous) ? 1023 : 64),
+                      "Wrong wMaxPacketSize for Full Speed periodic endpoint");
+        return BUS_TIME::FullSpeed(EP::GetEpType(), EP::IsIn(), size, host_delay);
+      }
+      else
+      {
+        static_assert((size <= 1024) && (mult <= 3), "Wrong wMaxPacketSize for High Speed periodic endpoint");
+        return mult * BUS_TIME::HighSpeed(EP::GetEpType(), size, host_delay);
+      }
+    }
+  }
+
+  struct DSC_INFO { bool is_if; uint8_t num; uint32_t time; };
+
+  template<typename T>
+  static consteval DSC_INFO Info()
+  {
+    if constexpr (is_InterfaceDescriptor<T>) return { true, T::GetInterfaceNumber(), 0 };
+    else if constexpr (is_EndpointDescriptor<T>) return { false, 0, EpTime<T>() };
+    else return { false, 0, 0 };
+  }
+
+  // Для каждого интерфейса учитывается самая "тяжелая" альтернативная настройка
+  template<typename... DSCS>
+  static consteval uint32_t Sum(TypeList<DSCS...>)
+  {
+    constexpr DSC_INFO dsc[] { Info<DSCS>()... };
+    uint32_t if_max[256]{};
+    uint32_t alt = 0;
+    uint8_t num = 0;
+    for (auto& d : dsc)
+    {
+      if (d.is_if)
+      {
+        if_max[num] = std::max(if_max[num], alt);
+        num = d.num;
+        alt = 0;
+      }
+      else alt += d.time;
+    }
+    if_max[num] = std::max(if_max[num], alt);
+    uint32_t sum = 0;
+    for (auto t : if_max) sum += t;
+    return sum;
+  }
+
+  static constexpr uint32_t reserved = Sum(TConfiguration::GetDescriptorList().GetDescriptors());
+public:
+  // Длительность (микро)кадра, нс
+  static constexpr uint32_t FrameTime() { return (speed == USB_SPEED::FULL) ? 1'000'000 : 125'000; }
+  // Периодический бюджет: 90% кадра FS, 80% микрокадра HS
+  static constexpr uint32_t Budget() { return FrameTime() / 10 * ((speed == USB_SPEED::FULL) ? 9 : 8); }
+  // Худший случай: все периодические транзакции попали в один (микро)кадр
+  static constexpr uint32_t Reserved() { return reserved; }
+  static constexpr uint32_t Available() { return (reserved < Budget()) ? Budget() - reserved : 0; }
+  static constexpr uint32_t Utilization() { return reserved * 100 / FrameTime(); } // % кадра
+  static constexpr bool Fits() { return reserved <= Budget(); }
+
+  template<is_EndpointDescriptor EP>
+  static constexpr uint32_t EndpointTime() { return EpTime<EP>(); }
+};
+
+//==============================================================================
+// Polling Interval (USB 2.0 spec. Chapter 9.6.6, bInterval)
+//==============================================================================
+// FS Interrupt: bInterval кадров (1...255)
+// FS Isochronous, HS Interrupt/Isochronous: 2^(bInterval-1) (микро)кадров (1...16)
+template<epTYPE type, USB_SPEED speed>
+struct POLLING
+{
+  static_assert((type == epTYPE::Interrupt) || (type == epTYPE::Isochronous), "Only periodic endpoints");
+
+  static constexpr uint32_t FrameTime() { return (speed == USB_SPEED::FULL) ? 1000 : 125; } // мкс
+  static constexpr uint8_t MaxInterval() { return IsLinear() ? 255 : 16; }
+
+  // Период опроса, мкс
+  static constexpr uint32_t Period(uint8_t interval)
+  {
+    return IsLinear() ? interval * FrameTime() : (FrameTime() << (interval - 1));
+  }
+  // Худшая задержка: данные готовы сразу после опроса + положение транзакции в кадре
+  static constexpr uint32_t Latency(uint8_t interval) { return Period(interval) + FrameTime(); }
+
+  // Максимальный bInterval, при котором задержка не превышает us
+  template<uint32_t us>
+  static consteval uint8_t ForLatency()
+  {
+    static_assert(us >= 2 * FrameTime(), "Latency is less than the bus can provide");
+    uint8_t interval = 1;
+    while ((interval < MaxInterval()) && (Latency(interval + 1) <= us)) ++interval;
+    return interval;
+  }
+
+  // bInterval для частоты опроса не ниже hz
+  template<uint32_t hz>
+  static consteval uint8_t ForRate()
+  {
+    static_assert(hz * FrameTime() <= 1'000'000, "Rate is higher than the bus can provide");
+    uint8_t interval = 1;
+    while ((interval < MaxInterval()) && (Period(interval + 1) * hz <= 1'000'000)) ++interval;
+    return interval;
+  }
+private:
+  static constexpr bool IsLinear() { return (speed == USB_SPEED::FULL) && (type == epTYPE::Interrupt); }
+};
+
+template<is_EndpointDescriptor EP, USB_SPEED speed>
+class ENDPOINT_TIMING
+{
+  using POLL = POLLING<EP::GetEpType(), speed>;
+  static constexpr uint32_t size = EP::GetMaxPacketSize() & 0x7FF;
+  static constexpr uint32_t mult = (speed == USB_SPEED::HIGH) ? ((EP::GetMaxPacketSize() >> 11) & 3) + 1 : 1;
+  static_assert(EP::GetInterval() >= 1 && EP::GetInterval() <= POLL::MaxInterval(), "Wrong bInterval");
+public:
+  static constexpr uint32_t Period() { return POLL::Period(EP::GetInterval()); }   // мкс
+  static constexpr uint32_t Latency() { return POLL::Latency(EP::GetInterval()); } // мкс
+  static constexpr uint32_t Rate() { return 1'000'000 / Period(); }                // опросов/с
+  static constexpr uint32_t Throughput() { return size * mult * Rate(); }           // байт/с
+};
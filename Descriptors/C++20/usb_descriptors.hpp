@@ -9,10 +9,15 @@ enum class DescriptorType : uint8_t
   DEVICE=1, CONFIGURATION=2, STRING=3, INTERFACE=4, ENDPOINT=5,
   DEVICE_QUALIFIER=6, OTHER_SPEED_CONFIGURATION=7, INTERFACE_POWER=8,
   INTERFACE_ASSOCIATION=0xB,
+  SS_ENDPOINT_COMPANION=0x30,         // USB 3.2 spec. Chapter 9.6.7
   HID=0x21, REPORT=0x22, PHYSICAL=0x23, // HID v1.11 spec. Chapter 7.1
   CS_INTERFACE=0x24, CS_ENDPOINT=0x25   // Class Specified
 };
 
+// DFU Functional Descriptor (DFU 1.1 spec. Chapter 4.1.3) использует код HID,
+// в перечислении у каждого кода одно имя
+inline constexpr DescriptorType DFU_FUNCTIONAL_TYPE = DescriptorType::HID;
+
 enum class HID_Localization : uint8_t
 {
   Not_Localized=0, Arabic=1, Belgian=2, Canadian_Bilingual=3, Canadian_French=4,
@@ -65,8 +70,32 @@ enum class REC_TYPE
   bControlInterface, bSubordinateInterface0,
   // CDC_CALL_MANAGEMENT_FUNCTIONAL_DESCRIPTOR
   bDataInterface, 
+  // CDC_ETHERNET_NETWORKING_FUNCTIONAL_DESCRIPTOR
+  iMACAddress, bmEthernetStatistics, wMaxSegmentSize, wNumberMCFilters, bNumberPowerFilters,
+  // CDC_NCM_FUNCTIONAL_DESCRIPTOR
+  bcdNcmVersion, bmNetworkCapabilities,
+  // SS_ENDPOINT_COMPANION_DESCRIPTOR
+  bMaxBurst, bMaxStreams, wBytesPerInterval,
+  // UAS PIPE_USAGE_DESCRIPTOR
+  bPipeID,
+  // DFU_FUNCTIONAL_DESCRIPTOR
+  wDetachTimeOut, wTransferSize, bcdDFUVersion,
   // CUSTOM_HID_DESCRIPTOR_BASE
-  bcdHID, bCountryCode, bNumDescriptors, bDescriptorType_0, wDescriptorLength_0 
+  bcdHID, bCountryCode, bNumDescriptors, bDescriptorType_0, wDescriptorLength_0,
+  // AUDIO 2.0 CLASS-SPECIFIC DESCRIPTORS
+  bcdADC, bCategory, bmControls, bClockID, bAssocTerminal, iClockSource,
+  bTerminalID, wTerminalType, bCSourceID, bNrChannels, bmChannelConfig, iChannelNames, iTerminal,
+  bUnitID, bSourceID, bmaControls, iFeature,
+  bTerminalLink, bFormatType, bmFormats, bSubslotSize, bBitResolution, bLockDelayUnits, wLockDelay,
+  // VIDEO 1.1 CLASS-SPECIFIC DESCRIPTORS
+  bcdUVC, dwClockFrequency, bInCollection, baInterfaceNr,
+  wObjectiveFocalLengthMin, wObjectiveFocalLengthMax, wOcularFocalLength, bControlSize,
+  wMaxMultiplier, iProcessing, bmVideoStandards,
+  bNumFormats, bmInfo, bStillCaptureMethod, bTriggerSupport, bTriggerUsage,
+  bFormatIndex, bNumFrameDescriptors, guidFormat, bBitsPerPixel, bDefaultFrameIndex,
+  bAspectRatioX, bAspectRatioY, bmInterlaceFlags, bCopyProtect, bmFlags,
+  bFrameIndex, wWidth, wHeight, dwMinBitRate, dwMaxBitRate, dwMaxVideoFrameBufferSize,
+  dwDefaultFrameInterval, bFrameIntervalType, dwFrameInterval
 };
   
 // Базовые классы для дескрипторов
@@ -75,6 +104,8 @@ class DESCRIPTOR_LIST_BASE {};
 class INTERFACE_BASE {};
 class INTERFACE_ASSOCIATION_BASE {};
 class CONFIGURATION_DESCRIPTOR_BASE {};
+class DEVICE_CONFIGURATION_BASE {};
+class GATHERED_CONFIGURATION_BASE {};
 class INTERFACE_DESCRIPTOR_BASE {};
 class ENDPOINT_DESCRIPTOR_BASE {};
 class INTERFACE_ASSOCIATION_DESCRIPTOR_BASE {};
@@ -82,9 +113,15 @@ class CDC_HEADER_FUNCTIONAL_DESCRIPTOR_BASE {};
 class CDC_ACM_FUNCTIONAL_DESCRIPTOR_BASE {};
 class CDC_UNION_FUNCTIONAL_DESCRIPTOR_BASE {};
 class CDC_CALL_MANAGEMENT_FUNCTIONAL_DESCRIPTOR_BASE {};
+class CDC_ETHERNET_NETWORKING_FUNCTIONAL_DESCRIPTOR_BASE {};
+class CDC_NCM_FUNCTIONAL_DESCRIPTOR_BASE {};
+class SS_ENDPOINT_COMPANION_DESCRIPTOR_BASE {};
+class DFU_FUNCTIONAL_DESCRIPTOR_BASE {};
 class CUSTOM_HID_DESCRIPTOR_BASE {};
 class BMATTRIBUTES_BASE {};
 class ENDPOINT_ADDRES_BASE {};
+class EP_REQUEST_BASE {};
+class FUNCTION_ALLOCATION_BASE {};
 
 //==============================================================================
 // Определение полей дескрипторов
@@ -95,6 +132,9 @@ class ENDPOINT_ADDRES_BASE {};
 #define REC_U16(X) template<typename T> concept is_##X = value_unbox<T>() == REC_TYPE::X; \
                    template<uint16_t x> using X = HOLDER<REC_TYPE::X, uint8_t(x), uint8_t(x >> 8)>
 
+#define REC_U32(X) template<typename T> concept is_##X = value_unbox<T>() == REC_TYPE::X; \
+                   template<uint32_t x> using X = HOLDER<REC_TYPE::X, uint8_t(x), uint8_t(x >> 8), uint8_t(x >> 16), uint8_t(x >> 24)>
+
 #define REC_8(T,X) template<typename U> concept is_##X = value_unbox<U>() == REC_TYPE::X; \
                    template<T x> using X = HOLDER<REC_TYPE::X, (uint8_t)x>
 
@@ -107,6 +147,8 @@ struct HOLDER
     {
         if constexpr (sizeof...(data) == 1) return buf[0];
         else if constexpr (sizeof...(data) == 2) return (uint16_t)buf[0] + ((uint16_t)buf[1] << 8);
+        else if constexpr (sizeof...(data) == 4) return (uint32_t)buf[0] + ((uint32_t)buf[1] << 8) +
+                                                        ((uint32_t)buf[2] << 16) + ((uint32_t)buf[3] << 24);
         else return;
     }
     uint8_t buf[sizeof...(data)]{ data... };
@@ -139,6 +181,7 @@ enum class cfg_Attr : uint8_t { SelfPowered = 0xC0, RemoteWakeup = 0xA0 };
 enum class epTYPE : uint8_t { Control = 0, Isochronous = 1, Bulk = 2, Interrupt = 3 };
 enum class epSYNC : uint8_t { NoSynchronization = 0, Asynchronous = 4, Adaptive = 6, Synchronous = 7 };
 enum class epUSAGE : uint8_t { Data = 0, Feedback = 0x10, ImplicitFeedbackData = 0x20 };
+enum class dfu_Attr : uint8_t { CanDnload = 1, CanUpload = 2, ManifestationTolerant = 4, WillDetach = 8 };
 // Interface Descriptor records
 REC_U8(bInterfaceNumber);
 REC_U8(bAlternateSetting);
@@ -169,15 +212,103 @@ REC_U8(bControlInterface);
 REC_U8(bSubordinateInterface0);
 // CDC Call Management Functional Descriptor records
 REC_U8(bDataInterface);
+// CDC Ethernet Networking Functional Descriptor records
+REC_U8(iMACAddress);
+REC_U32(bmEthernetStatistics);
+REC_U16(wMaxSegmentSize);
+REC_U16(wNumberMCFilters);
+REC_U8(bNumberPowerFilters);
+// CDC NCM Functional Descriptor records
+REC_U16(bcdNcmVersion);
+REC_U8(bmNetworkCapabilities);
+// SuperSpeed Endpoint Companion Descriptor records
+REC_U8(bMaxBurst);
+REC_U8(bMaxStreams);   // bmAttributes bulk точки: MaxStreams (log2)
+REC_U16(wBytesPerInterval);
+// UAS Pipe Usage Descriptor records
+REC_U8(bPipeID);
+// DFU Functional Descriptor records
+REC_U16(wDetachTimeOut);
+REC_U16(wTransferSize);
+REC_U16(bcdDFUVersion);
 // CUSTOM_HID Descriptor records
 REC_U16(bcdHID);
 REC_8(HID_Localization, bCountryCode);
 REC_U8(bNumDescriptors);
 REC_8(DescriptorType, bDescriptorType_0);
 REC_U16(wDescriptorLength_0);
+// Audio 2.0 Class-Specific records
+REC_U16(bcdADC);
+REC_U8(bCategory);
+REC_U8(bmControls);
+REC_U8(bClockID);
+REC_U8(bAssocTerminal);
+REC_U8(iClockSource);
+REC_U8(bTerminalID);
+REC_U16(wTerminalType);
+REC_U8(bCSourceID);
+REC_U8(bNrChannels);
+REC_U32(bmChannelConfig);
+REC_U8(iChannelNames);
+REC_U8(iTerminal);
+REC_U8(bUnitID);
+REC_U8(bSourceID);
+REC_U32(bmaControls);
+REC_U8(iFeature);
+REC_U8(bTerminalLink);
+REC_U8(bFormatType);
+REC_U32(bmFormats);
+REC_U8(bSubslotSize);
+REC_U8(bBitResolution);
+REC_U8(bLockDelayUnits);
+REC_U16(wLockDelay);
+
+REC_U16(bcdUVC);
+REC_U32(dwClockFrequency);
+REC_U8(bInCollection);
+REC_U16(wObjectiveFocalLengthMin);
+REC_U16(wObjectiveFocalLengthMax);
+REC_U16(wOcularFocalLength);
+REC_U8(bControlSize);
+REC_U16(wMaxMultiplier);
+REC_U8(iProcessing);
+REC_U8(bmVideoStandards);
+REC_U8(bNumFormats);
+REC_U8(bmInfo);
+REC_U8(bStillCaptureMethod);
+REC_U8(bTriggerSupport);
+REC_U8(bTriggerUsage);
+REC_U8(bFormatIndex);
+REC_U8(bNumFrameDescriptors);
+REC_U8(bBitsPerPixel);
+REC_U8(bDefaultFrameIndex);
+REC_U8(bAspectRatioX);
+REC_U8(bAspectRatioY);
+REC_U8(bmInterlaceFlags);
+REC_U8(bCopyProtect);
+REC_U8(bmFlags);
+REC_U8(bFrameIndex);
+REC_U16(wWidth);
+REC_U16(wHeight);
+REC_U32(dwMinBitRate);
+REC_U32(dwMaxBitRate);
+REC_U32(dwMaxVideoFrameBufferSize);
+REC_U32(dwDefaultFrameInterval);
+REC_U8(bFrameIntervalType);
+REC_U32(dwFrameInterval);
 
 #include "usb_descriptors_types.hpp"
 #include "usb_hid_report_descriptors_types.hpp"
+#include "usb_bandwidth.hpp"
+#include "usb_function_allocator.hpp"
+#include "usb_device_configurations.hpp"
+#include "usb_uac2_descriptors_types.hpp"
+#include "usb_uvc_descriptors_types.hpp"
+#include "usb_cdc_net_descriptors_types.hpp"
+#include "usb_msc_descriptors_types.hpp"
+#include "usb_dfu_descriptors_types.hpp"
+#include "usb_vendor_bulk_descriptors_types.hpp"
+#include "usb_functionfs_descriptors_types.hpp"
 
 //==============================================================================
 // WINUSB Compatible ID Feature Descriptor Type
@@ -7,6 +7,8 @@ template<typename T> concept is_Descriptor = std::is_base_of_v<DESCRIPTOR_BASE,
 template<typename T> concept is_DescriptorList = std::is_base_of_v<DESCRIPTOR_LIST_BASE, T>;
 template<typename T> concept is_DescriptorListElement = is_Descriptor<T> || is_DescriptorList<T>;
 template<typename T> concept is_ConfigurationDescriptor = std::is_base_of_v<CONFIGURATION_DESCRIPTOR_BASE, T>;
+template<typename T> concept is_DeviceConfiguration = std::is_base_of_v<DEVICE_CONFIGURATION_BASE, T>;
+template<typename T> concept is_GatheredConfiguration = std::is_base_of_v<GATHERED_CONFIGURATION_BASE, T>;
 template<typename T> concept is_InterfaceDescriptor = std::is_base_of_v<INTERFACE_DESCRIPTOR_BASE, T>;
 template<typename T> concept is_EndpointDescriptor = std::is_base_of_v<ENDPOINT_DESCRIPTOR_BASE, T>;
 template<typename T> concept is_Interface_Association = std::is_base_of_v<INTERFACE_ASSOCIATION_DESCRIPTOR_BASE, T>;
@@ -16,6 +18,7 @@ template<typename T> concept Is_Interface = std::is_base_of_v<INTERFACE_BASE, T>
 template<typename T> concept is_bmAttributes = std::is_base_of_v<BMATTRIBUTES_BASE, T>;
 template<typename T> concept is_bmAttributes_EP = is_bmAttributes<T> && std::is_same_v<typename T::sub_type, epTYPE>;
 template<typename T> concept is_bmAttributes_CONFIG = is_bmAttributes<T> && std::is_same_v<typename T::sub_type, cfg_Attr>;
+template<typename T> concept is_bmAttributes_DFU = is_bmAttributes<T> && std::is_same_v<typename T::sub_type, dfu_Attr>;
 template<typename T> concept is_bEndpointAddress = std::is_base_of_v<ENDPOINT_ADDRES_BASE, T>;
 
 constexpr auto copy_buf(auto rcrd, uint8_t** p)
@@ -74,9 +77,9 @@ public:
   {
   	return GetEndpoints().size();
   }
-  static constexpr auto InterfacesCount()
+  static constexpr auto InterfacesCount() // Альтернативные настройки не считаются
   {
-      return GetInterfaces().size();
+      return GetInterfaces().filter([](auto x) { return TypeUnBox<x>::GetAlternateSetting() == 0; }).size();
   }
   uint8_t buf[(sizeof(DSCS::buf) + ...)]{};
 };
@@ -103,6 +106,8 @@ class DEVICE_DESCRIPTOR : public DESCRIPTOR< DescriptorType::DEVICE,
 {
   static constexpr auto ep0sz = TbMaxPacketSize0{}.value();
   static_assert((ep0sz == 8) || (ep0sz == 16) || (ep0sz == 32) || (ep0sz == 64), "Wrong TbMaxPacketSize0 size");
+public:
+  static constexpr uint8_t GetMaxPacketSize0() { return ep0sz; }
 };
 
 //==============================================================================
@@ -123,7 +128,8 @@ struct DEVICE_QUALIFIER_DESCRIPTOR : public DESCRIPTOR<DescriptorType::DEVICE_QU
 //==============================================================================
 template<auto... args> class bmAttributes : BMATTRIBUTES_BASE
 {
-    static_assert((sizeof...(args) > 0) && (sizeof...(args) < 4), "Wrong parameters");
+    static constexpr bool dfu = (std::is_same_v<decltype(args), dfu_Attr> && ...);
+    static_assert((sizeof...(args) > 0) && ((sizeof...(args) < 4) || dfu), "Wrong parameters");
 
     template<auto arg1> static constexpr auto Chek1Args()
     {
@@ -145,7 +151,8 @@ template<auto... args> class bmAttributes : BMATTRIBUTES_BASE
     }
     static constexpr auto CheckArgs()
     {
-        if constexpr (sizeof...(args) == 1) return Chek1Args<args...>();
+        if constexpr (dfu) return dfu_Attr{};   // DFU: любая комбинация атрибутов
+        else if constexpr (sizeof...(args) == 1) return Chek1Args<args...>();
         else if constexpr (sizeof...(args) == 2) return Chek2Args<args...>();
         else if constexpr (sizeof...(args) == 3) return Chek3Args<args...>();
         else return;
@@ -185,35 +192,59 @@ template<is_bConfigurationValue TbConfigurationValue,
          is_bmAttributes TbmAttributes,
          is_bMaxPower TbMaxPower,
          is_DescriptorListElement... DSCS>
-class DEVICE_CONFIGURATION_DESCRIPTOR
+class DEVICE_CONFIGURATION_DESCRIPTOR : public DEVICE_CONFIGURATION_BASE
 {
   static constexpr auto sz = (sizeof(DSCS::buf)+...+9);
 
-  static constexpr auto CalcInterfacesNum()
-  {
-    return DESCRIPTOR_LIST<DSCS...>::GetDescriptors().filter(
-           [](auto x) { return is_InterfaceDescriptor<TypeUnBox<x>>; }).size();
-  }
-
   using CFG_DESCR = CONFIGURATION_DESCRIPTOR<wTotalLength<sz>,
-                                             bNumInterfaces<CalcInterfacesNum()>,
+                                             bNumInterfaces<DESCRIPTOR_LIST<DSCS...>::InterfacesCount()>,
                                              TbConfigurationValue,
                                              TiConfiguration,
                                              TbmAttributes,
                                              TbMaxPower>;
 
-  static_assert(DESCRIPTOR_LIST<DSCS...>::GetEndpoints().transform(
-                  [](auto eps)
-                  {
-                    return TypeBox<typename TypeUnBox<eps>::bEndpointAddress>{};
-                  }).is_unique(), "Duplicate Endpoints!");
+  struct EP_OWNER { bool is_if; uint8_t num; uint8_t alt; uint8_t ep; };
+
+  template<typename T>
+  static consteval EP_OWNER Owner()
+  {
+    if constexpr (is_InterfaceDescriptor<T>) return { true, T::GetInterfaceNumber(), T::GetAlternateSetting(), 0 };
+    else if constexpr (is_EndpointDescriptor<T>) return { false, 0, 0, T::GetEpAddress() };
+    else return { false, 0, 0, 0 };
+  }
+
+  // Точка может повторяться только в разных альтернативных настройках одного интерфейса
+  template<typename... ITEMS>
+  static consteval bool UniqueEndpoints(TypeList<ITEMS...>)
+  {
+    constexpr EP_OWNER dsc[] { Owner<ITEMS>()... };
+    int16_t owner_if[256]{}, owner_alt[256]{};
+    for (auto& x : owner_if) x = -1;
+    uint8_t num = 0, alt = 0;
+    for (auto& d : dsc)
+    {
+      if (d.is_if) { num = d.num; alt = d.alt; }
+      else if (d.ep)
+      {
+        if ((owner_if[d.ep] >= 0) && ((owner_if[d.ep] != num) || (owner_alt[d.ep] == alt))) return false;
+        owner_if[d.ep] = num;
+        owner_alt[d.ep] = alt;
+      }
+    }
+    return true;
+  }
+
+  static_assert(UniqueEndpoints(DESCRIPTOR_LIST<CFG_DESCR, DSCS...>::GetDescriptors()), "Duplicate Endpoints!");
   static_assert(DESCRIPTOR_LIST<DSCS...>::GetInterfaces().transform(
                   [](auto eps)
                   { 
-                    return TypeBox<typename TypeUnBox<eps>::bInterfaceNumber>{}; 
+                    using T = TypeUnBox<eps>;
+                    return TypeBox<TypeList<typename T::bInterfaceNumber, typename T::bAlternateSetting>>{};
                   }).is_unique(), "Duplicate Interfaces!");  
 public:
+  using HEADER = CFG_DESCR;
   static constexpr auto GetDescriptorList() { return DESCRIPTOR_LIST<CFG_DESCR, DSCS...>{}; }
+  static constexpr uint8_t GetConfigurationValue() { return TbConfigurationValue{}.value(); }
 
   constexpr DEVICE_CONFIGURATION_DESCRIPTOR()
   {
@@ -239,6 +270,9 @@ struct INTERFACE_DESCRIPTOR : public DESCRIPTOR<DescriptorType::INTERFACE,
     TbInterfaceSubClass, TbInterfaceProtocol, TiInterface>, INTERFACE_DESCRIPTOR_BASE 
 { 
   using bInterfaceNumber = TbInterfaceNumber;
+  using bAlternateSetting = TbAlternateSetting;
+  static constexpr uint8_t GetInterfaceNumber() { return bInterfaceNumber{}.value(); }
+  static constexpr uint8_t GetAlternateSetting() { return bAlternateSetting{}.value(); }
 };
 
 //==============================================================================
@@ -263,7 +297,28 @@ struct ENDPOINT_DESCRIPTOR : public DESCRIPTOR<DescriptorType::ENDPOINT,
   TbEndpointAddress, TbmAttributes, TwMaxPacketSize, TbInterval>, ENDPOINT_DESCRIPTOR_BASE
 {
   using bEndpointAddress = TbEndpointAddress;
+  using bmAttributes = TbmAttributes;
+  using wMaxPacketSize = TwMaxPacketSize;
+  using bInterval = TbInterval;
   static constexpr auto GetEpAddress() { return bEndpointAddress::GetEpAddress(); }
+  static constexpr auto GetEpType() { return epTYPE(bmAttributes{}.buf[0] & 3); }
+  static constexpr bool IsIn() { return GetEpAddress() & (uint8_t)epDIR::IN; }
+  static constexpr uint8_t GetAttributes() { return bmAttributes{}.buf[0]; }
+  static constexpr uint16_t GetMaxPacketSize() { return wMaxPacketSize{}.value(); }
+  static constexpr uint8_t GetInterval() { return bInterval{}.value(); }
+};
+
+//==============================================================================
+// SuperSpeed Endpoint Companion Descriptor Type (следует за Endpoint Descriptor)
+//==============================================================================
+template<is_bMaxBurst TbMaxBurst,
+         is_bMaxStreams TbMaxStreams,
+         is_wBytesPerInterval TwBytesPerInterval>
+struct SS_ENDPOINT_COMPANION_DESCRIPTOR : public DESCRIPTOR<DescriptorType::SS_ENDPOINT_COMPANION,
+  TbMaxBurst, TbMaxStreams, TwBytesPerInterval>, SS_ENDPOINT_COMPANION_DESCRIPTOR_BASE
+{
+  static_assert(TbMaxBurst{}.value() <= 15, "bMaxBurst: 0...15");
+  static_assert(TbMaxStreams{}.value() <= 16, "MaxStreams: 0...16 (2^n streams)");
 };
 
 //==============================================================================
@@ -285,7 +340,7 @@ class INTERFACE : public DESCRIPTOR_LIST<
 
     using IF_DESCR = INTERFACE_DESCRIPTOR < TbInterfaceNumber,
         TbAlternateSetting,
-        bNumEndpoints < DESCRIPTOR_LIST<DSCS...>{}.EndpointsCount() > ,
+        bNumEndpoints < INTERFACE::EndpointsCount() > ,
         TbInterfaceClass,
         TbInterfaceSubClass,
         TbInterfaceProtocol,
@@ -300,6 +355,97 @@ public:
     uint8_t buf[sz]{};
 };
 
+//==============================================================================
+// Interface Alternates: альтернативные настройки одного интерфейса (alt 0, 1, ...)
+// Для SET_INTERFACE заранее вычислены разности наборов точек from -> to:
+// обработчик выключает точки disable, затем включает enable, не разбирая дескрипторы.
+// Точка с измененными параметрами попадает в оба списка
+//==============================================================================
+struct EP_PARAMS
+{
+  uint8_t address;
+  uint8_t attributes;   // bmAttributes: тип, синхронизация, использование
+  uint16_t size;        // wMaxPacketSize
+  uint8_t interval;
+};
+
+template<is_DescriptorListElement... ALTS>
+class INTERFACE_ALTERNATES : public DESCRIPTOR_LIST<ALTS...>
+{
+  using LIST = DESCRIPTOR_LIST<ALTS...>;
+  static constexpr uint8_t alts = LIST::GetInterfaces().size();
+  static constexpr uint8_t eps = LIST::EndpointsCount() ? LIST::EndpointsCount() : 1;
+public:
+  struct SETTING { uint8_t count; EP_PARAMS ep[eps]; };
+  struct DELTA { uint8_t disable_count; uint8_t enable_count; uint8_t disable[eps]; EP_PARAMS enable[eps]; };
+private:
+  struct ITEM { bool is_if; uint8_t num; uint8_t alt; EP_PARAMS ep; };
+  struct TABLE { bool ok; uint8_t num; SETTING setting[alts]; DELTA delta[alts][alts]; };
+
+  template<typename T>
+  static consteval ITEM Item()
+  {
+    if constexpr (is_InterfaceDescriptor<T>) return { true, T::GetInterfaceNumber(), T::GetAlternateSetting(), {} };
+    else if constexpr (is_EndpointDescriptor<T>)
+      return { false, 0, 0, { T::GetEpAddress(), T::GetAttributes(), T::GetMaxPacketSize(), T::GetInterval() } };
+    else return { false, 0, 0, {} };
+  }
+
+  static consteval bool Contains(const SETTING& s, const EP_PARAMS& ep)
+  {
+    for (uint8_t i = 0; i < s.count; ++i)
+      if ((s.ep[i].address == ep.address) && (s.ep[i].attributes == ep.attributes) &&
+          (s.ep[i].size == ep.size) && (s.ep[i].interval == ep.interval)) return true;
+    return false;
+  }
+
+  template<typename... ITEMS>
+  static consteval TABLE Build(TypeList<ITEMS...>)
+  {
+    constexpr ITEM dsc[] { Item<ITEMS>()... };
+    TABLE t{};
+    int16_t alt = -1;
+    for (auto& d : dsc)
+    {
+      if (d.is_if)
+      {
+        if (alt < 0) t.num = d.num;
+        if ((d.num != t.num) || (d.alt != alt + 1)) return t;  // ok = false
+        alt = d.alt;
+      }
+      else if (d.ep.address)
+      {
+        if (alt < 0) return t;
+        SETTING& s = t.setting[alt];
+        s.ep[s.count++] = d.ep;
+      }
+    }
+    for (uint8_t from = 0; from < alts; ++from)
+      for (uint8_t to = 0; to < alts; ++to)
+      {
+        DELTA& d = t.delta[from][to];
+        const SETTING& a = t.setting[from];
+        const SETTING& b = t.setting[to];
+        for (uint8_t i = 0; i < a.count; ++i)
+          if (!Contains(b, a.ep[i])) d.disable[d.disable_count++] = a.ep[i].address;
+        for (uint8_t i = 0; i < b.count; ++i)
+          if (!Contains(a, b.ep[i])) d.enable[d.enable_count++] = b.ep[i];
+      }
+    t.ok = true;
+    return t;
+  }
+
+  static constexpr TABLE table = Build(LIST::GetDescriptors());
+  static_assert(table.ok, "Alternate settings must share bInterfaceNumber and follow 0, 1, 2...");
+public:
+  static constexpr uint8_t InterfaceNumber() { return table.num; }
+  static constexpr uint8_t AltSettingsCount() { return alts; }
+  // Точки альтернативной настройки alt
+  static constexpr const SETTING& Setting(uint8_t alt) { return table.setting[alt]; }
+  // Переход SET_INTERFACE from -> to
+  static constexpr const DELTA& Delta(uint8_t from, uint8_t to) { return table.delta[from][to]; }
+};
+
 //==============================================================================
 // Interface Association Descriptor Type
 //==============================================================================
@@ -385,6 +531,28 @@ struct CDC_CALL_MANAGEMENT_FUNCTIONAL_DESCRIPTOR : public DESCRIPTOR<DescriptorT
   TbDescriptorSubType, TbmCapabilities,
   TbDataInterface>, CDC_CALL_MANAGEMENT_FUNCTIONAL_DESCRIPTOR_BASE {};
 
+//==============================================================================
+// CDC Ethernet Networking Functional Descriptor Type
+//==============================================================================
+template<is_bDescriptorSubType TbDescriptorSubType,
+         is_iMACAddress TiMACAddress,
+         is_bmEthernetStatistics TbmEthernetStatistics,
+         is_wMaxSegmentSize TwMaxSegmentSize,
+         is_wNumberMCFilters TwNumberMCFilters,
+         is_bNumberPowerFilters TbNumberPowerFilters>
+struct CDC_ETHERNET_NETWORKING_FUNCTIONAL_DESCRIPTOR : public DESCRIPTOR<DescriptorType::CS_INTERFACE,
+  TbDescriptorSubType, TiMACAddress, TbmEthernetStatistics, TwMaxSegmentSize,
+  TwNumberMCFilters, TbNumberPowerFilters>, CDC_ETHERNET_NETWORKING_FUNCTIONAL_DESCRIPTOR_BASE {};
+
+//==============================================================================
+// CDC NCM Functional Descriptor Type
+//==============================================================================
+template<is_bDescriptorSubType TbDescriptorSubType,
+         is_bcdNcmVersion TbcdNcmVersion,
+         is_bmNetworkCapabilities TbmNetworkCapabilities>
+struct CDC_NCM_FUNCTIONAL_DESCRIPTOR : public DESCRIPTOR<DescriptorType::CS_INTERFACE,
+  TbDescriptorSubType, TbcdNcmVersion, TbmNetworkCapabilities>, CDC_NCM_FUNCTIONAL_DESCRIPTOR_BASE {};
+
 //==============================================================================
 // CUSTOM HID Descriptor Type
 //==============================================================================
@@ -405,3 +573,19 @@ struct IRQBox
   static constexpr auto irq = ep_IRQ;
   static_assert(ep_num < 16, "Wrong ep_num");
 };
+
+//==============================================================================
+// ID сущностей класса (Audio/Video): по порядку в списке, начиная с 1
+//==============================================================================
+template<typename... ENTITIES>
+struct ENTITY_IDS
+{
+  template<typename TAG> static constexpr uint8_t Get()
+  {
+    constexpr bool match[] { std::is_same_v<TAG, typename ENTITIES::tag>... };
+    uint8_t id = 0;
+    for (uint8_t i = 0; i < sizeof...(ENTITIES); ++i) if (match[i]) id = i + 1;
+    return id;
+  }
+  template<typename TAG> static constexpr bool Contains() { return Get<TAG>() != 0; }
+};
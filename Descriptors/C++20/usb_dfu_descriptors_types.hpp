@@ -0,0 +1,88 @@
+#pragma once
+
+//==============================================================================
+// DFU Functional Descriptor Type (DFU 1.1 spec. Chapter 4.1.3, DfuSe: bcdDFUVersion 0x011A)
+//==============================================================================
+template<is_bmAttributes_DFU TbmAttributes,   // bitCanDnload, bitCanUpload, ...
+         is_wDetachTimeOut TwDetachTimeOut,    // мс ожидания USB Reset после DFU_DETACH
+         is_wTransferSize TwTransferSize,      // байт за один DFU_DNLOAD/DFU_UPLOAD
+         is_bcdDFUVersion TbcdDFUVersion>
+struct DFU_FUNCTIONAL_DESCRIPTOR : public DESCRIPTOR<DFU_FUNCTIONAL_TYPE,
+  TbmAttributes, TwDetachTimeOut, TwTransferSize, TbcdDFUVersion>, DFU_FUNCTIONAL_DESCRIPTOR_BASE { };
+
+template<typename T> concept is_DfuFunctional = std::is_base_of_v<DFU_FUNCTIONAL_DESCRIPTOR_BASE, T>;
+
+//==============================================================================
+// wTransferSize: целое число страниц flash, помещающееся в RAM буфер загрузчика.
+// Каждый DNLOAD - отдельный запрос со статусом и опросом GETSTATUS, поэтому
+// время обновления определяется числом блоков, а не размером пакета EP0
+//==============================================================================
+template<uint32_t page_size,      // размер страницы (сектора) flash
+         uint32_t ram_size,       // RAM, отведенная под буфер DNLOAD
+         uint8_t max_packet0>     // bMaxPacketSize0 устройства
+class DFU_TRANSFER_SIZE
+{
+  static constexpr uint32_t Calc()
+  {
+    constexpr uint32_t limit = (ram_size < 0xFFFF) ? ram_size : 0xFFFF;
+    // Страница больше буфера: пишем ее частями, кратными пакету EP0
+    return (limit >= page_size) ? (limit / page_size * page_size) : (limit / max_packet0 * max_packet0);
+  }
+public:
+  static constexpr uint16_t Value = Calc();
+  using type = wTransferSize<Value>;
+
+  // Число запросов DFU_DNLOAD для образа
+  static constexpr uint32_t Transfers(uint32_t image_size) { return (image_size + Value - 1) / Value; }
+
+  static_assert(Value >= max_packet0, "Not enough RAM for DFU transfer");
+  static_assert(Value % max_packet0 == 0, "wTransferSize must be a multiple of bMaxPacketSize0");
+};
+
+//==============================================================================
+// DFU Runtime Interface: функция в составе рабочей конфигурации (DFU 1.1 Chapter 4.1)
+//==============================================================================
+template<is_bInterfaceNumber TbInterfaceNumber,
+         is_iInterface TiInterface,
+         is_DfuFunctional TFunctional>
+class DFU_RUNTIME_INTERFACE : public INTERFACE<TbInterfaceNumber, bAlternateSetting<0>,
+  bInterfaceClass<0xFE>,     // Application Specific
+  bInterfaceSubClass<0x01>,  // Device Firmware Upgrade
+  bInterfaceProtocol<0x01>,  // Runtime protocol
+  TiInterface,
+  TFunctional> { };
+
+//==============================================================================
+// DFU Mode Interface: по альтернативной настройке на область памяти (DfuSe),
+// строка области - "@Name/0xAddress/NN*SSSa,...", функциональный дескриптор после последней
+//==============================================================================
+template<is_bInterfaceNumber TbInterfaceNumber,
+         is_DfuFunctional TFunctional,
+         is_iInterface... TRegions>
+class DFU_MODE_INTERFACE_BUILDER
+{
+  static_assert(sizeof...(TRegions) > 0, "DFU mode interface requires at least one memory region");
+
+  template<auto... Is>
+  static consteval auto BindRegions(std::index_sequence<Is...>)
+  {
+    return TypeBox<DESCRIPTOR_LIST<
+      INTERFACE<TbInterfaceNumber, bAlternateSetting<Is>,
+        bInterfaceClass<0xFE>,     // Application Specific
+        bInterfaceSubClass<0x01>,  // Device Firmware Upgrade
+        bInterfaceProtocol<0x02>,  // DFU mode protocol
+        TRegions>...,
+      TFunctional>>{};
+  }
+public:
+  using type = TypeUnBox<BindRegions(std::make_index_sequence<sizeof...(TRegions)>())>;
+};
+
+template<is_bInterfaceNumber TbInterfaceNumber,
+         is_DfuFunctional TFunctional,
+         is_iInterface... TRegions>
+class DFU_MODE_INTERFACE : public DFU_MODE_INTERFACE_BUILDER<TbInterfaceNumber, TFunctional, TRegions...>::type
+{
+public:
+  static constexpr uint8_t RegionsCount() { return sizeof...(TRegions); }
+};
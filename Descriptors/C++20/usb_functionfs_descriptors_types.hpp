@@ -0,0 +1,122 @@
+#pragma once
+
+//==============================================================================
+// Linux FunctionFS: те же функции на гаджете Linux
+// Дескрипторы и строки пишутся в ep0 смонтированной functionfs
+// (include/uapi/linux/usb/functionfs.h). Конфигурацию, номера интерфейсов
+// и адреса точек ядро назначает само, в блоки идут только деревья функций
+//==============================================================================
+enum class ffs_Flags : uint32_t
+{
+  HasFsDesc=0x01, HasHsDesc=0x02, HasSsDesc=0x04, HasMsOsDesc=0x08,
+  VirtualAddr=0x10, EventFd=0x20, AllCtrlRecip=0x40, Config0Setup=0x80
+};
+
+constexpr uint32_t FFS_DESCRIPTORS_MAGIC_V2 = 3;
+constexpr uint32_t FFS_STRINGS_MAGIC = 2;
+
+constexpr void put_le32(uint8_t** p, uint32_t x)
+{
+  for (uint8_t i = 0; i < 4; ++i) *(*p)++ = uint8_t(x >> (8 * i));
+}
+
+//==============================================================================
+// usb_functionfs_descs_head_v2: magic, length, flags, счетчики дескрипторов
+// FS/HS/SS, затем блоки дескрипторов. Блок скорости - INTERFACE или
+// INTERFACE_ASSOCIATION (или их список), void - скорость не поддерживается.
+// Для SS за каждой точкой должен идти SS_ENDPOINT_COMPANION_DESCRIPTOR
+//==============================================================================
+template<typename TFullSpeed, typename THighSpeed = void, typename TSuperSpeed = void>
+class FUNCTIONFS_DESCRIPTORS
+{
+  template<typename T>
+  struct BLOCK
+  {
+    static_assert(is_DescriptorListElement<T>, "Only DESCRIPTOR or DESCRIPTOR_LIST");
+    using LIST = DESCRIPTOR_LIST<T>;
+    static constexpr bool present = true;
+    static constexpr uint32_t count = LIST::GetDescriptors().size();
+    static constexpr uint32_t size = sizeof(T::buf);
+    static constexpr uint8_t eps = LIST::EndpointsCount();
+    static constexpr uint8_t ifs = LIST::InterfacesCount();
+  };
+
+  template<typename T> requires std::is_void_v<T>
+  struct BLOCK<T>
+  {
+    static constexpr bool present = false;
+    static constexpr uint32_t count = 0, size = 0;
+  };
+
+  using FS = BLOCK<TFullSpeed>;
+  using HS = BLOCK<THighSpeed>;
+  using SS = BLOCK<TSuperSpeed>;
+
+  static_assert(FS::present || HS::present || SS::present, "No descriptors");
+
+  // Ядро требует одинаковые интерфейсы и точки на всех скоростях
+  template<typename A, typename B>
+  static consteval bool Same()
+  {
+    if constexpr (A::present && B::present) return (A::eps == B::eps) && (A::ifs == B::ifs);
+    else return true;
+  }
+  static_assert(Same<FS, HS>() && Same<FS, SS>() && Same<HS, SS>(), "Speeds differ in interfaces or endpoints");
+
+  static constexpr uint32_t flags = (FS::present ? uint32_t(ffs_Flags::HasFsDesc) : 0) |
+                                    (HS::present ? uint32_t(ffs_Flags::HasHsDesc) : 0) |
+                                    (SS::present ? uint32_t(ffs_Flags::HasSsDesc) : 0);
+  static constexpr uint32_t sz = 12 + 4 * (FS::present + HS::present + SS::present) + FS::size + HS::size + SS::size;
+
+  template<typename T>
+  static constexpr void Copy(uint8_t** p)
+  {
+    if constexpr (!std::is_void_v<T>) copy_buf(T{}, p);
+  }
+public:
+  static constexpr uint32_t GetFlags() { return flags; }
+
+  constexpr FUNCTIONFS_DESCRIPTORS()
+  {
+    uint8_t* p = buf;
+    put_le32(&p, FFS_DESCRIPTORS_MAGIC_V2);
+    put_le32(&p, sz);
+    put_le32(&p, flags);
+    if (FS::present) put_le32(&p, FS::count);
+    if (HS::present) put_le32(&p, HS::count);
+    if (SS::present) put_le32(&p, SS::count);
+    Copy<TFullSpeed>(&p);
+    Copy<THighSpeed>(&p);
+    Copy<TSuperSpeed>(&p);
+  }
+  uint8_t buf[sz]{};
+};
+
+//==============================================================================
+// usb_functionfs_strings_head: magic, length, str_count, lang_count, затем
+// код языка и строки UTF-8 с завершающим нулем. Строка i - индекс i+1
+// в iInterface/iFunction дескрипторов функции
+//==============================================================================
+template<size_t... Ns>
+class FUNCTIONFS_STRINGS
+{
+  static constexpr uint32_t count = sizeof...(Ns);
+  static constexpr uint32_t sz = 16 + (count ? 2 : 0) + (Ns + ... + 0);
+public:
+  constexpr FUNCTIONFS_STRINGS(uint16_t lang, const char (&... str)[Ns])
+  {
+    uint8_t* p = buf;
+    put_le32(&p, FFS_STRINGS_MAGIC);
+    put_le32(&p, sz);
+    put_le32(&p, count);
+    put_le32(&p, count ? 1 : 0);    // lang_count: без строк язык не пишется
+    if (count)
+    {
+      *p++ = uint8_t(lang);
+      *p++ = uint8_t(lang >> 8);
+    }
+    auto put = [&p](auto& s) { for (auto c : s) *p++ = uint8_t(c); };
+    (put(str), ...);
+  }
+  uint8_t buf[sz]{};
+};
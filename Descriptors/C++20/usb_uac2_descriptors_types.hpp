@@ -0,0 +1,240 @@
+#pragma once
+
+//==============================================================================
+// USB Audio Class 2.0 (Audio Device Class Definition 2.0, Appendix A)
+//==============================================================================
+enum class UAC2_CATEGORY : uint8_t
+{
+  DESKTOP_SPEAKER=0x01, HOME_THEATER=0x02, MICROPHONE=0x03, HEADSET=0x04,
+  TELEPHONE=0x05, CONVERTER=0x06, VOICE_SOUND_RECORDER=0x07, IO_BOX=0x08,
+  MUSICAL_INSTRUMENT=0x09, PRO_AUDIO=0x0A, AUDIO_VIDEO=0x0B, CONTROL_PANEL=0x0C,
+  OTHER=0xFF
+};
+
+enum class UAC2_TERMINAL : uint16_t
+{
+  USB_STREAMING=0x0101,                                                    // USB Terminal Types
+  MICROPHONE=0x0201, DESKTOP_MICROPHONE=0x0202, HEADSET_MICROPHONE=0x0204, // Input Terminal Types
+  SPEAKER=0x0301, HEADPHONES=0x0302, DESKTOP_SPEAKER=0x0304,               // Output Terminal Types
+  LINE_CONNECTOR=0x0603, SPDIF_INTERFACE=0x0605                            // External Terminal Types
+};
+
+enum class UAC2_CLOCK : uint8_t
+{
+  External=0, InternalFixed=1, InternalVariable=2, InternalProgrammable=3, SynchronizedToSOF=4
+};
+
+// bmControls: 1 - только чтение, 3 - чтение/запись
+enum class UAC2_CONTROL : uint32_t
+{
+  None=0,
+  ClockFrequency=0x03, ClockValidity=0x04,                        // Clock Source
+  Mute=0x03, Volume=0x0C, Bass=0x30, Treble=0x300, AGC=0x3000     // Feature Unit
+};
+
+constexpr UAC2_CONTROL operator | (UAC2_CONTROL a, UAC2_CONTROL b) { return UAC2_CONTROL((uint32_t)a | (uint32_t)b); }
+
+class UAC2_ENTITY_BASE {};
+template<typename T> concept is_UAC2_Entity = std::is_base_of_v<UAC2_ENTITY_BASE, T>;
+
+//==============================================================================
+// Формат потока: размеры пакетов из частоты дискретизации и формата
+//==============================================================================
+template<USB_SPEED speed,
+         uint32_t sample_rate,   // Гц
+         uint8_t channels,
+         uint8_t subslot_size,   // байт на отсчет (1...4)
+         uint8_t bit_resolution,
+         uint8_t interval = 1>   // bInterval изохронной точки данных
+struct UAC2_FORMAT
+{
+  static_assert(speed != USB_SPEED::SUPER, "SuperSpeed requires endpoint companion descriptors");
+  static_assert((subslot_size >= 1) && (subslot_size <= 4), "Wrong subslot size");
+  static_assert(bit_resolution <= subslot_size * 8, "Bit resolution exceeds subslot");
+  static_assert((interval >= 1) && (interval <= 4), "Wrong bInterval");
+
+  static constexpr auto Speed() { return speed; }
+  static constexpr uint32_t SampleRate() { return sample_rate; }
+  static constexpr uint8_t Channels() { return channels; }
+  static constexpr uint8_t SubslotSize() { return subslot_size; }
+  static constexpr uint8_t BitResolution() { return bit_resolution; }
+  static constexpr uint8_t Interval() { return interval; }
+  static constexpr uint32_t ChannelConfig() { return (channels < 27) ? (1ul << channels) - 1 : 0; }
+
+  static constexpr uint32_t PacketsPerSecond() { return 1'000'000 / POLLING<epTYPE::Isochronous, speed>::Period(interval); }
+  static constexpr uint32_t FrameSize() { return (uint32_t)channels * subslot_size; }
+  // Асинхронный режим: до одного дополнительного отсчета на пакет
+  static constexpr uint16_t MaxPacketSize()
+  {
+    return ((sample_rate + PacketsPerSecond() - 1) / PacketsPerSecond() + 1) * FrameSize();
+  }
+  // Feedback: 10.14 (FS, 3 байта) или 16.16 (HS, 4 байта) отсчетов на (микро)кадр
+  static constexpr uint8_t FeedbackSize() { return (speed == USB_SPEED::FULL) ? 3 : 4; }
+  static constexpr uint8_t FeedbackInterval() { return (speed == USB_SPEED::FULL) ? 1 : 4; }
+  static constexpr uint32_t NominalFeedback()
+  {
+    constexpr uint32_t fps = (speed == USB_SPEED::FULL) ? 1000 : 8000;
+    return (uint32_t)(((uint64_t)sample_rate << ((speed == USB_SPEED::FULL) ? 14 : 16)) / fps);
+  }
+
+  static_assert(MaxPacketSize() <= ((speed == USB_SPEED::FULL) ? 1023 : 1024), "Stream does not fit one packet");
+};
+
+//==============================================================================
+// Audio Control Entities (ID назначаются по порядку в UAC2_AC_INTERFACE)
+//==============================================================================
+template<typename TTag,
+         UAC2_CLOCK attributes,
+         UAC2_CONTROL controls = UAC2_CONTROL::ClockFrequency | UAC2_CONTROL::ClockValidity,
+         uint8_t iClock = 0>
+struct UAC2_CLOCK_SOURCE : UAC2_ENTITY_BASE
+{
+  using tag = TTag;
+  template<typename IDS> using descriptor = DESCRIPTOR<DescriptorType::CS_INTERFACE,
+    bDescriptorSubType<0x0A>, bClockID<IDS::template Get<TTag>()>,
+    HOLDER<REC_TYPE::bmAttributes, (uint8_t)attributes>, bmControls<(uint8_t)controls>,
+    bAssocTerminal<0>, iClockSource<iClock>>;
+  template<typename IDS> static constexpr bool IsLinked() { return true; }
+};
+
+template<typename TTag,
+         UAC2_TERMINAL type,
+         typename TClock,
+         uint8_t channels,
+         uint8_t iTerm = 0>
+struct UAC2_INPUT_TERMINAL : UAC2_ENTITY_BASE
+{
+  using tag = TTag;
+  template<typename IDS> using descriptor = DESCRIPTOR<DescriptorType::CS_INTERFACE,
+    bDescriptorSubType<0x02>, bTerminalID<IDS::template Get<TTag>()>,
+    wTerminalType<(uint16_t)type>, bAssocTerminal<0>, bCSourceID<IDS::template Get<TClock>()>,
+    bNrChannels<channels>, bmChannelConfig<(channels < 27) ? (1ul << channels) - 1 : 0>,
+    iChannelNames<0>, HOLDER<REC_TYPE::bmControls, 0, 0>, iTerminal<iTerm>>;
+  template<typename IDS> static constexpr bool IsLinked() { return IDS::template Contains<TClock>(); }
+};
+
+template<typename TTag,
+         UAC2_TERMINAL type,
+         typename TSource,
+         typename TClock,
+         uint8_t iTerm = 0>
+struct UAC2_OUTPUT_TERMINAL : UAC2_ENTITY_BASE
+{
+  using tag = TTag;
+  template<typename IDS> using descriptor = DESCRIPTOR<DescriptorType::CS_INTERFACE,
+    bDescriptorSubType<0x03>, bTerminalID<IDS::template Get<TTag>()>,
+    wTerminalType<(uint16_t)type>, bAssocTerminal<0>, bSourceID<IDS::template Get<TSource>()>,
+    bCSourceID<IDS::template Get<TClock>()>, HOLDER<REC_TYPE::bmControls, 0, 0>, iTerminal<iTerm>>;
+  template<typename IDS> static constexpr bool IsLinked()
+  {
+    return IDS::template Contains<TSource>() && IDS::template Contains<TClock>();
+  }
+};
+
+template<typename TTag,
+         typename TSource,
+         uint8_t channels,
+         UAC2_CONTROL master = UAC2_CONTROL::Mute | UAC2_CONTROL::Volume,
+         UAC2_CONTROL channel = UAC2_CONTROL::None,
+         uint8_t iFeat = 0>
+class UAC2_FEATURE_UNIT : UAC2_ENTITY_BASE
+{
+  template<typename IDS, auto... Is>
+  static consteval auto Bind(std::index_sequence<Is...>)
+  {
+    return TypeBox<DESCRIPTOR<DescriptorType::CS_INTERFACE,
+      bDescriptorSubType<0x06>, bUnitID<IDS::template Get<TTag>()>,
+      bSourceID<IDS::template Get<TSource>()>,
+      bmaControls<(uint32_t)((Is == 0) ? master : channel)>..., iFeature<iFeat>>>{};
+  }
+public:
+  using tag = TTag;
+  template<typename IDS> using descriptor = TypeUnBox<Bind<IDS>(std::make_index_sequence<channels + 1>())>;
+  template<typename IDS> static constexpr bool IsLinked() { return IDS::template Contains<TSource>(); }
+};
+
+//==============================================================================
+// Audio Control Interface
+//==============================================================================
+template<is_bInterfaceNumber TbInterfaceNumber,
+         is_iInterface TiInterface,
+         UAC2_CATEGORY category,
+         is_UAC2_Entity... ENTITIES>
+class UAC2_AC_INTERFACE : public INTERFACE<TbInterfaceNumber, bAlternateSetting<0>,
+  bInterfaceClass<1>,        // Audio
+  bInterfaceSubClass<1>,     // Audio Control
+  bInterfaceProtocol<0x20>,  // IP_VERSION_02_00
+  TiInterface,
+  DESCRIPTOR<DescriptorType::CS_INTERFACE,
+    bDescriptorSubType<0x01>,  // Header
+    bcdADC<0x02'00>, bCategory<(uint8_t)category>,
+    wTotalLength<(sizeof(ENTITIES::template descriptor<ENTITY_IDS<ENTITIES...>>::buf) + ... + 9)>,
+    bmControls<0>>,
+  typename ENTITIES::template descriptor<ENTITY_IDS<ENTITIES...>>...>
+{
+  using IDS = ENTITY_IDS<ENTITIES...>;
+  static_assert(TypeList<typename ENTITIES::tag...>::is_unique(), "Duplicate Audio Entities!");
+  static_assert((ENTITIES::template IsLinked<IDS>() && ...), "Unknown Audio Entity reference");
+public:
+  template<typename TAG> static constexpr uint8_t EntityID()
+  {
+    static_assert(IDS::template Contains<TAG>(), "Unknown Audio Entity");
+    return IDS::template Get<TAG>();
+  }
+};
+
+//==============================================================================
+// Audio Streaming Interface: alt 0 - нулевая полоса, alt 1 - поток
+//==============================================================================
+template<typename TAC,                     // UAC2_AC_INTERFACE
+         typename TTerminalLink,           // USB Streaming терминал
+         is_bInterfaceNumber TbInterfaceNumber,
+         typename TFormat,                 // UAC2_FORMAT
+         is_bEndpointAddress TDataEp,
+         is_bEndpointAddress... TFeedbackEp> // Явная обратная связь (для OUT потока)
+class UAC2_AS_INTERFACE : public INTERFACE_ALTERNATES<
+  INTERFACE<TbInterfaceNumber, bAlternateSetting<0>, bInterfaceClass<1>,
+    bInterfaceSubClass<2>, bInterfaceProtocol<0x20>, iInterface<0>>,
+  INTERFACE<TbInterfaceNumber, bAlternateSetting<1>, bInterfaceClass<1>,
+    bInterfaceSubClass<2>, bInterfaceProtocol<0x20>, iInterface<0>,
+
+    DESCRIPTOR<DescriptorType::CS_INTERFACE,
+      bDescriptorSubType<0x01>,  // AS General
+      bTerminalLink<TAC::template EntityID<TTerminalLink>()>,
+      bmControls<0>,
+      bFormatType<1>,            // FORMAT_TYPE_I
+      bmFormats<1>,              // PCM
+      bNrChannels<TFormat::Channels()>,
+      bmChannelConfig<TFormat::ChannelConfig()>,
+      iChannelNames<0>>,
+
+    DESCRIPTOR<DescriptorType::CS_INTERFACE,
+      bDescriptorSubType<0x02>,  // Format Type
+      bFormatType<1>,
+      bSubslotSize<TFormat::SubslotSize()>,
+      bBitResolution<TFormat::BitResolution()>>,
+
+    ENDPOINT_DESCRIPTOR
+    < TDataEp,
+      bmAttributes<epTYPE::Isochronous, epSYNC::Asynchronous, epUSAGE::Data>,
+      wMaxPacketSize<TFormat::MaxPacketSize()>,
+      bInterval<TFormat::Interval()> >,
+
+    DESCRIPTOR<DescriptorType::CS_ENDPOINT,
+      bDescriptorSubType<0x01>,  // EP General
+      HOLDER<REC_TYPE::bmAttributes, 0>,
+      bmControls<0>,
+      bLockDelayUnits<0>,
+      wLockDelay<0>>,
+
+    ENDPOINT_DESCRIPTOR
+    < TFeedbackEp,
+      bmAttributes<epTYPE::Isochronous, epSYNC::NoSynchronization, epUSAGE::Feedback>,
+      wMaxPacketSize<TFormat::FeedbackSize()>,
+      bInterval<TFormat::FeedbackInterval()> >...
+  >>
+{
+  static_assert(sizeof...(TFeedbackEp) <= 1, "Only one feedback endpoint");
+  static_assert((((TFeedbackEp::GetEpAddress() ^ TDataEp::GetEpAddress()) & (uint8_t)epDIR::IN) && ...),
+                "Feedback endpoint direction must be opposite to data endpoint");
+};
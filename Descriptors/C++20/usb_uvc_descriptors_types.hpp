@@ -0,0 +1,335 @@
+#pragma once
+
+//==============================================================================
+// USB Video Class 1.1 (Video Class Specification 1.1, Appendix A)
+//==============================================================================
+enum class UVC_TRANSFER : uint8_t { Isochronous, Bulk };
+
+// guidFormat = FourCC-0000-0010-8000-00AA00389B71
+enum class UVC_FOURCC : uint32_t { YUY2 = 0x32595559, NV12 = 0x3231564E };
+
+// Camera Terminal bmControls
+enum class UVC_CT_CONTROL : uint32_t
+{
+  None=0, ScanningMode=1<<0, AutoExposureMode=1<<1, AutoExposurePriority=1<<2,
+  ExposureTimeAbsolute=1<<3, FocusAbsolute=1<<5, ZoomAbsolute=1<<9, FocusAuto=1<<17
+};
+
+// Processing Unit bmControls
+enum class UVC_PU_CONTROL : uint16_t
+{
+  None=0, Brightness=1<<0, Contrast=1<<1, Hue=1<<2, Saturation=1<<3, Sharpness=1<<4,
+  Gamma=1<<5, WhiteBalanceTemperature=1<<6, BacklightCompensation=1<<8, Gain=1<<9,
+  PowerLineFrequency=1<<10, WhiteBalanceTemperatureAuto=1<<12
+};
+
+constexpr UVC_CT_CONTROL operator | (UVC_CT_CONTROL a, UVC_CT_CONTROL b) { return UVC_CT_CONTROL((uint32_t)a | (uint32_t)b); }
+constexpr UVC_PU_CONTROL operator | (UVC_PU_CONTROL a, UVC_PU_CONTROL b) { return UVC_PU_CONTROL((uint16_t)a | (uint16_t)b); }
+
+class UVC_ENTITY_BASE {};
+class UVC_FORMAT_BASE {};
+template<typename T> concept is_UVC_Entity = std::is_base_of_v<UVC_ENTITY_BASE, T>;
+template<typename T> concept is_UVC_Format = std::is_base_of_v<UVC_FORMAT_BASE, T>;
+
+//==============================================================================
+// Video Control Entities (ID назначаются по порядку в UVC_VC_INTERFACE)
+//==============================================================================
+template<typename TTag,
+         UVC_CT_CONTROL controls = UVC_CT_CONTROL::AutoExposureMode,
+         uint8_t iTerm = 0>
+struct UVC_CAMERA_TERMINAL : UVC_ENTITY_BASE
+{
+  using tag = TTag;
+  template<typename IDS> using descriptor = DESCRIPTOR<DescriptorType::CS_INTERFACE,
+    bDescriptorSubType<0x02>, bTerminalID<IDS::template Get<TTag>()>,
+    wTerminalType<0x0201>,  // ITT_CAMERA
+    bAssocTerminal<0>, iTerminal<iTerm>,
+    wObjectiveFocalLengthMin<0>, wObjectiveFocalLengthMax<0>, wOcularFocalLength<0>,
+    bControlSize<3>,
+    HOLDER<REC_TYPE::bmControls, uint8_t((uint32_t)controls), uint8_t((uint32_t)controls >> 8),
+                                 uint8_t((uint32_t)controls >> 16)>>;
+  template<typename IDS> static constexpr bool IsLinked() { return true; }
+};
+
+template<typename TTag,
+         typename TSource,
+         UVC_PU_CONTROL controls = UVC_PU_CONTROL::Brightness | UVC_PU_CONTROL::Contrast,
+         uint8_t iProc = 0>
+struct UVC_PROCESSING_UNIT : UVC_ENTITY_BASE
+{
+  using tag = TTag;
+  template<typename IDS> using descriptor = DESCRIPTOR<DescriptorType::CS_INTERFACE,
+    bDescriptorSubType<0x05>, bUnitID<IDS::template Get<TTag>()>,
+    bSourceID<IDS::template Get<TSource>()>, wMaxMultiplier<0>,
+    bControlSize<2>,
+    HOLDER<REC_TYPE::bmControls, uint8_t((uint16_t)controls), uint8_t((uint16_t)controls >> 8)>,
+    iProcessing<iProc>, bmVideoStandards<0>>;
+  template<typename IDS> static constexpr bool IsLinked() { return IDS::template Contains<TSource>(); }
+};
+
+template<typename TTag,
+         typename TSource,
+         uint8_t iTerm = 0>
+struct UVC_OUTPUT_TERMINAL : UVC_ENTITY_BASE
+{
+  using tag = TTag;
+  template<typename IDS> using descriptor = DESCRIPTOR<DescriptorType::CS_INTERFACE,
+    bDescriptorSubType<0x03>, bTerminalID<IDS::template Get<TTag>()>,
+    wTerminalType<0x0101>,  // TT_STREAMING
+    bAssocTerminal<0>, bSourceID<IDS::template Get<TSource>()>, iTerminal<iTerm>>;
+  template<typename IDS> static constexpr bool IsLinked() { return IDS::template Contains<TSource>(); }
+};
+
+//==============================================================================
+// Video Control Interface
+//==============================================================================
+template<is_bInterfaceNumber TbInterfaceNumber,
+         is_iInterface TiInterface,
+         uint32_t clock_frequency,                 // Гц, для PTS/SCR
+         is_bInterfaceNumber TbStreamingInterface, // VS интерфейс коллекции
+         is_UVC_Entity... ENTITIES>
+class UVC_VC_INTERFACE : public INTERFACE<TbInterfaceNumber, bAlternateSetting<0>,
+  bInterfaceClass<0x0E>,     // CC_VIDEO
+  bInterfaceSubClass<0x01>,  // SC_VIDEOCONTROL
+  bInterfaceProtocol<0>,
+  TiInterface,
+  DESCRIPTOR<DescriptorType::CS_INTERFACE,
+    bDescriptorSubType<0x01>,  // VC_HEADER
+    bcdUVC<0x01'10>,
+    wTotalLength<(sizeof(ENTITIES::template descriptor<ENTITY_IDS<ENTITIES...>>::buf) + ... + 13)>,
+    dwClockFrequency<clock_frequency>,
+    bInCollection<1>,
+    HOLDER<REC_TYPE::baInterfaceNr, TbStreamingInterface{}.value()>>,
+  typename ENTITIES::template descriptor<ENTITY_IDS<ENTITIES...>>...>
+{
+  using IDS = ENTITY_IDS<ENTITIES...>;
+  static_assert(TypeList<typename ENTITIES::tag...>::is_unique(), "Duplicate Video Entities!");
+  static_assert((ENTITIES::template IsLinked<IDS>() && ...), "Unknown Video Entity reference");
+public:
+  template<typename TAG> static constexpr uint8_t EntityID()
+  {
+    static_assert(IDS::template Contains<TAG>(), "Unknown Video Entity");
+    return IDS::template Get<TAG>();
+  }
+};
+
+//==============================================================================
+// Video Frames and Formats: размеры буферов, битрейты и интервалы из разрешения и fps
+//==============================================================================
+template<uint16_t width, uint16_t height, uint32_t... fps>
+class UVC_FRAME
+{
+  static_assert(sizeof...(fps) > 0, "At least one frame rate");
+  static_assert(((fps > 0) && ...), "Wrong frame rate");
+  static constexpr uint32_t rates[] { fps... };
+public:
+  static constexpr uint32_t Pixels() { return (uint32_t)width * height; }
+  static constexpr uint32_t MaxFps() { return std::max({ fps... }); }
+  static constexpr uint32_t MinFps() { return std::min({ fps... }); }
+  static constexpr uint32_t FrameBufferSize(uint8_t bpp) { return Pixels() * bpp / 8; }
+  static constexpr uint32_t ByteRate(uint8_t bpp) { return FrameBufferSize(bpp) * MaxFps(); } // байт/с
+
+  template<uint8_t subtype, uint8_t index, uint8_t bpp>
+  using descriptor = DESCRIPTOR<DescriptorType::CS_INTERFACE,
+    bDescriptorSubType<subtype>, bFrameIndex<index>, bmCapabilities<0>,
+    wWidth<width>, wHeight<height>,
+    dwMinBitRate<FrameBufferSize(bpp) * 8 * MinFps()>,
+    dwMaxBitRate<FrameBufferSize(bpp) * 8 * MaxFps()>,
+    dwMaxVideoFrameBufferSize<FrameBufferSize(bpp)>,
+    dwDefaultFrameInterval<10'000'000 / rates[0]>,  // 100 нс
+    bFrameIntervalType<sizeof...(fps)>,
+    dwFrameInterval<10'000'000 / fps>...>;
+
+  static_assert((uint64_t)Pixels() * 32 * MaxFps() < (1ull << 32), "Bit rate overflow");
+};
+
+template<uint8_t format_subtype, uint8_t frame_subtype, uint8_t bpp, typename... FRAMES>
+class UVC_FORMAT_FRAMES : public UVC_FORMAT_BASE
+{
+  static_assert(sizeof...(FRAMES) > 0, "At least one frame");
+
+  template<typename TFormat, auto... Is>
+  static consteval auto Bind(std::index_sequence<Is...>)
+  {
+    return TypeBox<DESCRIPTOR_LIST<TFormat, typename FRAMES::template descriptor<frame_subtype, Is + 1, bpp>...>>{};
+  }
+protected:
+  template<typename TFormat>
+  using frames = TypeUnBox<Bind<TFormat>(std::make_index_sequence<sizeof...(FRAMES)>())>;
+public:
+  static constexpr uint8_t FramesCount() { return sizeof...(FRAMES); }
+  static constexpr void ForEachByteRate(auto func) { (func(FRAMES::ByteRate(bpp)), ...); }
+};
+
+template<UVC_FOURCC fourcc, uint8_t bpp, typename... FRAMES>
+struct UVC_FORMAT_UNCOMPRESSED : UVC_FORMAT_FRAMES<0x04, 0x05, bpp, FRAMES...>
+{
+  template<uint8_t index> using descriptors = typename UVC_FORMAT_UNCOMPRESSED::template frames<
+    DESCRIPTOR<DescriptorType::CS_INTERFACE,
+      bDescriptorSubType<0x04>,  // VS_FORMAT_UNCOMPRESSED
+      bFormatIndex<index>,
+      bNumFrameDescriptors<sizeof...(FRAMES)>,
+      HOLDER<REC_TYPE::guidFormat, uint8_t((uint32_t)fourcc), uint8_t((uint32_t)fourcc >> 8),
+             uint8_t((uint32_t)fourcc >> 16), uint8_t((uint32_t)fourcc >> 24),
+             0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71>,
+      bBitsPerPixel<bpp>,
+      bDefaultFrameIndex<1>,
+      bAspectRatioX<0>, bAspectRatioY<0>,
+      bmInterlaceFlags<0>,
+      bCopyProtect<0>>>;
+};
+
+// bpp - худший случай для размера буфера и расчета полосы (например, 16 для YUY2 источника)
+template<uint8_t bpp, typename... FRAMES>
+struct UVC_FORMAT_MJPEG : UVC_FORMAT_FRAMES<0x06, 0x07, bpp, FRAMES...>
+{
+  template<uint8_t index> using descriptors = typename UVC_FORMAT_MJPEG::template frames<
+    DESCRIPTOR<DescriptorType::CS_INTERFACE,
+      bDescriptorSubType<0x06>,  // VS_FORMAT_MJPEG
+      bFormatIndex<index>,
+      bNumFrameDescriptors<sizeof...(FRAMES)>,
+      bmFlags<1>,                // FixedSizeSamples
+      bDefaultFrameIndex<1>,
+      bAspectRatioX<0>, bAspectRatioY<0>,
+      bmInterlaceFlags<0>,
+      bCopyProtect<0>>>;
+};
+
+//==============================================================================
+// Лестница альтернативных настроек: по одной на каждую уникальную полосу кадра
+//==============================================================================
+template<USB_SPEED speed, is_UVC_Format... FORMATS>
+struct UVC_BANDWIDTH
+{
+  static_assert(speed != USB_SPEED::SUPER, "SuperSpeed requires endpoint companion descriptors");
+  static constexpr uint32_t PayloadHeader() { return 12; }  // заголовок с PTS и SCR
+  static constexpr uint32_t PacketsPerSecond() { return (speed == USB_SPEED::FULL) ? 1000 : 8000; }
+  static constexpr uint32_t MaxPayload() { return (speed == USB_SPEED::FULL) ? 1023 : 3 * 1024; }
+
+  // Байт на (микро)кадр для потока byte_rate
+  static constexpr uint32_t Payload(uint32_t byte_rate)
+  {
+    return (byte_rate + PacketsPerSecond() - 1) / PacketsPerSecond() + PayloadHeader();
+  }
+  // wMaxPacketSize с учетом дополнительных транзакций HS (биты 12..11)
+  static constexpr uint16_t Encode(uint32_t payload)
+  {
+    uint32_t mult = (payload + 1023) / 1024;
+    return ((mult - 1) << 11) | ((payload + mult - 1) / mult);
+  }
+
+  struct LADDER
+  {
+    uint32_t payload[(FORMATS::FramesCount() + ...)];
+    uint8_t count;
+  };
+
+  static consteval LADDER Ladder()
+  {
+    LADDER l{};
+    auto add = [&l](uint32_t byte_rate)
+    {
+      uint32_t p = Payload(byte_rate);
+      uint8_t i = 0;
+      while ((i < l.count) && (l.payload[i] < p)) ++i;
+      if ((i < l.count) && (l.payload[i] == p)) return;
+      for (uint8_t j = l.count; j > i; --j) l.payload[j] = l.payload[j - 1];
+      l.payload[i] = p;
+      ++l.count;
+    };
+    (FORMATS::ForEachByteRate(add), ...);
+    return l;
+  }
+
+  static constexpr LADDER ladder = Ladder();
+  static constexpr uint8_t AltSettingsCount() { return ladder.count; }
+  static constexpr uint16_t MaxPacketSize(uint8_t alt) { return Encode(ladder.payload[alt - 1]); }
+  static constexpr uint32_t ByteRate(uint8_t alt) { return (ladder.payload[alt - 1] - PayloadHeader()) * PacketsPerSecond(); }
+
+  static_assert(ladder.payload[ladder.count - 1] <= MaxPayload(), "Video stream exceeds isochronous bandwidth");
+};
+
+//==============================================================================
+// Video Streaming Interface
+// Isochronous: alt 0 - форматы без точек, alt 1...N - лестница wMaxPacketSize
+// Bulk: alt 0 - форматы и bulk точка
+//==============================================================================
+template<typename TVC,                  // UVC_VC_INTERFACE
+         typename TTerminalLink,        // Output Terminal (TT_STREAMING)
+         is_bInterfaceNumber TbInterfaceNumber,
+         USB_SPEED speed,
+         UVC_TRANSFER transfer,
+         is_bEndpointAddress TEp,
+         is_UVC_Format... FORMATS>
+class UVC_VS_INTERFACE_BUILDER
+{
+  static_assert(TEp::GetEpAddress() & (uint8_t)epDIR::IN, "Video streaming endpoint must be IN");
+
+  template<auto... Is>
+  static consteval auto BindFormats(std::index_sequence<Is...>)
+  {
+    return TypeBox<DESCRIPTOR_LIST<typename FORMATS::template descriptors<Is + 1>...>>{};
+  }
+  using FORMAT_LIST = TypeUnBox<BindFormats(std::make_index_sequence<sizeof...(FORMATS)>())>;
+
+  using INPUT_HEADER = DESCRIPTOR<DescriptorType::CS_INTERFACE,
+    bDescriptorSubType<0x01>,  // VS_INPUT_HEADER
+    bNumFormats<sizeof...(FORMATS)>,
+    wTotalLength<sizeof(FORMAT_LIST::buf) + 13 + sizeof...(FORMATS)>,
+    TEp,
+    bmInfo<0>,
+    bTerminalLink<TVC::template EntityID<TTerminalLink>()>,
+    bStillCaptureMethod<0>,
+    bTriggerSupport<0>,
+    bTriggerUsage<0>,
+    bControlSize<1>,
+    HOLDER<REC_TYPE::bmaControls, uint8_t(0 * sizeof(FORMATS))...>>;
+
+  template<typename... DSCS>
+  using VS_INTERFACE = INTERFACE<TbInterfaceNumber, bAlternateSetting<0>, bInterfaceClass<0x0E>,
+    bInterfaceSubClass<0x02>, bInterfaceProtocol<0>, iInterface<0>, INPUT_HEADER, FORMAT_LIST, DSCS...>;
+
+  using BW = UVC_BANDWIDTH<speed, FORMATS...>;
+
+  template<auto... Is>
+  static consteval auto BindAlternates(std::index_sequence<Is...>)
+  {
+    return TypeBox<INTERFACE_ALTERNATES<VS_INTERFACE<>,
+      INTERFACE<TbInterfaceNumber, bAlternateSetting<Is + 1>, bInterfaceClass<0x0E>,
+        bInterfaceSubClass<0x02>, bInterfaceProtocol<0>, iInterface<0>,
+        ENDPOINT_DESCRIPTOR
+        < TEp,
+          bmAttributes<epTYPE::Isochronous, epSYNC::Asynchronous>,
+          wMaxPacketSize<BW::MaxPacketSize(Is + 1)>,
+          bInterval<1> > >...>>{};
+  }
+
+  static consteval auto Build()
+  {
+    if constexpr (transfer == UVC_TRANSFER::Bulk)
+      return TypeBox<INTERFACE_ALTERNATES<VS_INTERFACE<
+        ENDPOINT_DESCRIPTOR
+        < TEp,
+          bmAttributes<epTYPE::Bulk>,
+          wMaxPacketSize<(speed == USB_SPEED::FULL) ? 64 : 512>,
+          bInterval<0> > >>>{};
+    else
+      return BindAlternates(std::make_index_sequence<BW::AltSettingsCount()>());
+  }
+public:
+  using type = TypeUnBox<Build()>;
+};
+
+template<typename TVC,
+         typename TTerminalLink,
+         is_bInterfaceNumber TbInterfaceNumber,
+         USB_SPEED speed,
+         UVC_TRANSFER transfer,
+         is_bEndpointAddress TEp,
+         is_UVC_Format... FORMATS>
+class UVC_VS_INTERFACE : public UVC_VS_INTERFACE_BUILDER<TVC, TTerminalLink, TbInterfaceNumber,
+  speed, transfer, TEp, FORMATS...>::type
+{
+public:
+  using BANDWIDTH = UVC_BANDWIDTH<speed, FORMATS...>;
+};
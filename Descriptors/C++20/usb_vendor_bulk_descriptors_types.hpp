@@ -0,0 +1,94 @@
+#pragma once
+
+//==============================================================================
+// Vendor Bulk Interface: поток делится на полосы (stripe) по нескольким
+// парам Bulk точек. Пара i - EP(first_ep + i) IN и EP(first_ep + i) OUT
+//==============================================================================
+template<is_bInterfaceNumber TbInterfaceNumber,
+         USB_SPEED speed,
+         uint8_t pairs,                 // количество пар IN/OUT
+         uint8_t first_ep = 1,          // номер точки первой пары
+         uint32_t stripe_size = 16384,  // байт подряд в одну пару (округляется вниз до пакета)
+         is_iInterface TiInterface = iInterface<0>>
+class VENDOR_BULK_BUILDER
+{
+public:
+  static constexpr uint16_t MaxPacketSize() { return (speed == USB_SPEED::FULL) ? 64 : 512; }
+  static constexpr uint32_t StripeSize() { return stripe_size / MaxPacketSize() * MaxPacketSize(); }
+
+  static_assert(speed != USB_SPEED::SUPER, "SuperSpeed requires endpoint companion descriptors");
+  static_assert((pairs > 0) && (first_ep > 0) && (first_ep + pairs - 1 <= 15), "Wrong endpoint pairs");
+  static_assert(StripeSize() > 0, "Stripe less than wMaxPacketSize");
+private:
+  template<epDIR dir, uint8_t i>
+  using BULK_EP = ENDPOINT_DESCRIPTOR
+  < bEndpointAddress<first_ep + i, dir>,
+    bmAttributes<epTYPE::Bulk>,
+    wMaxPacketSize<MaxPacketSize()>,
+    bInterval<0> >;
+
+  template<uint8_t i>
+  struct PAIR
+  {
+    using type = DESCRIPTOR_LIST<BULK_EP<epDIR::IN, i>, BULK_EP<epDIR::OUT, i>>;
+  };
+
+  static consteval auto Build()
+  {
+    constexpr auto eps = TypeList<>::generate<pairs>([](auto i) { return TypeBox<PAIR<decltype(i)::value>>{}; })
+                         .transform([](auto p) { return TypeBox<typename TypeUnBox<p>::type>{}; });
+    return []<typename... EPS>(TypeList<EPS...>)
+    {
+      return TypeBox<INTERFACE<TbInterfaceNumber, bAlternateSetting<0>,
+        bInterfaceClass<0xFF>,     // Vendor Specified
+        bInterfaceSubClass<0xFF>,
+        bInterfaceProtocol<0xFF>,
+        TiInterface,
+        EPS...>>{};
+    }(eps);
+  }
+public:
+  using type = TypeUnBox<Build()>;
+};
+
+template<is_bInterfaceNumber TbInterfaceNumber,
+         USB_SPEED speed,
+         uint8_t pairs,
+         uint8_t first_ep = 1,
+         uint32_t stripe_size = 16384,
+         is_iInterface TiInterface = iInterface<0>>
+class VENDOR_BULK_INTERFACE : public VENDOR_BULK_BUILDER<TbInterfaceNumber, speed, pairs, first_ep,
+                                                         stripe_size, TiInterface>::type
+{
+  using BUILDER = VENDOR_BULK_BUILDER<TbInterfaceNumber, speed, pairs, first_ep, stripe_size, TiInterface>;
+public:
+  //============================================================================
+  // Порядок полос для хоста: полоса k идет через пару k % pairs,
+  // внутри пары полосы следуют в порядке возрастания k
+  //============================================================================
+  class STRIPE_INFO
+  {
+  public:
+    static constexpr uint8_t PairsCount() { return pairs; }
+    static constexpr uint32_t StripeSize() { return BUILDER::StripeSize(); }
+    static constexpr uint8_t Pair(uint64_t offset) { return uint8_t(offset / StripeSize() % pairs); }
+    static constexpr uint8_t InEp(uint8_t pair) { return uint8_t(first_ep + pair) | uint8_t(epDIR::IN); }
+    static constexpr uint8_t OutEp(uint8_t pair) { return uint8_t(first_ep + pair); }
+
+    // Ответ на vendor запрос: bLength, bPairs, dwStripeSize, адреса IN[pairs], OUT[pairs]
+    constexpr STRIPE_INFO()
+    {
+      buf[0] = sizeof(buf);
+      buf[1] = pairs;
+      for (uint8_t i = 0; i < 4; ++i) buf[2 + i] = uint8_t(StripeSize() >> (8 * i));
+      for (uint8_t i = 0; i < pairs; ++i)
+      {
+        buf[6 + i] = InEp(i);
+        buf[6 + pairs + i] = OutEp(i);
+      }
+    }
+    uint8_t buf[6 + 2 * pairs]{};
+  };
+
+  static constexpr uint16_t MaxPacketSize() { return BUILDER::MaxPacketSize(); }
+};
@@ -5,9 +5,13 @@
 #else
 #include "C++17/usb_descriptors.h"
 #endif
+#include "usb_common_strings.hpp"
 
-STRING_DESCRIPTOR( 0, StringLangID,    u"\x0409"                );
-STRING_DESCRIPTOR( 1, StringVendor,    u"STMicroelectronics"    );
+namespace CDCx2_PROFILE
+{
+
+using USB_COMMON_STRINGS::StringLangID;
+using USB_COMMON_STRINGS::StringVendor;
 STRING_DESCRIPTOR( 2, StringProduct,   u"STM32 Virtual ComPort" );
 STRING_DESCRIPTOR( 3, StringSerial,    u"000000000023"          );
 STRING_DESCRIPTOR( 4, StringIF0,       u"IF_0"                  );
@@ -26,40 +30,20 @@ inline const uint8_t * const descr_table[] =
 using namespace USB_DESCRIPTORS;
 
 //==============================================================================
-// Device Descriptor
+// CDC VCP: номера интерфейсов и точек назначает FUNCTION_ALLOCATION
 //==============================================================================
-constexpr DEVICE_DESCRIPTOR
-< bcdUSB<0x02'00>,       // версия usb 2.0
-  bDeviceClass<0xEF>,    // Miscellaneous Device Class
-  bDeviceSubClass<2>,    // Common Class
-  bDeviceProtocol<1>,    // Interface Association Descriptor
-  bMaxPacketSize0<64>,
-  idVendor<0x0483>,      // VID
-  idProduct<0x5740>,     // PID
-  bcdDevice<0x0200>,
-  iManufacturer<1>,
-  iProduct<2>,
-  iSerialNumber<3>,
-  bNumConfigurations<1>
-> Device_Descriptor;
+template<uint8_t iString=0>
+struct VCP
+{
+  static constexpr uint8_t interfaces = 2;   // Communication + Data
 
-//==============================================================================
-// Device Qualifier Descriptor
-//==============================================================================
-constexpr DEVICE_QUALIFIER_DESCRIPTOR
-< bcdUSB<0x02'00>,       // версия usb 2.0
-  bDeviceClass<0xEF>,    // Miscellaneous Device Class
-  bDeviceSubClass<2>,    // Common Class
-  bDeviceProtocol<1>,    // Interface Association Descriptor
-  bMaxPacketSize0<64>,
-  bNumConfigurations<0>
-> Device_Qualifier_Descriptor;
+  using endpoints = TypeList
+  < EP_REQUEST<epTYPE::Interrupt, epDIR::IN, 8, 255>,  // Notification
+    EP_REQUEST<epTYPE::Bulk, epDIR::OUT, 64>,          // Data OUT
+    EP_REQUEST<epTYPE::Bulk, epDIR::IN, 64> >;         // Data IN
 
-//==============================================================================
-// CDC VCP Configuration Descriptor
-//==============================================================================
-template<uint8_t first_if, uint8_t ctrl_ep_num, uint8_t data_ep_num, uint8_t iString=0>
-using VCP = INTERFACE_ASSOCIATION
+  template<uint8_t first_if, typename TNotifyEp, typename TDataOutEp, typename TDataInEp>
+  struct descriptors : INTERFACE_ASSOCIATION
   < bFunctionClass<2>,
     bFunctionSubClass<2>,
     bFunctionProtocol<0>,
@@ -83,19 +67,15 @@ using VCP = INTERFACE_ASSOCIATION
 
       CDC_UNION_FUNCTIONAL_DESCRIPTOR
       < bDescriptorSubType<6>,       // Union Functional Descriptor
-        bControlInterface<0>,        // Interface 0  -
-        bSubordinateInterface0<1> >, // Interface 1  -  Data Class Interface
+        bControlInterface<first_if>,           // Communication Interface
+        bSubordinateInterface0<first_if+1> >,  // Data Class Interface
 
       CDC_CALL_MANAGEMENT_FUNCTIONAL_DESCRIPTOR
       < bDescriptorSubType<1>,     // Call Management Functional Descriptor
         bmCapabilities<0>,
-        bDataInterface<1> >,       //
+        bDataInterface<first_if+1> >,  // Data Class Interface
 
-      ENDPOINT_DESCRIPTOR      // EP - In Interrupt EndPoint
-      < bEndpointAddress<ctrl_ep_num, epDIR::IN>,
-        bmAttributes<epTYPE::Interrupt>,
-        wMaxPacketSize<8>,
-        bInterval<255> >
+      TNotifyEp                    // EP - In Interrupt EndPoint
     >,
 
     INTERFACE                // Interface - Data Interface
@@ -106,19 +86,19 @@ using VCP = INTERFACE_ASSOCIATION
       bInterfaceProtocol<0>,
       iInterface<0>,
 
-      ENDPOINT_DESCRIPTOR<    // EP - OUT Bulk EndPoint
-        bEndpointAddress<data_ep_num, epDIR::OUT>,
-        bmAttributes<epTYPE::Bulk>,
-        wMaxPacketSize<64>,
-        bInterval<0> >,
-
-      ENDPOINT_DESCRIPTOR<    // EP - IN Bulk EndPoint
-        bEndpointAddress<data_ep_num, epDIR::IN>,
-        bmAttributes<epTYPE::Bulk>,
-        wMaxPacketSize<64>,
-        bInterval<0> >
+      TDataOutEp,            // EP - OUT Bulk EndPoint
+      TDataInEp              // EP - IN Bulk EndPoint
     >
-  >;
+  > { };
+};
+
+//==============================================================================
+// CDC VCP Configuration Descriptor
+//==============================================================================
+using VCP_FUNCTIONS = FUNCTION_ALLOCATION
+< 8,         // STM32 FS: 8 двунаправленных точек, включая EP0
+  VCP<4>,    // Интерфейсы 0 и 1, строка интерфейса 4
+  VCP<5> >;  // Интерфейсы 2 и 3, строка интерфейса 5
 
 constexpr DEVICE_CONFIGURATION_DESCRIPTOR
 <   bConfigurationValue<1>,               // Configuration 1
@@ -126,13 +106,101 @@ constexpr DEVICE_CONFIGURATION_DESCRIPTOR
     bmAttributes<cfg_Attr::SelfPowered>,  // Self powered
     bMaxPower<100/2>,                     // 100 mA
 
-    VCP<0,   // Интерфейсы (0 и 1)
-        3,   // Control EP num
-        1,   // Data EP num
-        4 >, // Номер строкового дескриптора интерфейса
-
-    VCP<2,   // Интерфейсы (2 и 3)
-        4,   // Control EP num
-        2,   // Data EP num
-        5>   // Номер строкового дескриптора интерфейса
+    VCP_FUNCTIONS                         // Data EP1, EP2; Notification EP3, EP4
 > Configuration_Descriptor;
+
+static_assert(PERIODIC_BANDWIDTH<decltype(Configuration_Descriptor), USB_SPEED::FULL>::Fits(),
+              "Periodic bandwidth exceeded");
+
+//==============================================================================
+// Проверка распределителя: оставшиеся точки разных функций делят номер только
+// при одном типе. Interrupt IN и Bulk OUT на одном номере EPnR не настроить
+//==============================================================================
+template<epTYPE type, epDIR dir>
+struct SINGLE_EP_FUNCTION
+{
+  static constexpr uint8_t interfaces = 1;
+
+  using endpoints = TypeList<EP_REQUEST<type, dir, 64, (type == epTYPE::Interrupt) ? 10 : 0>>;
+
+  template<uint8_t first_if, typename TEp>
+  struct descriptors : INTERFACE
+  < bInterfaceNumber<first_if>, bAlternateSetting<0>, bInterfaceClass<0xFF>,
+    bInterfaceSubClass<0>, bInterfaceProtocol<0>, iInterface<0>, TEp > { };
+};
+
+using MIXED_LEFTOVERS = FUNCTION_ALLOCATION
+< 8,
+  SINGLE_EP_FUNCTION<epTYPE::Interrupt, epDIR::IN>,
+  SINGLE_EP_FUNCTION<epTYPE::Bulk, epDIR::OUT>,
+  SINGLE_EP_FUNCTION<epTYPE::Bulk, epDIR::IN> >;
+
+static_assert((MIXED_LEFTOVERS::EpAddress(1, 0) == 0x01) && (MIXED_LEFTOVERS::EpAddress(2, 0) == 0x81) &&
+              (MIXED_LEFTOVERS::EpAddress(0, 0) == 0x82) && (MIXED_LEFTOVERS::NumbersUsed() == 2),
+              "Endpoints of different types share a number");
+
+//==============================================================================
+// Хранение фрагментами: конфигурация 2 - только первый порт с теми же номерами
+// интерфейсов и точек, его байты во flash общие с конфигурацией 1. Непрерывный
+// Configuration_Descriptor выше нужен только для вывода примера
+//==============================================================================
+using TWO_PORTS_CONFIGURATION = GATHERED_CONFIGURATION_DESCRIPTOR
+< bConfigurationValue<1>,
+  iConfiguration<0>,
+  bmAttributes<cfg_Attr::SelfPowered>,
+  bMaxPower<100/2>,
+
+  VCP_FUNCTIONS >;                      // фрагменты VCP 0 и VCP 1
+
+using ONE_PORT_CONFIGURATION = GATHERED_CONFIGURATION_DESCRIPTOR
+< bConfigurationValue<2>,
+  iConfiguration<0>,
+  bmAttributes<cfg_Attr::SelfPowered>,
+  bMaxPower<100/2>,
+
+  VCP_FUNCTIONS::function<0> >;         // тот же фрагмент VCP 0
+
+using CONFIGURATIONS = DEVICE_CONFIGURATIONS
+< 0x80,       // буферы точек после EP0 IN/OUT
+  0x400,      // 1 кБ памяти пакетов
+  TWO_PORTS_CONFIGURATION,
+  ONE_PORT_CONFIGURATION >;
+
+//==============================================================================
+// Device Descriptor
+//==============================================================================
+constexpr DEVICE_DESCRIPTOR
+< bcdUSB<0x02'00>,       // версия usb 2.0
+  bDeviceClass<0xEF>,    // Miscellaneous Device Class
+  bDeviceSubClass<2>,    // Common Class
+  bDeviceProtocol<1>,    // Interface Association Descriptor
+  bMaxPacketSize0<64>,
+  idVendor<0x0483>,      // VID
+  idProduct<0x5740>,     // PID
+  bcdDevice<0x0200>,
+  iManufacturer<1>,
+  iProduct<2>,
+  iSerialNumber<3>,
+  CONFIGURATIONS::NUM_CONFIGURATIONS
+> Device_Descriptor;
+
+//==============================================================================
+// Device Qualifier Descriptor
+//==============================================================================
+constexpr DEVICE_QUALIFIER_DESCRIPTOR
+< bcdUSB<0x02'00>,       // версия usb 2.0
+  bDeviceClass<0xEF>,    // Miscellaneous Device Class
+  bDeviceSubClass<2>,    // Common Class
+  bDeviceProtocol<1>,    // Interface Association Descriptor
+  bMaxPacketSize0<64>,
+  bNumConfigurations<0>
+> Device_Qualifier_Descriptor;
+
+//==============================================================================
+// Personality
+//==============================================================================
+constexpr GATHER_LIST Configurations[] { CONFIGURATIONS::Descriptor(0), CONFIGURATIONS::Descriptor(1) };
+
+constexpr USB_PERSONALITY Personality { Device_Descriptor.buf, Configurations, descr_table, std::size(descr_table) };
+
+} // namespace CDCx2_PROFILE
@@ -5,9 +5,13 @@
 #else
 #include "C++17/usb_descriptors.h"
 #endif 
+#include "usb_common_strings.hpp"
 
-STRING_DESCRIPTOR( 0, StringLangID,    u"\x0409"                );
-STRING_DESCRIPTOR( 1, StringVendor,    u"STMicroelectronics"    );
+namespace CDC_PROFILE
+{
+
+using USB_COMMON_STRINGS::StringLangID;
+using USB_COMMON_STRINGS::StringVendor;
 STRING_DESCRIPTOR( 2, StringProduct,   u"STM32 Virtual ComPort" );
 STRING_DESCRIPTOR( 3, StringSerial,    u"00000000001A"          );
 
@@ -115,5 +119,14 @@ constexpr DEVICE_CONFIGURATION_DESCRIPTOR
   >
 > Configuration_Descriptor;
 
+static_assert(PERIODIC_BANDWIDTH<decltype(Configuration_Descriptor), USB_SPEED::FULL>::Fits(),
+              "Periodic bandwidth exceeded");
+
+//==============================================================================
+// Personality
+//==============================================================================
+constexpr GATHER_LIST Configurations[] { GatherList<Configuration_Descriptor>() };
 
+constexpr USB_PERSONALITY Personality { Device_Descriptor.buf, Configurations, descr_table, std::size(descr_table) };
 
+} // namespace CDC_PROFILE
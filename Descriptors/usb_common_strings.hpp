@@ -0,0 +1,19 @@
+#pragma once
+
+#if (__cplusplus > 201703L)
+#include "C++20/usb_descriptors.hpp"
+#else
+#include "C++17/usb_descriptors.h"
+#endif
+
+//==============================================================================
+// Строки, общие для всех профилей: в образе с несколькими личностями
+// хранятся в одном экземпляре
+//==============================================================================
+namespace USB_COMMON_STRINGS
+{
+
+STRING_DESCRIPTOR( 0, StringLangID,    u"\x0409"                );
+STRING_DESCRIPTOR( 1, StringVendor,    u"STMicroelectronics"    );
+
+} // namespace USB_COMMON_STRINGS
@@ -0,0 +1,83 @@
+#pragma once
+
+#if (__cplusplus > 201703L)
+#include "C++20/usb_descriptors.hpp"
+#else
+#include "C++17/usb_descriptors.h"
+#endif
+#include "usb_common_strings.hpp"
+
+namespace DFU_PROFILE
+{
+
+using USB_COMMON_STRINGS::StringLangID;
+using USB_COMMON_STRINGS::StringVendor;
+STRING_DESCRIPTOR( 2, StringProduct,   u"STM32 DFU Bootloader"  );
+STRING_DESCRIPTOR( 3, StringSerial,    u"000000000020"          );
+// DfuSe: "@Имя/Адрес/Количество*Размер{K|M}{a..g}" для каждой области памяти
+STRING_DESCRIPTOR( 4, StringFlash,     u"@Internal Flash  /0x08000000/128*002Kg" );
+STRING_DESCRIPTOR( 5, StringOption,    u"@Option Bytes  /0x1FFFF800/01*016 e"    );
+
+inline const uint8_t * const descr_table[] =
+{
+  (uint8_t *)&StringLangID,
+  (uint8_t *)&StringVendor,
+  (uint8_t *)&StringProduct,
+  (uint8_t *)&StringSerial,
+  (uint8_t *)&StringFlash,
+  (uint8_t *)&StringOption
+};
+
+using namespace USB_DESCRIPTORS;
+
+//==============================================================================
+// DFU Device Descriptor
+//==============================================================================
+constexpr DEVICE_DESCRIPTOR
+< bcdUSB<0x02'00>,       // версия usb 2.0
+  bDeviceClass<0>,       // Class is specified in the interface descriptor
+  bDeviceSubClass<0>,    // Subclass is specified in the interface descriptor
+  bDeviceProtocol<0>,    // Protocol is specified in the interface descriptor
+  bMaxPacketSize0<64>,
+  idVendor<0x0483>,      // VID
+  idProduct<0xDF11>,     // PID: STM DFU mode
+  bcdDevice<0x0200>,
+  iManufacturer<1>,      // индекс строки с названием производителя
+  iProduct<2>,           // индекс строки с названием устройства
+  iSerialNumber<3>,      // индекс строки с серийным номером устройства
+  bNumConfigurations<1>  // количество поддерживаемых конфигураций
+> Device_Descriptor;
+
+//==============================================================================
+// wTransferSize: страница flash 2 КБ, буфер DNLOAD 8 КБ -> 4 страницы за запрос
+//==============================================================================
+using DFU_TRANSFER = DFU_TRANSFER_SIZE<2048, 8192, decltype(Device_Descriptor)::GetMaxPacketSize0()>;
+
+//==============================================================================
+// DFU Configuration Descriptor
+//==============================================================================
+constexpr DEVICE_CONFIGURATION_DESCRIPTOR
+< bConfigurationValue<1>,               // Configuration 1
+  iConfiguration<0>,                    // No String Descriptor
+  bmAttributes<cfg_Attr::SelfPowered>,  // Self powered
+  bMaxPower<100/2>,                     // 100 mA
+
+  DFU_MODE_INTERFACE                    // Interface 0: alt 0 - Flash, alt 1 - Option Bytes
+  < bInterfaceNumber<0>,
+    DFU_FUNCTIONAL_DESCRIPTOR
+    < bmAttributes<dfu_Attr::CanDnload, dfu_Attr::CanUpload, dfu_Attr::WillDetach>,
+      wDetachTimeOut<255>,              // мс
+      DFU_TRANSFER::type,               // wTransferSize
+      bcdDFUVersion<0x011A> >,          // DfuSe
+    iInterface<4>,
+    iInterface<5> >
+> Configuration_Descriptor;
+
+//==============================================================================
+// Personality
+//==============================================================================
+constexpr GATHER_LIST Configurations[] { GatherList<Configuration_Descriptor>() };
+
+constexpr USB_PERSONALITY Personality { Device_Descriptor.buf, Configurations, descr_table, std::size(descr_table) };
+
+} // namespace DFU_PROFILE
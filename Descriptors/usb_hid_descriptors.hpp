@@ -5,9 +5,13 @@
 #else
 #include "C++17/usb_descriptors.h"
 #endif 
+#include "usb_common_strings.hpp"
 
-STRING_DESCRIPTOR(0, StringLangID,    u"\x0409"                );
-STRING_DESCRIPTOR(1, StringVendor,    u"STMicroelectronics"    );
+namespace HID_PROFILE
+{
+
+using USB_COMMON_STRINGS::StringLangID;
+using USB_COMMON_STRINGS::StringVendor;
 STRING_DESCRIPTOR(2, StringProduct,   u"STM32 Custom HID"      );
 STRING_DESCRIPTOR(3, StringSerial,    u"00000000001C"          );
 
@@ -131,7 +135,7 @@ constexpr DEVICE_CONFIGURATION_DESCRIPTOR
       bEndpointAddress<1,epDIR::IN>,
       bmAttributes<epTYPE::Interrupt>,
       wMaxPacketSize<2>,
-      bInterval<20> >,
+      bInterval<POLLING<epTYPE::Interrupt, USB_SPEED::FULL>::ForRate<50>()> >, // 50 отчетов/с
   
     ENDPOINT_DESCRIPTOR<    // EP1 OUT Interrupt EndPoint
       bEndpointAddress<1,epDIR::OUT>,
@@ -140,3 +144,15 @@ constexpr DEVICE_CONFIGURATION_DESCRIPTOR
       bInterval<0> >
   >  
 > Configuration_Descriptor;
+
+static_assert(PERIODIC_BANDWIDTH<decltype(Configuration_Descriptor), USB_SPEED::FULL>::Fits(),
+              "Periodic bandwidth exceeded");
+
+//==============================================================================
+// Personality
+//==============================================================================
+constexpr GATHER_LIST Configurations[] { GatherList<Configuration_Descriptor>() };
+
+constexpr USB_PERSONALITY Personality { Device_Descriptor.buf, Configurations, descr_table, std::size(descr_table) };
+
+} // namespace HID_PROFILE
@@ -5,9 +5,13 @@
 #else
 #include "C++17/usb_descriptors.h"
 #endif 
+#include "usb_common_strings.hpp"
 
-STRING_DESCRIPTOR( 0, StringLangID,    u"\x0409"                );
-STRING_DESCRIPTOR( 1, StringVendor,    u"STMicroelectronics"    );
+namespace MSD_PROFILE
+{
+
+using USB_COMMON_STRINGS::StringLangID;
+using USB_COMMON_STRINGS::StringVendor;
 STRING_DESCRIPTOR( 2, StringProduct,   u"STM32 Mass Storage" );
 STRING_DESCRIPTOR( 3, StringSerial,    u"00000000001B"          );
 
@@ -52,6 +56,17 @@ constexpr DEVICE_QUALIFIER_DESCRIPTOR
 > Device_Qualifier_Descriptor;
 
 
+//==============================================================================
+// MSD Interface: точки используются и дескрипторами, и BOT движком.
+// Только BOT: движок MSC::BOT не понимает UAS, MSC_UAS_INTERFACE - вместе
+// с движком UAS
+//==============================================================================
+using MSD_INTERFACE = MSC_INTERFACE
+< bInterfaceNumber<0>,
+  USB_SPEED::FULL,
+  bEndpointAddress<1,epDIR::IN>,    // EP1 IN  Bulk: BOT Bulk-In
+  bEndpointAddress<1,epDIR::OUT> >; // EP1 OUT Bulk: BOT Bulk-Out
+
 //==============================================================================
 // MSD Configuration Descriptor
 //==============================================================================
@@ -61,24 +76,51 @@ constexpr DEVICE_CONFIGURATION_DESCRIPTOR
   bmAttributes<cfg_Attr::SelfPowered>,  // Self powered
   bMaxPower<100/2>,                     // 100 mA
   
-  INTERFACE                    // Interface 0
-  < bInterfaceNumber<0>,
-    bAlternateSetting<0>,
-    bInterfaceClass<8>,        // MSC Class
-    bInterfaceSubClass<6>,     // SCSI transparent
-    bInterfaceProtocol<0x50>,  // BULK-ONLY transport
-    iInterface<0>,             // No String Descriptor
-  
-    ENDPOINT_DESCRIPTOR    // EP1 IN Bulk EndPoint
-    < bEndpointAddress<1,epDIR::IN>,
-      bmAttributes<epTYPE::Bulk>,
-      wMaxPacketSize<64>,
-      bInterval<0> >,
-  
-    ENDPOINT_DESCRIPTOR    // EP1 OUT Bulk EndPoint
-    < bEndpointAddress<1,epDIR::OUT>,
-      bmAttributes<epTYPE::Bulk>,
-      wMaxPacketSize<64>,
-      bInterval<0> >
-  >
+  MSD_INTERFACE                // Interface 0: BOT
 > Configuration_Descriptor;
+
+//==============================================================================
+// Проверка раскладки MSC_UAS_INTERFACE: в конфигурацию не входит, пока нет
+// движка UAS. Alt 0 - BOT, alt 1 - UAS: Command, Status, Data-In, Data-Out,
+// за каждой точкой Pipe Usage (UAS 1.0, 5.3.3)
+//==============================================================================
+using MSD_UAS_INTERFACE = MSC_UAS_INTERFACE
+< bInterfaceNumber<0>,
+  USB_SPEED::FULL,
+  bEndpointAddress<1,epDIR::IN>,    // Data-In
+  bEndpointAddress<1,epDIR::OUT>,   // Data-Out
+  bEndpointAddress<2,epDIR::IN>,    // Status
+  bEndpointAddress<2,epDIR::OUT> >; // Command
+
+constexpr uint8_t UasLayout[]
+{
+  0x09, 0x04, 0x00, 0x00, 0x02, 0x08, 0x06, 0x50, 0x00,
+  0x07, 0x05, 0x81, 0x02, 0x40, 0x00, 0x00,
+  0x07, 0x05, 0x01, 0x02, 0x40, 0x00, 0x00,
+  0x09, 0x04, 0x00, 0x01, 0x04, 0x08, 0x06, 0x62, 0x00,
+  0x07, 0x05, 0x02, 0x02, 0x40, 0x00, 0x00,  0x04, 0x24, 0x01, 0x00,
+  0x07, 0x05, 0x82, 0x02, 0x40, 0x00, 0x00,  0x04, 0x24, 0x02, 0x00,
+  0x07, 0x05, 0x81, 0x02, 0x40, 0x00, 0x00,  0x04, 0x24, 0x03, 0x00,
+  0x07, 0x05, 0x01, 0x02, 0x40, 0x00, 0x00,  0x04, 0x24, 0x04, 0x00,
+};
+
+constexpr bool UasLayoutMatches()
+{
+  constexpr MSD_UAS_INTERFACE uas;
+  if (sizeof(uas.buf) != sizeof(UasLayout)) return false;
+  for (size_t i = 0; i < sizeof(UasLayout); ++i)
+    if (uas.buf[i] != UasLayout[i]) return false;
+  return true;
+}
+
+static_assert(UasLayoutMatches(), "MSC_UAS_INTERFACE layout mismatch");
+static_assert(MSD_UAS_INTERFACE::InterfacesCount() == 1, "UAS is an alternate setting of one interface");
+
+//==============================================================================
+// Personality
+//==============================================================================
+constexpr GATHER_LIST Configurations[] { GatherList<Configuration_Descriptor>() };
+
+constexpr USB_PERSONALITY Personality { Device_Descriptor.buf, Configurations, descr_table, std::size(descr_table) };
+
+} // namespace MSD_PROFILE
@@ -0,0 +1,125 @@
+#pragma once
+
+#if (__cplusplus > 201703L)
+#include "C++20/usb_descriptors.hpp"
+#else
+#include "C++17/usb_descriptors.h"
+#endif
+#include "usb_common_strings.hpp"
+
+namespace NCM_PROFILE
+{
+
+using USB_COMMON_STRINGS::StringLangID;
+using USB_COMMON_STRINGS::StringVendor;
+STRING_DESCRIPTOR( 2, StringProduct,   u"STM32 USB Ethernet"    );
+STRING_DESCRIPTOR( 3, StringSerial,    u"00000000001F"          );
+STRING_DESCRIPTOR( 4, StringMAC,       u"02DEADBEEF01"          ); // локально администрируемый MAC хоста
+
+inline const uint8_t * const descr_table[] =
+{
+  (uint8_t *)&StringLangID,
+  (uint8_t *)&StringVendor,
+  (uint8_t *)&StringProduct,
+  (uint8_t *)&StringSerial,
+  (uint8_t *)&StringMAC
+};
+
+using namespace USB_DESCRIPTORS;
+
+//==============================================================================
+// CDC NCM Ethernet: NTB 16 кБ, кратный 512 байтам HS bulk
+//==============================================================================
+using NCM_ETH = CDC_NCM_FUNCTION
+< bInterfaceNumber<0>,               // Communication Interface
+  bInterfaceNumber<1>,               // Data Interface (alt 0, alt 1)
+  USB_SPEED::HIGH,
+  4,                                 // iMACAddress
+  bEndpointAddress<2, epDIR::IN>,    // EP2 IN  Interrupt Notification
+  bEndpointAddress<1, epDIR::OUT>,   // EP1 OUT Bulk
+  bEndpointAddress<1, epDIR::IN>,    // EP1 IN  Bulk
+  NCM_NTB_PARAMETERS<USB_SPEED::HIGH, 16384, 16384> >;
+
+constexpr NCM_ETH::NTB_PARAMETERS Ntb_Parameters;
+
+//==============================================================================
+// CDC ECM Ethernet: для хостов без драйвера NCM, те же интерфейсы и точки
+//==============================================================================
+using ECM_ETH = CDC_ECM_FUNCTION
+< bInterfaceNumber<0>,
+  bInterfaceNumber<1>,
+  USB_SPEED::HIGH,
+  4,
+  bEndpointAddress<2, epDIR::IN>,
+  bEndpointAddress<1, epDIR::OUT>,
+  bEndpointAddress<1, epDIR::IN> >;
+
+//==============================================================================
+// Configuration 1 - NCM, Configuration 2 - ECM
+//==============================================================================
+using NCM_CONFIGURATION = DEVICE_CONFIGURATION_DESCRIPTOR
+< bConfigurationValue<1>,               // Configuration 1
+  iConfiguration<0>,                    // No String Descriptor
+  bmAttributes<cfg_Attr::SelfPowered>,  // Self powered
+  bMaxPower<100/2>,                     // 100 mA
+
+  NCM_ETH >;
+
+using ECM_CONFIGURATION = DEVICE_CONFIGURATION_DESCRIPTOR
+< bConfigurationValue<2>,               // Configuration 2
+  iConfiguration<0>,                    // No String Descriptor
+  bmAttributes<cfg_Attr::SelfPowered>,  // Self powered
+  bMaxPower<100/2>,                     // 100 mA
+
+  ECM_ETH >;
+
+using CONFIGURATIONS = DEVICE_CONFIGURATIONS
+< 0x80,       // буферы точек после EP0 IN/OUT
+  0x1000,     // 4 кБ памяти пакетов
+  NCM_CONFIGURATION,
+  ECM_CONFIGURATION >;
+
+constexpr NCM_CONFIGURATION Configuration_Descriptor;
+
+static_assert(PERIODIC_BANDWIDTH<NCM_CONFIGURATION, USB_SPEED::HIGH>::Fits() &&
+              PERIODIC_BANDWIDTH<ECM_CONFIGURATION, USB_SPEED::HIGH>::Fits(),
+              "Periodic bandwidth exceeded");
+
+//==============================================================================
+// Device Descriptor
+//==============================================================================
+constexpr DEVICE_DESCRIPTOR
+< bcdUSB<0x02'00>,       // версия usb 2.0
+  bDeviceClass<0xEF>,    // Miscellaneous Device Class
+  bDeviceSubClass<2>,    // Common Class
+  bDeviceProtocol<1>,    // Interface Association Descriptor
+  bMaxPacketSize0<64>,
+  idVendor<0x0483>,      // VID
+  idProduct<0x5750>,     // PID
+  bcdDevice<0x0200>,
+  iManufacturer<1>,
+  iProduct<2>,
+  iSerialNumber<3>,
+  CONFIGURATIONS::NUM_CONFIGURATIONS
+> Device_Descriptor;
+
+//==============================================================================
+// Device Qualifier Descriptor
+//==============================================================================
+constexpr DEVICE_QUALIFIER_DESCRIPTOR
+< bcdUSB<0x02'00>,       // версия usb 2.0
+  bDeviceClass<0xEF>,    // Miscellaneous Device Class
+  bDeviceSubClass<2>,    // Common Class
+  bDeviceProtocol<1>,    // Interface Association Descriptor
+  bMaxPacketSize0<64>,
+  bNumConfigurations<0>
+> Device_Qualifier_Descriptor;
+
+//==============================================================================
+// Personality
+//==============================================================================
+constexpr GATHER_LIST Configurations[] { CONFIGURATIONS::Descriptor(0), CONFIGURATIONS::Descriptor(1) };
+
+constexpr USB_PERSONALITY Personality { Device_Descriptor.buf, Configurations, descr_table, std::size(descr_table) };
+
+} // namespace NCM_PROFILE
@@ -0,0 +1,23 @@
+#pragma once
+
+//==============================================================================
+// Один образ прошивки - несколько личностей устройства. Профили живут в своих
+// пространствах имен, выбор при старте или перед повторным подключением - 
+// индекс в таблице Personalities
+//==============================================================================
+#include "usb_hid_descriptors.hpp"
+#include "usb_cdc_descriptors.hpp"
+#include "usb_winusb_descriptors.hpp"
+#include "usb_msd_descriptors.hpp"
+
+enum class PERSONALITY : uint8_t { Hid, Cdc, WinUsb, Msd, Count };
+
+constexpr USB_DESCRIPTORS::USB_PERSONALITY Personalities[] =
+{
+  HID_PROFILE::Personality,
+  CDC_PROFILE::Personality,
+  WINUSB_PROFILE::Personality,
+  MSD_PROFILE::Personality
+};
+
+static_assert(std::size(Personalities) == (size_t)PERSONALITY::Count, "Personality table mismatch");
@@ -0,0 +1,113 @@
+#pragma once
+
+#if (__cplusplus > 201703L)
+#include "C++20/usb_descriptors.hpp"
+#else
+#include "C++17/usb_descriptors.h"
+#endif
+#include "usb_common_strings.hpp"
+
+namespace UAC2_PROFILE
+{
+
+using USB_COMMON_STRINGS::StringLangID;
+using USB_COMMON_STRINGS::StringVendor;
+STRING_DESCRIPTOR( 2, StringProduct,   u"STM32 USB Audio 2.0"   );
+STRING_DESCRIPTOR( 3, StringSerial,    u"00000000001D"          );
+
+inline const uint8_t * const descr_table[] =
+{
+  (uint8_t *)&StringLangID,
+  (uint8_t *)&StringVendor,
+  (uint8_t *)&StringProduct,
+  (uint8_t *)&StringSerial
+};
+
+using namespace USB_DESCRIPTORS;
+
+//==============================================================================
+// Device Descriptor
+//==============================================================================
+constexpr DEVICE_DESCRIPTOR
+< bcdUSB<0x02'00>,       // версия usb 2.0
+  bDeviceClass<0xEF>,    // Miscellaneous Device Class
+  bDeviceSubClass<2>,    // Common Class
+  bDeviceProtocol<1>,    // Interface Association Descriptor
+  bMaxPacketSize0<64>,
+  idVendor<0x0483>,      // VID
+  idProduct<0x5730>,     // PID
+  bcdDevice<0x0200>,
+  iManufacturer<1>,
+  iProduct<2>,
+  iSerialNumber<3>,
+  bNumConfigurations<1>
+> Device_Descriptor;
+
+//==============================================================================
+// Device Qualifier Descriptor
+//==============================================================================
+constexpr DEVICE_QUALIFIER_DESCRIPTOR
+< bcdUSB<0x02'00>,       // версия usb 2.0
+  bDeviceClass<0xEF>,    // Miscellaneous Device Class
+  bDeviceSubClass<2>,    // Common Class
+  bDeviceProtocol<1>,    // Interface Association Descriptor
+  bMaxPacketSize0<64>,
+  bNumConfigurations<0>
+> Device_Qualifier_Descriptor;
+
+//==============================================================================
+// UAC2 Speaker: USB Streaming -> Feature Unit -> Speaker, 192 кГц / 24 бит
+//==============================================================================
+struct SPK_CLOCK;   // Метки сущностей Audio Control, ID назначаются автоматически
+struct SPK_USB_IT;
+struct SPK_FU;
+struct SPK_OT;
+
+using SPK_FORMAT = UAC2_FORMAT<USB_SPEED::HIGH, 192'000, 2, 4, 24>; // 200 байт/микрокадр
+
+using SPK_AC = UAC2_AC_INTERFACE
+< bInterfaceNumber<0>,
+  iInterface<0>,
+  UAC2_CATEGORY::DESKTOP_SPEAKER,
+
+  UAC2_CLOCK_SOURCE<SPK_CLOCK, UAC2_CLOCK::InternalProgrammable>,
+  UAC2_INPUT_TERMINAL<SPK_USB_IT, UAC2_TERMINAL::USB_STREAMING, SPK_CLOCK, SPK_FORMAT::Channels()>,
+  UAC2_FEATURE_UNIT<SPK_FU, SPK_USB_IT, SPK_FORMAT::Channels()>,
+  UAC2_OUTPUT_TERMINAL<SPK_OT, UAC2_TERMINAL::SPEAKER, SPK_FU, SPK_CLOCK>
+>;
+
+constexpr DEVICE_CONFIGURATION_DESCRIPTOR
+< bConfigurationValue<1>,               // Configuration 1
+  iConfiguration<0>,                    // No String Descriptor
+  bmAttributes<cfg_Attr::SelfPowered>,  // Self powered
+  bMaxPower<100/2>,                     // 100 mA
+
+  INTERFACE_ASSOCIATION
+  < bFunctionClass<1>,          // Audio
+    bFunctionSubClass<0>,
+    bFunctionProtocol<0x20>,    // AF_VERSION_02_00
+    iFunction<0>,
+
+    SPK_AC,                     // Interface 0 - Audio Control
+
+    UAC2_AS_INTERFACE           // Interface 1 - Audio Streaming (alt 0, alt 1)
+    < SPK_AC,
+      SPK_USB_IT,
+      bInterfaceNumber<1>,
+      SPK_FORMAT,
+      bEndpointAddress<1, epDIR::OUT>,  // EP1 OUT Isochronous Data
+      bEndpointAddress<1, epDIR::IN> >  // EP1 IN  Isochronous Feedback
+  >
+> Configuration_Descriptor;
+
+static_assert(PERIODIC_BANDWIDTH<decltype(Configuration_Descriptor), USB_SPEED::HIGH>::Fits(),
+              "Periodic bandwidth exceeded");
+
+//==============================================================================
+// Personality
+//==============================================================================
+constexpr GATHER_LIST Configurations[] { GatherList<Configuration_Descriptor>() };
+
+constexpr USB_PERSONALITY Personality { Device_Descriptor.buf, Configurations, descr_table, std::size(descr_table) };
+
+} // namespace UAC2_PROFILE
@@ -0,0 +1,118 @@
+#pragma once
+
+#if (__cplusplus > 201703L)
+#include "C++20/usb_descriptors.hpp"
+#else
+#include "C++17/usb_descriptors.h"
+#endif
+#include "usb_common_strings.hpp"
+
+namespace UVC_PROFILE
+{
+
+using USB_COMMON_STRINGS::StringLangID;
+using USB_COMMON_STRINGS::StringVendor;
+STRING_DESCRIPTOR( 2, StringProduct,   u"STM32 USB Video"       );
+STRING_DESCRIPTOR( 3, StringSerial,    u"00000000001E"          );
+
+inline const uint8_t * const descr_table[] =
+{
+  (uint8_t *)&StringLangID,
+  (uint8_t *)&StringVendor,
+  (uint8_t *)&StringProduct,
+  (uint8_t *)&StringSerial
+};
+
+using namespace USB_DESCRIPTORS;
+
+//==============================================================================
+// Device Descriptor
+//==============================================================================
+constexpr DEVICE_DESCRIPTOR
+< bcdUSB<0x02'00>,       // версия usb 2.0
+  bDeviceClass<0xEF>,    // Miscellaneous Device Class
+  bDeviceSubClass<2>,    // Common Class
+  bDeviceProtocol<1>,    // Interface Association Descriptor
+  bMaxPacketSize0<64>,
+  idVendor<0x0483>,      // VID
+  idProduct<0x5760>,     // PID
+  bcdDevice<0x0200>,
+  iManufacturer<1>,
+  iProduct<2>,
+  iSerialNumber<3>,
+  bNumConfigurations<1>
+> Device_Descriptor;
+
+//==============================================================================
+// Device Qualifier Descriptor
+//==============================================================================
+constexpr DEVICE_QUALIFIER_DESCRIPTOR
+< bcdUSB<0x02'00>,       // версия usb 2.0
+  bDeviceClass<0xEF>,    // Miscellaneous Device Class
+  bDeviceSubClass<2>,    // Common Class
+  bDeviceProtocol<1>,    // Interface Association Descriptor
+  bMaxPacketSize0<64>,
+  bNumConfigurations<0>
+> Device_Qualifier_Descriptor;
+
+//==============================================================================
+// UVC Camera: Camera -> Processing Unit -> USB Streaming, YUY2 и MJPEG
+//==============================================================================
+struct CAM_IT;      // Метки сущностей Video Control, ID назначаются автоматически
+struct CAM_PU;
+struct CAM_OT;
+
+using CAM_VC = UVC_VC_INTERFACE
+< bInterfaceNumber<0>,
+  iInterface<0>,
+  48'000'000,                   // dwClockFrequency, Гц
+  bInterfaceNumber<1>,          // Video Streaming интерфейс
+
+  UVC_CAMERA_TERMINAL<CAM_IT>,
+  UVC_PROCESSING_UNIT<CAM_PU, CAM_IT>,
+  UVC_OUTPUT_TERMINAL<CAM_OT, CAM_PU>
+>;
+
+constexpr DEVICE_CONFIGURATION_DESCRIPTOR
+< bConfigurationValue<1>,               // Configuration 1
+  iConfiguration<0>,                    // No String Descriptor
+  bmAttributes<cfg_Attr::SelfPowered>,  // Self powered
+  bMaxPower<100/2>,                     // 100 mA
+
+  INTERFACE_ASSOCIATION
+  < bFunctionClass<0x0E>,       // Video
+    bFunctionSubClass<0x03>,    // SC_VIDEO_INTERFACE_COLLECTION
+    bFunctionProtocol<0>,
+    iFunction<0>,
+
+    CAM_VC,                     // Interface 0 - Video Control
+
+    UVC_VS_INTERFACE            // Interface 1 - Video Streaming (alt 0...N)
+    < CAM_VC,
+      CAM_OT,
+      bInterfaceNumber<1>,
+      USB_SPEED::HIGH,
+      UVC_TRANSFER::Isochronous,
+      bEndpointAddress<1, epDIR::IN>,  // EP1 IN Isochronous Video
+
+      UVC_FORMAT_UNCOMPRESSED<UVC_FOURCC::YUY2, 16,
+        UVC_FRAME<160, 120, 30, 15>,
+        UVC_FRAME<320, 240, 30, 15>,
+        UVC_FRAME<640, 480, 30, 15> >,
+      UVC_FORMAT_MJPEG<4,               // сжатие ~4:1 к YUY2
+        UVC_FRAME<640, 480, 30>,
+        UVC_FRAME<1280, 720, 30> > >
+  >
+> Configuration_Descriptor;
+
+static_assert(PERIODIC_BANDWIDTH<decltype(Configuration_Descriptor), USB_SPEED::HIGH>::Fits(),
+              "Periodic bandwidth exceeded");
+
+//==============================================================================
+// Personality
+//==============================================================================
+constexpr GATHER_LIST Configurations[] { GatherList<Configuration_Descriptor>() };
+
+constexpr USB_PERSONALITY Personality { Device_Descriptor.buf, Configurations, descr_table, std::size(descr_table) };
+
+} // namespace UVC_PROFILE
@@ -5,9 +5,13 @@
 #else
 #include "C++17/usb_descriptors.h"
 #endif 
+#include "usb_common_strings.hpp"
 
-STRING_DESCRIPTOR(0, StringLangID,    u"\x0409"                );
-STRING_DESCRIPTOR(1, StringVendor,    u"STMicroelectronics"    );
+namespace WINUSB_PROFILE
+{
+
+using USB_COMMON_STRINGS::StringLangID;
+using USB_COMMON_STRINGS::StringVendor;
 STRING_DESCRIPTOR(2, StringProduct,   u"STM32 Custom WINUSB"   );
 STRING_DESCRIPTOR(3, StringSerial,    u"00000000001B"          );
 STRING_DESCRIPTOR(0xEE, StringMSOSSD, u"MSFT100\x0000"         );   //Microsoft OS String Descriptor
@@ -54,6 +58,18 @@ constexpr DEVICE_QUALIFIER_DESCRIPTOR
 > Device_Qualifier_Descriptor;
 
 
+//==============================================================================
+// WINUSB Interface: поток делится на полосы по 3 парам Bulk точек EP1..EP3
+//==============================================================================
+using WINUSB_INTERFACE = VENDOR_BULK_INTERFACE
+< bInterfaceNumber<0>,
+  USB_SPEED::FULL,
+  3,              // пары EP1 IN/OUT, EP2 IN/OUT, EP3 IN/OUT
+  1,              // первая пара - EP1
+  4096 >;         // байт подряд в одну пару
+
+constexpr WINUSB_INTERFACE::STRIPE_INFO Stripe_Info;
+
 //==============================================================================
 // WINUSB Configuration Descriptor
 //==============================================================================
@@ -63,26 +79,7 @@ constexpr DEVICE_CONFIGURATION_DESCRIPTOR
   bmAttributes<cfg_Attr::SelfPowered>,  // Self powered
   bMaxPower<100/2>,                     // 100 mA
   
-  INTERFACE       // Interface 0
-  < bInterfaceNumber<0>,
-    bAlternateSetting<0>,
-    bInterfaceClass<0xFF>,     // Vendor Specified
-    bInterfaceSubClass<0xFF>,  //
-    bInterfaceProtocol<0xFF>,  //
-    iInterface<0>,             // No String Descriptor
-  
-    ENDPOINT_DESCRIPTOR    // EP1 IN Bulk EndPoint
-    < bEndpointAddress<1,epDIR::IN>,
-      bmAttributes<epTYPE::Bulk>,
-      wMaxPacketSize<64>,
-      bInterval<0> >,
-  
-    ENDPOINT_DESCRIPTOR    // EP1 OUT Bulk EndPoint
-    < bEndpointAddress<1,epDIR::OUT>,
-      bmAttributes<epTYPE::Bulk>,
-      wMaxPacketSize<64>,
-      bInterval<0> >
-  >
+  WINUSB_INTERFACE                      // Interface 0
 > Configuration_Descriptor;
 
 constexpr WINUSB_COMPATIBLE_ID_FEATURE_DESCRIPTOR WINUSBCompatibleID =
@@ -93,4 +90,36 @@ constexpr WINUSB_COMPATIBLE_ID_FEATURE_DESCRIPTOR WINUSBCompatibleID =
   .bSections        = 1,
   .bReserv2         = 1,
   .IDString         = "WINUSB\0"
-};
\ No newline at end of file
+};
+
+//==============================================================================
+// Тот же интерфейс на Linux гаджете: FunctionFS, FS и HS
+//==============================================================================
+// Строки FunctionFS нумеруются с 1 в своем блоке: iInterface<1> - Ffs_Strings
+constexpr FUNCTIONFS_DESCRIPTORS
+< VENDOR_BULK_INTERFACE                 // FS - как на контроллере
+  < bInterfaceNumber<0>,
+    USB_SPEED::FULL,
+    3,
+    1,
+    4096,
+    iInterface<1> >,
+  VENDOR_BULK_INTERFACE                 // HS - пакеты по 512 байт
+  < bInterfaceNumber<0>,
+    USB_SPEED::HIGH,
+    3,
+    1,
+    4096,
+    iInterface<1> >
+> Ffs_Descriptors;
+
+constexpr FUNCTIONFS_STRINGS Ffs_Strings { 0x0409, "STM32 Custom WINUSB" };
+
+//==============================================================================
+// Personality
+//==============================================================================
+constexpr GATHER_LIST Configurations[] { GatherList<Configuration_Descriptor>() };
+
+constexpr USB_PERSONALITY Personality { Device_Descriptor.buf, Configurations, descr_table, std::size(descr_table) };
+
+} // namespace WINUSB_PROFILE
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+//==============================================================================
+// Блочное устройство на файле образа (Linux, mmap) для MSC::BOT
+// Файл создается/расширяется до blocks * block_size; blocks = 0 - размер файла
+//==============================================================================
+template<uint32_t block_size = 512>
+class MMAP_BLOCK_DEVICE
+{
+public:
+  static constexpr uint32_t BlockSize = block_size;
+
+  MMAP_BLOCK_DEVICE(const char* path, uint64_t blocks = 0, bool read_only = false)
+    : write_protected(read_only)
+  {
+    fd = open(path, read_only ? O_RDONLY : (O_RDWR | O_CREAT), 0644);
+    if (fd < 0) return;
+    struct stat st;
+    if (fstat(fd, &st) < 0) return;
+    uint64_t size = blocks ? blocks * block_size : uint64_t(st.st_size) / block_size * block_size;
+    if (!read_only && (uint64_t(st.st_size) < size) && (ftruncate(fd, off_t(size)) < 0)) return;
+    if (!size) return;
+    void* p = mmap(nullptr, size, read_only ? PROT_READ : (PROT_READ | PROT_WRITE), MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) return;
+    image = static_cast<uint8_t*>(p);
+    count = size / block_size;
+  }
+
+  ~MMAP_BLOCK_DEVICE()
+  {
+    if (image) munmap(image, count * block_size);
+    if (fd >= 0) close(fd);
+  }
+
+  MMAP_BLOCK_DEVICE(const MMAP_BLOCK_DEVICE&) = delete;
+  MMAP_BLOCK_DEVICE& operator=(const MMAP_BLOCK_DEVICE&) = delete;
+
+  bool IsOpen() const { return image != nullptr; }
+  uint64_t BlockCount() const { return count; }
+  bool IsWriteProtected() const { return write_protected; }
+
+  bool Read(uint64_t lba, uint8_t* buf, uint32_t n)
+  {
+    if (!InRange(lba, n)) return false;
+    memcpy(buf, image + lba * block_size, size_t(n) * block_size);
+    return true;
+  }
+
+  bool Write(uint64_t lba, const uint8_t* buf, uint32_t n)
+  {
+    if (write_protected || !InRange(lba, n)) return false;
+    memcpy(image + lba * block_size, buf, size_t(n) * block_size);
+    return true;
+  }
+
+  // SYNCHRONIZE CACHE
+  bool Flush() { return !image || (msync(image, count * block_size, MS_SYNC) == 0); }
+
+private:
+  bool InRange(uint64_t lba, uint32_t n) const { return image && (lba <= count) && (n <= count - lba); }
+
+  int fd = -1;
+  uint8_t* image = nullptr;
+  uint64_t count = 0;
+  bool write_protected;
+};
@@ -0,0 +1,350 @@
+#pragma once
+
+#include <stdint.h>
+
+#if (__cplusplus > 201703L)
+#include "../Descriptors/C++20/usb_descriptors.hpp"
+#else
+#include "../Descriptors/C++17/usb_descriptors.h"
+#endif
+
+//==============================================================================
+// Обратное направление: разбор готовых байтов конфигурации
+// Представления (view) ссылаются на исходный буфер, ничего не копируют и не
+// выделяют; поле за пределами bLength читается как 0. Все constexpr - проверка
+// Configuration_Descriptor.buf возможна в static_assert
+//==============================================================================
+// for (auto d : USB_VIEW::CONFIGURATION_BLOB(buf, size))      все дескрипторы
+// for (auto ep : USB_VIEW::Descriptors<USB_VIEW::EndpointView>(buf, size))
+// Validate(buf, size) - wTotalLength, bNumInterfaces, bNumEndpoints, длины
+//==============================================================================
+namespace USB_VIEW
+{
+
+//==============================================================================
+// Любой дескриптор + интерфейс, внутри которого он лежит (для class-specific)
+//==============================================================================
+class DescriptorView
+{
+public:
+  constexpr DescriptorView(const uint8_t* p = nullptr, const uint8_t* owner = nullptr) : p(p), owner(owner) {}
+
+  constexpr uint8_t Length() const { return p[0]; }
+  constexpr DescriptorType Type() const { return DescriptorType(p[1]); }
+  constexpr const uint8_t* Data() const { return p; }
+
+  constexpr uint8_t U8(uint8_t offset) const { return (offset < p[0]) ? p[offset] : 0; }
+  constexpr uint16_t U16(uint8_t offset) const { return uint16_t(U8(offset) | (U8(offset + 1) << 8)); }
+
+  // Interface Descriptor, к которому относится дескриптор (nullptr - до первого)
+  constexpr const uint8_t* Owner() const { return owner; }
+
+protected:
+  const uint8_t* p;
+  const uint8_t* owner;
+};
+
+//==============================================================================
+// Стандартные дескрипторы
+//==============================================================================
+class ConfigurationView : public DescriptorView
+{
+public:
+  constexpr ConfigurationView(DescriptorView d) : DescriptorView(d) {}
+  static constexpr bool Match(DescriptorView d) { return (d.Type() == DescriptorType::CONFIGURATION) && (d.Length() >= 9); }
+
+  constexpr uint16_t TotalLength() const { return U16(2); }
+  constexpr uint8_t NumInterfaces() const { return U8(4); }
+  constexpr uint8_t ConfigurationValue() const { return U8(5); }
+  constexpr uint8_t ConfigurationString() const { return U8(6); }
+  constexpr uint8_t Attributes() const { return U8(7); }
+  constexpr uint16_t MaxPower_mA() const { return U8(8) * 2; }
+};
+
+class InterfaceView : public DescriptorView
+{
+public:
+  constexpr InterfaceView(DescriptorView d) : DescriptorView(d) {}
+  static constexpr bool Match(DescriptorView d) { return (d.Type() == DescriptorType::INTERFACE) && (d.Length() >= 9); }
+
+  constexpr uint8_t Number() const { return U8(2); }
+  constexpr uint8_t AlternateSetting() const { return U8(3); }
+  constexpr uint8_t NumEndpoints() const { return U8(4); }
+  constexpr uint8_t Class() const { return U8(5); }
+  constexpr uint8_t SubClass() const { return U8(6); }
+  constexpr uint8_t Protocol() const { return U8(7); }
+  constexpr uint8_t InterfaceString() const { return U8(8); }
+};
+
+class EndpointView : public DescriptorView
+{
+public:
+  constexpr EndpointView(DescriptorView d) : DescriptorView(d) {}
+  static constexpr bool Match(DescriptorView d) { return (d.Type() == DescriptorType::ENDPOINT) && (d.Length() >= 7); }
+
+  constexpr uint8_t Address() const { return U8(2); }
+  constexpr bool IsIn() const { return U8(2) & 0x80; }
+  constexpr uint8_t Attributes() const { return U8(3); }
+  constexpr USB_DESCRIPTORS::epTYPE TransferType() const { return USB_DESCRIPTORS::epTYPE(U8(3) & 0x03); }
+  constexpr uint16_t MaxPacketSize() const { return U16(4) & 0x7FF; }
+  constexpr uint8_t Transactions() const { return uint8_t(((U16(4) >> 11) & 0x03) + 1); }  // HS high-bandwidth
+  constexpr uint8_t Interval() const { return U8(6); }
+};
+
+class InterfaceAssociationView : public DescriptorView
+{
+public:
+  constexpr InterfaceAssociationView(DescriptorView d) : DescriptorView(d) {}
+  static constexpr bool Match(DescriptorView d)
+  {
+    return (d.Type() == DescriptorType::INTERFACE_ASSOCIATION) && (d.Length() >= 8);
+  }
+
+  constexpr uint8_t FirstInterface() const { return U8(2); }
+  constexpr uint8_t InterfaceCount() const { return U8(3); }
+  constexpr uint8_t FunctionClass() const { return U8(4); }
+  constexpr uint8_t FunctionSubClass() const { return U8(5); }
+  constexpr uint8_t FunctionProtocol() const { return U8(6); }
+};
+
+//==============================================================================
+// Class-specific: bDescriptorSubType имеет смысл только вместе с классом
+// интерфейса (CS_INTERFACE 6 - Union у CDC и Feature Unit у Audio)
+//==============================================================================
+class ClassSpecificView : public DescriptorView
+{
+public:
+  constexpr ClassSpecificView(DescriptorView d) : DescriptorView(d) {}
+  static constexpr bool Match(DescriptorView d)
+  {
+    return ((d.Type() == DescriptorType::CS_INTERFACE) || (d.Type() == DescriptorType::CS_ENDPOINT)) && (d.Length() >= 3);
+  }
+
+  constexpr uint8_t SubType() const { return U8(2); }
+  constexpr uint8_t InterfaceClass() const { return owner ? owner[5] : 0; }
+};
+
+template<uint8_t if_class, uint8_t subtype, uint8_t min_length>
+class CS_INTERFACE_VIEW : public ClassSpecificView
+{
+public:
+  constexpr CS_INTERFACE_VIEW(DescriptorView d) : ClassSpecificView(d) {}
+  static constexpr bool Match(DescriptorView d)
+  {
+    ClassSpecificView cs(d);
+    return (d.Type() == DescriptorType::CS_INTERFACE) && (d.Length() >= min_length) &&
+           (cs.InterfaceClass() == if_class) && (cs.SubType() == subtype);
+  }
+};
+
+// CDC 1.2, Table 13
+class CdcHeaderView : public CS_INTERFACE_VIEW<0x02, 0x00, 5>
+{
+public:
+  using CS_INTERFACE_VIEW::CS_INTERFACE_VIEW;
+  constexpr uint16_t bcdCDC() const { return U16(3); }
+};
+
+class CdcCallManagementView : public CS_INTERFACE_VIEW<0x02, 0x01, 5>
+{
+public:
+  using CS_INTERFACE_VIEW::CS_INTERFACE_VIEW;
+  constexpr uint8_t Capabilities() const { return U8(3); }
+  constexpr uint8_t DataInterface() const { return U8(4); }
+};
+
+class CdcAcmView : public CS_INTERFACE_VIEW<0x02, 0x02, 4>
+{
+public:
+  using CS_INTERFACE_VIEW::CS_INTERFACE_VIEW;
+  constexpr uint8_t Capabilities() const { return U8(3); }
+};
+
+class CdcUnionView : public CS_INTERFACE_VIEW<0x02, 0x06, 5>
+{
+public:
+  using CS_INTERFACE_VIEW::CS_INTERFACE_VIEW;
+  constexpr uint8_t ControlInterface() const { return U8(3); }
+  constexpr uint8_t SubordinateCount() const { return uint8_t(Length() - 4); }
+  constexpr uint8_t SubordinateInterface(uint8_t i) const { return U8(4 + i); }
+};
+
+class CdcEthernetView : public CS_INTERFACE_VIEW<0x02, 0x0F, 13>
+{
+public:
+  using CS_INTERFACE_VIEW::CS_INTERFACE_VIEW;
+  constexpr uint8_t MACAddressString() const { return U8(3); }
+  constexpr uint32_t EthernetStatistics() const { return U16(4) | (uint32_t(U16(6)) << 16); }
+  constexpr uint16_t MaxSegmentSize() const { return U16(8); }
+  constexpr uint16_t NumberMCFilters() const { return U16(10); }
+  constexpr uint8_t NumberPowerFilters() const { return U8(12); }
+};
+
+//==============================================================================
+// Обход: итератор по дескрипторам, останавливается на битой длине
+//==============================================================================
+class DescriptorIterator
+{
+public:
+  constexpr DescriptorIterator(const uint8_t* p, const uint8_t* end) : p(p), end(end), owner(nullptr) { Check(); }
+
+  constexpr DescriptorView operator*() const { return DescriptorView(p, owner); }
+  constexpr DescriptorIterator& operator++()
+  {
+    if (InterfaceView::Match(DescriptorView(p))) owner = p;
+    p += p[0];
+    Check();
+    return *this;
+  }
+  constexpr bool operator!=(const DescriptorIterator& x) const { return p != x.p; }
+  constexpr bool operator==(const DescriptorIterator& x) const { return p == x.p; }
+
+private:
+  // Хвост короче заголовка или bLength за пределами буфера - конец обхода
+  constexpr void Check()
+  {
+    if ((end - p < 2) || (p[0] < 2) || (p[0] > end - p)) p = end;
+  }
+
+  const uint8_t* p;
+  const uint8_t* end;
+  const uint8_t* owner;
+};
+
+class CONFIGURATION_BLOB
+{
+public:
+  constexpr CONFIGURATION_BLOB(const uint8_t* data, uint16_t size) : data(data), size(size) {}
+
+  constexpr DescriptorIterator begin() const { return DescriptorIterator(data, data + size); }
+  constexpr DescriptorIterator end() const { return DescriptorIterator(data + size, data + size); }
+
+private:
+  const uint8_t* data;
+  uint16_t size;
+};
+
+// Только дескрипторы, подходящие под TView::Match
+template<typename TView>
+class TYPED_RANGE
+{
+public:
+  class iterator
+  {
+  public:
+    constexpr iterator(DescriptorIterator it, DescriptorIterator end) : it(it), end(end) { Skip(); }
+    constexpr TView operator*() const { return TView(*it); }
+    constexpr iterator& operator++() { ++it; Skip(); return *this; }
+    constexpr bool operator!=(const iterator& x) const { return it != x.it; }
+  private:
+    constexpr void Skip() { while ((it != end) && !TView::Match(*it)) ++it; }
+    DescriptorIterator it, end;
+  };
+
+  constexpr TYPED_RANGE(CONFIGURATION_BLOB blob) : blob(blob) {}
+  constexpr iterator begin() const { return iterator(blob.begin(), blob.end()); }
+  constexpr iterator end() const { return iterator(blob.end(), blob.end()); }
+
+private:
+  CONFIGURATION_BLOB blob;
+};
+
+template<typename TView>
+constexpr TYPED_RANGE<TView> Descriptors(const uint8_t* data, uint16_t size) { return CONFIGURATION_BLOB(data, size); }
+
+//==============================================================================
+// Проверка согласованности
+//==============================================================================
+enum class VIEW_ERROR : uint8_t
+{
+  None,
+  NotConfiguration,      // первый дескриптор - не Configuration
+  TotalLength,           // wTotalLength не равен размеру
+  DescriptorLength,      // bLength < 2, за пределами буфера или короче стандартного
+  NumInterfaces,         // bNumInterfaces не равен числу интерфейсов alt 0
+  NumEndpoints,          // bNumEndpoints не равен числу точек интерфейса
+  EndpointOutsideInterface,
+  DuplicateEndpoint,     // адрес повторяется в одной альтернативной настройке
+  DuplicateInterface     // пара bInterfaceNumber/bAlternateSetting повторяется
+};
+
+struct VALIDATION
+{
+  VIEW_ERROR error;
+  uint16_t offset;       // дескриптор с ошибкой
+
+  constexpr bool Ok() const { return error == VIEW_ERROR::None; }
+};
+
+constexpr VALIDATION Validate(const uint8_t* data, uint16_t size)
+{
+  if ((size < 9) || !ConfigurationView::Match(DescriptorView(data))) return { VIEW_ERROR::NotConfiguration, 0 };
+  ConfigurationView cfg(data);
+  if (cfg.TotalLength() != size) return { VIEW_ERROR::TotalLength, 0 };
+
+  uint32_t if_seen[8]{};       // интерфейсы alt 0, по биту на номер
+  uint32_t eps = 0;            // точки текущей настройки: бит (номер | IN << 4)
+  uint8_t interfaces = 0;
+  uint16_t if_offset = 0;
+  int16_t expected = -1;       // bNumEndpoints текущей настройки, -1 - вне интерфейса
+  uint8_t found = 0;
+
+  uint16_t offset = 0;
+  for (; offset + 2 <= size; offset += data[offset])
+  {
+    DescriptorView d(data + offset);
+    uint8_t len = d.Length();
+    if ((len < 2) || (len > size - offset)) return { VIEW_ERROR::DescriptorLength, offset };
+
+    switch (d.Type())
+    {
+      case DescriptorType::INTERFACE:
+      {
+        if (!InterfaceView::Match(d)) return { VIEW_ERROR::DescriptorLength, offset };
+        if ((expected >= 0) && (found != expected)) return { VIEW_ERROR::NumEndpoints, if_offset };
+        InterfaceView itf(d);
+        // Повтор номера и настройки: та же пара раньше в конфигурации
+        for (uint16_t o = 0; o < offset; o += data[o])
+          if (InterfaceView::Match(DescriptorView(data + o)) && (data[o + 2] == itf.Number()) && (data[o + 3] == itf.AlternateSetting()))
+            return { VIEW_ERROR::DuplicateInterface, offset };
+        if (!itf.AlternateSetting())
+        {
+          uint32_t bit = 1u << (itf.Number() & 31);
+          if (!(if_seen[itf.Number() >> 5] & bit)) { if_seen[itf.Number() >> 5] |= bit; ++interfaces; }
+        }
+        if_offset = offset;
+        expected = itf.NumEndpoints();
+        found = 0;
+        eps = 0;
+        break;
+      }
+      case DescriptorType::ENDPOINT:
+      {
+        if (!EndpointView::Match(d)) return { VIEW_ERROR::DescriptorLength, offset };
+        if (expected < 0) return { VIEW_ERROR::EndpointOutsideInterface, offset };
+        EndpointView ep(d);
+        uint32_t bit = 1u << ((ep.Address() & 0x0F) | (ep.IsIn() ? 0x10 : 0));
+        if (eps & bit) return { VIEW_ERROR::DuplicateEndpoint, offset };
+        eps |= bit;
+        ++found;
+        break;
+      }
+      case DescriptorType::INTERFACE_ASSOCIATION:
+        if (!InterfaceAssociationView::Match(d)) return { VIEW_ERROR::DescriptorLength, offset };
+        break;
+      case DescriptorType::CONFIGURATION:
+        if (offset) return { VIEW_ERROR::NotConfiguration, offset };
+        break;
+      default: break;
+    }
+  }
+  if (offset != size) return { VIEW_ERROR::DescriptorLength, offset };
+  if ((expected >= 0) && (found != expected)) return { VIEW_ERROR::NumEndpoints, if_offset };
+  if (interfaces != cfg.NumInterfaces()) return { VIEW_ERROR::NumInterfaces, 0 };
+  return { VIEW_ERROR::None, 0 };
+}
+
+template<size_t N>
+constexpr VALIDATION Validate(const uint8_t (&buf)[N]) { return Validate(buf, uint16_t(N)); }
+
+} // namespace USB_VIEW
@@ -0,0 +1,281 @@
+#pragma once
+
+#if !defined(__cpp_impl_coroutine)
+#error "Awaitable endpoints require C++20 coroutines"
+#endif
+
+#include <stdint.h>
+#include <span>
+#include <type_traits>
+#include <coroutine>
+
+#include "../Descriptors/C++20/usb_descriptors.hpp"
+#include "usb_trace.hpp"
+
+//==============================================================================
+// Bulk и Interrupt точки конфигурации как объекты с co_await
+//==============================================================================
+// Адрес, направление, тип и wMaxPacketSize берутся из ENDPOINT_DESCRIPTOR,
+// Write() есть только у IN точки, Read() - только у OUT: ошибка направления
+// не компилируется.
+//
+//   USB_EP::ENDPOINTS<decltype(CDC_PROFILE::Configuration_Descriptor), TRANSPORT> eps(transport);
+//   auto& in = eps.Get<0x81>();
+//   int32_t n = co_await in.Write(data);
+//
+// Передача делится на пакеты wMaxPacketSize, Bulk передача кратной длины
+// завершается ZLP (zlp = false - продолжение следует). Write()/Read() ставят
+// передачу в очередь точки сразу, co_await только ждет: несколько передач
+// могут быть в работе одновременно
+//
+//   auto a = out.Read(buf0);
+//   auto b = out.Read(buf1);      // принимается следом за a без паузы
+//   int32_t n0 = co_await a;
+//
+// Результат - число байт или ABORTED (Abort(): сброс шины, смена
+// конфигурации). Read() завершается коротким пакетом или заполнением буфера.
+// Передача (TRANSFER) не должна пережить точку; разрушенная до завершения
+// передача снимается с очереди, ее пакет в работе контроллера отбрасывается.
+//
+// Транспорт (TTransport) - как у EP0::CONTROL:
+//   void Transmit(uint8_t ep, const uint8_t* buf, uint32_t len); -> OnTransmitted(ep)
+//   void Receive(uint8_t ep, uint8_t* buf, uint32_t len);        -> OnReceived(ep, len)
+// Сопрограммы приложения продолжаются внутри OnTransmitted/OnReceived: если
+// события приходят из прерывания, там же выполняется и приложение.
+// TTrace (usb_trace.hpp) пишет конец и снятие каждой передачи
+//==============================================================================
+namespace USB_EP
+{
+
+constexpr int32_t ABORTED = -1;
+
+template<USB_DESCRIPTORS::is_EndpointDescriptor TEp, typename TTransport, typename TTrace = USB_TRACE::NO_TRACE>
+class ENDPOINT
+{
+public:
+  static constexpr uint8_t address = TEp::GetEpAddress();
+  static constexpr bool in = TEp::IsIn();
+  static constexpr USB_DESCRIPTORS::epTYPE type = TEp::GetEpType();
+  static constexpr uint16_t mps = TEp::GetMaxPacketSize() & 0x7FF;
+
+  static_assert((type == USB_DESCRIPTORS::epTYPE::Bulk) || (type == USB_DESCRIPTORS::epTYPE::Interrupt), "Only Bulk and Interrupt endpoints");
+  static_assert(mps, "wMaxPacketSize must not be 0");
+
+  explicit ENDPOINT(TTransport& transport) : transport(transport) {}
+
+  ENDPOINT(const ENDPOINT&) = delete;
+  ENDPOINT& operator=(const ENDPOINT&) = delete;
+
+  class TRANSFER
+  {
+  public:
+    TRANSFER(const TRANSFER&) = delete;
+    TRANSFER& operator=(const TRANSFER&) = delete;
+    ~TRANSFER() { if (!done) owner.Remove(this); }
+
+    bool await_ready() const noexcept { return done; }
+    void await_suspend(std::coroutine_handle<> h) noexcept { waiting = h; }
+    int32_t await_resume() const noexcept { return result; }
+
+    bool Done() const { return done; }
+
+  private:
+    friend class ENDPOINT;
+
+    TRANSFER(ENDPOINT& owner, uint8_t* data, uint32_t size, bool zlp)
+      : owner(owner), data(data), size(size), zlp(zlp) { owner.Push(this); }
+
+    ENDPOINT& owner;
+    uint8_t* data;
+    uint32_t size;
+    uint32_t offset = 0;
+    uint16_t last = 0;          // длина пакета в работе
+    bool zlp;
+    bool done = false;
+    int32_t result = 0;
+    TRANSFER* next = nullptr;
+    std::coroutine_handle<> waiting;
+  };
+
+  [[nodiscard]] TRANSFER Write(std::span<const uint8_t> data, bool zlp = (type == USB_DESCRIPTORS::epTYPE::Bulk)) requires in
+  {
+    return TRANSFER(*this, const_cast<uint8_t*>(data.data()), uint32_t(data.size()), zlp);
+  }
+
+  [[nodiscard]] TRANSFER Read(std::span<uint8_t> data) requires (!in)
+  {
+    return TRANSFER(*this, data.data(), uint32_t(data.size()), false);
+  }
+
+  // Пакет IN отправлен
+  void OnTransmitted() requires in
+  {
+    if (dropped) { dropped = false; return Start(); }
+    TRANSFER* t = head;
+    if (!t) return;
+    t->offset += t->last;
+    if (t->offset < t->size) return Packet(t);
+    if (t->zlp && (t->last == mps)) { t->zlp = false; return Packet(t); }
+    Complete(int32_t(t->size));
+  }
+
+  // Пакет OUT принят
+  void OnReceived(uint32_t len) requires (!in)
+  {
+    if (dropped) { dropped = false; return Start(); }
+    TRANSFER* t = head;
+    if (!t) return;
+    t->offset += len;
+    if ((len == mps) && (t->offset < t->size)) return Packet(t);
+    Complete(int32_t(t->offset));
+  }
+
+  // Передачи очереди завершаются с ABORTED, пакет в работе контроллер
+  // сбрасывает сам. Поставленные из возобновленных сопрограмм - уже новые,
+  // они запускаются после
+  void Abort()
+  {
+    for (TRANSFER* t = head; t; t = t->next) t->result = ABORTED;
+    dropped = true;
+    while (head && (head->result == ABORTED)) Complete(ABORTED, false);
+    dropped = false;
+    Start();
+  }
+
+  bool Busy() const { return head; }
+
+private:
+  void Push(TRANSFER* t)
+  {
+    if (tail) tail->next = t;
+    else head = t;
+    tail = t;
+    if ((head == t) && !dropped) Packet(t);
+  }
+
+  void Remove(TRANSFER* t)
+  {
+    TRANSFER** p = &head;
+    while (*p && (*p != t)) p = &(*p)->next;
+    if (!*p) return;
+    if (t == head) dropped = true;
+    *p = t->next;
+    if (tail == t)
+      for (tail = head; tail && tail->next; tail = tail->next) {}
+  }
+
+  void Packet(TRANSFER* t)
+  {
+    uint32_t left = t->size - t->offset;
+    t->last = uint16_t((left < mps) ? left : mps);
+    if constexpr (in) transport.Transmit(address, t->data + t->offset, t->last);
+    else transport.Receive(address, t->data + t->offset, t->last);
+  }
+
+  void Start() { if (head) Packet(head); }
+
+  // Следующая передача запускается до возобновления сопрограммы: та может
+  // сразу поставить новую или разрушить свою
+  void Complete(int32_t result, bool start = true)
+  {
+    TRANSFER* t = head;
+    head = t->next;
+    if (!head) tail = nullptr;
+    if (start) Start();
+    TTrace::Complete(address, result);
+    std::coroutine_handle<> h = t->waiting;
+    t->result = result;
+    t->done = true;
+    if (h) h.resume();
+  }
+
+  TTransport& transport;
+  TRANSFER* head = nullptr;
+  TRANSFER* tail = nullptr;
+  bool dropped = false;         // пакет в работе принадлежит снятой передаче
+};
+
+//==============================================================================
+// Все Bulk и Interrupt точки конфигурации, по одному объекту на адрес
+//==============================================================================
+// Точка, повторенная в альтернативных настройках, берется по первому
+// объявлению. Isochronous точки пропускаются. События контроллера
+// разводятся по адресу: OnTransmitted(ep), OnReceived(ep, len)
+//==============================================================================
+namespace DETAIL
+{
+
+template<typename TList>
+consteval auto UniqueAddresses(TList list)
+{
+  if constexpr (TList::is_empty()) return list;
+  else
+  {
+    using HEAD = typename decltype(TList::head())::type;
+    constexpr auto rest = TList::tail().filter([](auto x) { return TypeUnBox<x>::GetEpAddress() != HEAD::GetEpAddress(); });
+    return TypeList<HEAD>{} + UniqueAddresses(rest);
+  }
+}
+
+template<typename TConfiguration>
+consteval auto Endpoints()
+{
+  constexpr auto eps = TConfiguration::GetDescriptorList().GetEndpoints().filter([](auto x)
+  {
+    return (TypeUnBox<x>::GetEpType() == USB_DESCRIPTORS::epTYPE::Bulk) || (TypeUnBox<x>::GetEpType() == USB_DESCRIPTORS::epTYPE::Interrupt);
+  });
+  return UniqueAddresses(eps);
+}
+
+template<typename TTransport, typename TTrace, typename TList> class SET;
+
+template<typename TTransport, typename TTrace, typename... EPS>
+class SET<TTransport, TTrace, TypeList<EPS...>> : public ENDPOINT<EPS, TTransport, TTrace>...
+{
+public:
+  explicit SET(TTransport& transport) : ENDPOINT<EPS, TTransport, TTrace>(transport)... {}
+
+  template<uint8_t address>
+  auto& Get()
+  {
+    constexpr auto found = TypeList<EPS...>::filter([](auto x) { return TypeUnBox<x>::GetEpAddress() == address; });
+    static_assert(found.size() == 1, "No Bulk or Interrupt endpoint with this address");
+    return static_cast<ENDPOINT<typename decltype(found.head())::type, TTransport, TTrace>&>(*this);
+  }
+
+  void OnTransmitted(uint8_t ep)
+  {
+    (Event<EPS, true>(ep, 0) || ...);
+  }
+
+  void OnReceived(uint8_t ep, uint32_t len)
+  {
+    (Event<EPS, false>(ep, len) || ...);
+  }
+
+  void Abort() { (static_cast<ENDPOINT<EPS, TTransport, TTrace>&>(*this).Abort(), ...); }
+
+  static constexpr uint8_t Count() { return sizeof...(EPS); }
+
+private:
+  template<typename TEp, bool in>
+  bool Event(uint8_t ep, uint32_t len)
+  {
+    if constexpr (TEp::IsIn() != in) return false;
+    else
+    {
+      if (ep != TEp::GetEpAddress()) return false;
+      auto& e = static_cast<ENDPOINT<TEp, TTransport, TTrace>&>(*this);
+      if constexpr (in) e.OnTransmitted();
+      else e.OnReceived(len);
+      return true;
+    }
+  }
+};
+
+} // namespace DETAIL
+
+template<typename TConfiguration, typename TTransport, typename TTrace = USB_TRACE::NO_TRACE>
+using ENDPOINTS = DETAIL::SET<TTransport, TTrace, decltype(DETAIL::Endpoints<std::remove_cvref_t<TConfiguration>>())>;
+
+} // namespace USB_EP
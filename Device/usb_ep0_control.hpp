@@ -0,0 +1,217 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+#include "usb_ep0_descriptors.hpp"
+#include "usb_trace.hpp"
+
+//==============================================================================
+// Control передачи EP0: SETUP -> данные -> статус
+//==============================================================================
+// Транспорт (TTransport), как у MSC::BOT, вызовы неблокирующие и не вызывают
+// события сами (события приходят из прерывания):
+//   void Transmit(uint8_t ep, const uint8_t* buf, uint32_t len); -> OnTransmitted()
+//   void Receive(uint8_t ep, uint8_t* buf, uint32_t len);        -> OnReceived(len)
+//   void Stall(uint8_t ep);
+//   void SetAddress(uint8_t address);     после статуса SET_ADDRESS
+//
+// Обработчик (THandler) - тот же, что у USBIP::SERVER:
+//   void Configured(uint8_t value);                                SET_CONFIGURATION
+//   int32_t Control(const uint8_t* setup, uint8_t* data, uint16_t len);
+//     IN - длина ответа в data (len - не больше wLength и буфера);
+//     OUT - данные уже приняты в data, 0 или STALL (STALL на стадии статуса)
+//
+// Стандартные запросы к устройству (GET/SET_ADDRESS, GET_DESCRIPTOR,
+// GET/SET_CONFIGURATION, GET_STATUS) выполняет REQUESTS, остальное -
+// обработчик. SETUP посреди передачи отменяет ее (хост прервал передачу).
+//
+// TTrace - политика трассировки (usb_trace.hpp): SETUP, выданный дескриптор,
+// STALL, конец передачи (байт данных, переданных на самом деле) и прерванная
+// передача
+//==============================================================================
+namespace EP0
+{
+
+constexpr int32_t STALL = -1;
+
+template<typename THandler, uint16_t buffer_size, typename TTrace = USB_TRACE::NO_TRACE>
+class REQUESTS
+{
+public:
+  REQUESTS(const USB_DESCRIPTORS::USB_PERSONALITY& personality, THandler& handler)
+    : personality(personality), handler(handler), descriptors(personality) {}
+
+  uint8_t Configuration() const { return configuration; }
+  uint16_t MaxPacketSize() const { return personality.device[7]; }
+
+protected:
+  bool In() const { return setup[0] & 0x80; }
+  uint16_t wValue() const { return uint16_t(setup[2] | (setup[3] << 8)); }
+  uint16_t wLength() const { return uint16_t(setup[6] | (setup[7] << 8)); }
+
+  // Стадия SETUP. IN - ответ подготовлен в stream; OUT без данных - выполнен.
+  // OUT с данными - принят к приему в buf
+  int32_t SetupStage()
+  {
+    TTrace::Setup(setup);
+    address = 0;
+    if (!In() && wLength()) return (wLength() <= buffer_size) ? 0 : STALL;
+    const USB_DESCRIPTORS::GATHER_LIST* list = &reply;
+    int32_t n = 0;
+    if ((setup[0] & 0x7F) == 0)       // стандартный, к устройству
+      switch (setup[1])
+      {
+        case 0x00:                    // GET_STATUS
+          buf[0] = buf[1] = 0;
+          n = 2;
+          break;
+        case 0x05:                    // SET_ADDRESS: адрес - после статуса
+          address = uint8_t(wValue() & 0x7F);
+          return 0;
+        case 0x06:                    // GET_DESCRIPTOR
+          list = descriptors.Find(setup[3], setup[2]);
+          if (!list || !In()) return STALL;
+          if constexpr (TTrace::enabled)
+            TTrace::Descriptor(setup[3], setup[2], (list->size < wLength()) ? list->size : wLength());
+          break;
+        case 0x08:                    // GET_CONFIGURATION
+          buf[0] = configuration;
+          n = 1;
+          break;
+        case 0x09:                    // SET_CONFIGURATION
+          if (wValue() > personality.device[17]) return STALL;
+          configuration = uint8_t(wValue());
+          handler.Configured(configuration);
+          return 0;
+        default:
+          return STALL;
+      }
+    else
+    {
+      uint16_t len = (wLength() < buffer_size) ? wLength() : buffer_size;
+      n = handler.Control(setup, buf, In() ? len : 0);
+      if ((n < 0) || !In()) return (n < 0) ? STALL : 0;
+    }
+    if (list == &reply)
+    {
+      blob = { buf, uint16_t(n) };
+      reply = { &blob, 1, uint16_t(n) };
+    }
+    stream.Start(*list, wLength(), MaxPacketSize());
+    return 0;
+  }
+
+  // Данные OUT приняты
+  int32_t DataStage(uint16_t len) { return (handler.Control(setup, buf, len) < 0) ? STALL : 0; }
+
+  // Статус завершен
+  uint8_t StatusStage() const { return address; }
+
+  uint8_t setup[8]{};
+  uint8_t buf[buffer_size];
+  uint8_t packet[64];
+  GATHER_STREAM<USB_DESCRIPTORS::GATHER_LIST> stream;
+
+private:
+  const USB_DESCRIPTORS::USB_PERSONALITY& personality;
+  THandler& handler;
+  GET_DESCRIPTOR descriptors;
+  USB_DESCRIPTORS::CONFIGURATION_BLOB blob{};
+  USB_DESCRIPTORS::GATHER_LIST reply{};
+  uint8_t configuration = 0;
+  uint8_t address = 0;
+};
+
+//==============================================================================
+// Классический автомат: стадия - состояние, событие - switch
+//==============================================================================
+template<typename TTransport, typename THandler, uint16_t buffer_size = 256, typename TTrace = USB_TRACE::NO_TRACE>
+class CONTROL : public REQUESTS<THandler, buffer_size, TTrace>
+{
+  using BASE = REQUESTS<THandler, buffer_size, TTrace>;
+public:
+  CONTROL(TTransport& transport, const USB_DESCRIPTORS::USB_PERSONALITY& personality, THandler& handler)
+    : BASE(personality, handler), transport(transport) {}
+
+  void Setup(const uint8_t* packet)
+  {
+    memcpy(this->setup, packet, 8);
+    if (stage != STAGE::Idle) TTrace::Complete(0x00, -1);
+    stage = STAGE::Idle;
+    if constexpr (TTrace::enabled) sent = 0;
+    if (this->SetupStage() == STALL) return Stall();
+    if (this->In()) { stage = STAGE::DataIn; Send(); }
+    else if (this->wLength()) { stage = STAGE::DataOut; received = 0; Receive(); }
+    else { stage = STAGE::StatusIn; transport.Transmit(0x80, nullptr, 0); }
+  }
+
+  void OnTransmitted()
+  {
+    switch (stage)
+    {
+      case STAGE::DataIn:
+        if constexpr (TTrace::enabled) sent += last;
+        if (!this->stream.Done()) Send();
+        else { stage = STAGE::StatusOut; transport.Receive(0x00, nullptr, 0); }
+        break;
+      case STAGE::StatusIn:
+        stage = STAGE::Idle;
+        TTrace::Complete(0x00, this->wLength() ? received : 0);
+        if (uint8_t address = this->StatusStage()) transport.SetAddress(address);
+        break;
+      default: break;
+    }
+  }
+
+  void OnReceived(uint16_t len)
+  {
+    switch (stage)
+    {
+      case STAGE::DataOut:
+        received += len;
+        if ((received < this->wLength()) && (len == this->MaxPacketSize())) Receive();
+        else if (this->DataStage(received) == STALL) Stall();
+        else { stage = STAGE::StatusIn; transport.Transmit(0x80, nullptr, 0); }
+        break;
+      case STAGE::DataIn:       // статус раньше конца данных
+      case STAGE::StatusOut:
+        stage = STAGE::Idle;
+        TTrace::Complete(0x00, sent);
+        break;
+      default: break;
+    }
+  }
+
+private:
+  enum class STAGE : uint8_t { Idle, DataIn, DataOut, StatusIn, StatusOut };
+
+  void Send()
+  {
+    uint16_t len = this->stream.Next(this->packet);
+    if constexpr (TTrace::enabled) last = len;
+    transport.Transmit(0x80, this->packet, len);
+  }
+
+  void Receive()
+  {
+    uint16_t n = this->wLength() - received;
+    transport.Receive(0x00, this->buf + received, (n < this->MaxPacketSize()) ? n : this->MaxPacketSize());
+  }
+
+  void Stall()
+  {
+    stage = STAGE::Idle;
+    TTrace::Stall(0x00);
+    transport.Stall(0x80);
+    transport.Stall(0x00);
+  }
+
+  TTransport& transport;
+  STAGE stage = STAGE::Idle;
+  uint16_t received = 0;
+  uint16_t sent = 0;                  // только для трассировки
+  uint16_t last = 0;
+};
+
+} // namespace EP0
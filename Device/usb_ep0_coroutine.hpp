@@ -0,0 +1,173 @@
+#pragma once
+
+#if !defined(__cpp_impl_coroutine)
+#error "EP0 coroutine requires C++20 coroutines"
+#endif
+
+#include <cstddef>
+#include <exception>
+#include <coroutine>
+
+#include "usb_ep0_control.hpp"
+
+//==============================================================================
+// Control передачи EP0 одной сопрограммой
+//==============================================================================
+// Интерфейс как у EP0::CONTROL: Setup(), OnTransmitted(), OnReceived(len) из
+// прерывания возобновляют сопрограмму, она идет до следующего пакета.
+// Передача записана подряд: SETUP, пакеты данных, статус; любой новый SETUP
+// возвращает в начало цикла (хост прервал передачу).
+//
+// Кадр сопрограммы - в самом объекте (frame_size байт), куча не используется:
+// operator new промиса берет память у владельца. Если кадр не поместился,
+// Valid() == false (размер, который просил компилятор, - FrameUsed())
+//==============================================================================
+namespace EP0
+{
+
+struct TASK
+{
+  struct promise_type
+  {
+    TASK get_return_object() { return { std::coroutine_handle<promise_type>::from_promise(*this) }; }
+    static TASK get_return_object_on_allocation_failure() { return {}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_always final_suspend() noexcept { return {}; }
+    void return_void() {}
+    void unhandled_exception() { std::terminate(); }
+
+    // Сопрограмма - метод владельца: первый аргумент - сам владелец
+    template<typename TOwner>
+    static void* operator new(size_t size, TOwner& owner) noexcept { return owner.Frame(size); }
+    static void operator delete(void*) noexcept {}
+  };
+
+  std::coroutine_handle<promise_type> handle;
+};
+
+template<typename TTransport, typename THandler, uint16_t buffer_size = 256, size_t frame_size = 256,
+         typename TTrace = USB_TRACE::NO_TRACE>
+class CONTROL_TASK : public REQUESTS<THandler, buffer_size, TTrace>
+{
+  using BASE = REQUESTS<THandler, buffer_size, TTrace>;
+public:
+  CONTROL_TASK(TTransport& transport, const USB_DESCRIPTORS::USB_PERSONALITY& personality, THandler& handler)
+    : BASE(personality, handler), transport(transport), task(Run()) {}
+
+  ~CONTROL_TASK() { if (task.handle) task.handle.destroy(); }
+
+  CONTROL_TASK(const CONTROL_TASK&) = delete;
+  CONTROL_TASK& operator=(const CONTROL_TASK&) = delete;
+
+  void Setup(const uint8_t* packet)
+  {
+    memcpy(this->setup, packet, 8);
+    Resume(EVENT::Setup, 0);
+  }
+  void OnTransmitted() { Resume(EVENT::In, 0); }
+  void OnReceived(uint16_t len) { Resume(EVENT::Out, len); }
+
+  bool Valid() const { return bool(task.handle); }
+  size_t FrameUsed() const { return frame_used; }
+
+  // Память кадра для TASK::promise_type
+  void* Frame(size_t size)
+  {
+    frame_used = size;
+    return (size <= frame_size) ? frame : nullptr;
+  }
+
+private:
+  enum class EVENT : uint8_t { Setup, In, Out };
+
+  struct NEXT_EVENT
+  {
+    CONTROL_TASK& owner;
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> h) noexcept { owner.waiting = h; }
+    EVENT await_resume() const noexcept { return owner.event; }
+  };
+
+  NEXT_EVENT Next() { return { *this }; }
+
+  void Resume(EVENT e, uint16_t len)
+  {
+    event = e;
+    received = len;
+    if (waiting) waiting.resume();
+  }
+
+  void Stall()
+  {
+    TTrace::Stall(0x00);
+    transport.Stall(0x80);
+    transport.Stall(0x00);
+  }
+
+  TASK Run()
+  {
+    const uint16_t mps = this->MaxPacketSize();
+    EVENT e = co_await Next();
+    for (;;)
+    {
+      uint16_t got = 0;         // байт данных, для трассировки
+      if (e != EVENT::Setup) { e = co_await Next(); continue; }   // пакет вне передачи
+
+      if (this->SetupStage() == STALL) { Stall(); e = co_await Next(); continue; }
+
+      if (this->In())
+      {
+        // Данные IN до короткого пакета или wLength, затем статус OUT
+        do
+        {
+          uint16_t len = this->stream.Next(this->packet);
+          transport.Transmit(0x80, this->packet, len);
+          e = co_await Next();
+          if constexpr (TTrace::enabled) if (e == EVENT::In) got += len;
+        } while ((e == EVENT::In) && !this->stream.Done());
+        if (e != EVENT::In)     // статус раньше конца данных или новый SETUP
+        {
+          TTrace::Complete(0x00, (e == EVENT::Out) ? int32_t(got) : -1);
+          continue;
+        }
+        transport.Receive(0x00, nullptr, 0);
+        e = co_await Next();
+        TTrace::Complete(0x00, (e == EVENT::Out) ? int32_t(got) : -1);
+        continue;
+      }
+
+      if (this->wLength())
+      {
+        // Данные OUT до wLength или короткого пакета
+        uint16_t left;
+        do
+        {
+          left = this->wLength() - got;
+          transport.Receive(0x00, this->buf + got, (left < mps) ? left : mps);
+          e = co_await Next();
+          got += received;
+        } while ((e == EVENT::Out) && (got < this->wLength()) && (received == mps));
+        if (e != EVENT::Out) { TTrace::Complete(0x00, -1); continue; }
+        if (this->DataStage(got) == STALL) { Stall(); e = co_await Next(); continue; }
+      }
+
+      // Статус IN
+      transport.Transmit(0x80, nullptr, 0);
+      e = co_await Next();
+      TTrace::Complete(0x00, (e == EVENT::In) ? int32_t(got) : -1);
+      if (e == EVENT::In)
+        if (uint8_t address = this->StatusStage()) transport.SetAddress(address);
+    }
+  }
+
+  // Порядок важен: Run() начинает работу в конструкторе и пишет в waiting и frame
+  alignas(std::max_align_t) uint8_t frame[frame_size];
+  size_t frame_used = 0;
+  TTransport& transport;
+  std::coroutine_handle<> waiting;
+  EVENT event = EVENT::Setup;
+  uint16_t received = 0;
+  TASK task;
+};
+
+} // namespace EP0
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <stdint.h>
+
+#if (__cplusplus > 201703L)
+#include "../Descriptors/C++20/usb_descriptors.hpp"
+#else
+#include "../Descriptors/C++17/usb_descriptors.h"
+#endif
+#include "usb_ep0_stream.hpp"
+
+//==============================================================================
+// GET_DESCRIPTOR по личности профиля (USB_PERSONALITY)
+//==============================================================================
+// Любой ответ - список фрагментов: конфигурация - своим GATHER_LIST, Device и
+// String Descriptor - списком из одного фрагмента. Стадию данных ведет
+// GATHER_STREAM пакетами mps байт, как в прерывании EP0 контроллера:
+//
+//   if (!get.Setup(setup, mps)) Stall();
+//   do Send(packet, get.Next(packet)); while (!get.Done());
+//
+// Language ID (wIndex) строк не проверяется - в таблице один язык
+//==============================================================================
+namespace EP0
+{
+
+class GET_DESCRIPTOR
+{
+public:
+  explicit GET_DESCRIPTOR(const USB_DESCRIPTORS::USB_PERSONALITY& personality) : personality(personality) {}
+
+  // false - не стандартный GET_DESCRIPTOR к устройству или дескриптора нет (STALL)
+  bool Setup(const uint8_t* setup, uint16_t mps)
+  {
+    if ((setup[0] != 0x80) || (setup[1] != 0x06)) return false;
+    return Start(setup[3], setup[2], uint16_t(setup[6] | (setup[7] << 8)), mps);
+  }
+
+  bool Start(uint8_t type, uint8_t index, uint16_t wLength, uint16_t mps)
+  {
+    const USB_DESCRIPTORS::GATHER_LIST* list = Find(type, index);
+    if (!list) return false;
+    stream.Start(*list, wLength, mps);
+    return true;
+  }
+
+  uint16_t Next(uint8_t* buf) { return stream.Next(buf); }
+  bool Done() const { return stream.Done(); }
+
+  // Список фрагментов дескриптора, nullptr - нет такого. Действителен до
+  // следующего вызова
+  const USB_DESCRIPTORS::GATHER_LIST* Find(uint8_t type, uint8_t index)
+  {
+    const uint8_t* src = nullptr;
+    switch (DescriptorType(type))
+    {
+      case DescriptorType::DEVICE:
+        src = personality.device;
+        break;
+      case DescriptorType::CONFIGURATION:
+        return (index < personality.device[17]) ? &personality.configurations[index] : nullptr;
+      case DescriptorType::STRING:
+        for (uint8_t i = 0; i < personality.strings_count; ++i)
+          if (personality.strings[i][0] == index) src = personality.strings[i] + 1;
+        break;
+      default: break;
+    }
+    if (!src) return nullptr;
+    blob = { src, src[0] };
+    single = { &blob, 1, src[0] };
+    return &single;
+  }
+
+private:
+  const USB_DESCRIPTORS::USB_PERSONALITY& personality;
+  USB_DESCRIPTORS::CONFIGURATION_BLOB blob{};
+  USB_DESCRIPTORS::GATHER_LIST single{};
+  GATHER_STREAM<USB_DESCRIPTORS::GATHER_LIST> stream;
+};
+
+} // namespace EP0
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+//==============================================================================
+// Стадия данных GET_DESCRIPTOR на EP0 из списка фрагментов
+//==============================================================================
+// Список (TList) - GATHER_LIST из дескрипторов:
+//   fragments[i].data, fragments[i].size, count, size (wTotalLength)
+//
+// Start() обрезает ответ до wLength, Next() копирует в буфер пакета очередные
+// mps байт, переходя через границы фрагментов, - конфигурация целиком в RAM
+// не собирается. Стадия кончается коротким пакетом; если ответ короче wLength
+// и кратен mps, последним уходит пакет нулевой длины (ZLP)
+//==============================================================================
+namespace EP0
+{
+
+template<typename TList>
+class GATHER_STREAM
+{
+public:
+  void Start(const TList& list, uint16_t wLength, uint16_t mps)
+  {
+    this->list = &list;
+    this->mps = mps;
+    remain = (list.size < wLength) ? list.size : wLength;
+    zlp = (remain < wLength) && !(remain % mps);
+    fragment = 0;
+    offset = 0;
+    done = false;
+  }
+
+  // Длина пакета, скопированного в buf (не больше mps байт)
+  uint16_t Next(uint8_t* buf)
+  {
+    uint16_t len = 0;
+    while (remain && (len < mps))
+    {
+      auto& f = list->fragments[fragment];
+      uint16_t n = f.size - offset;
+      if (n > mps - len) n = mps - len;
+      if (n > remain) n = remain;
+      memcpy(buf + len, f.data + offset, n);
+      len += n;
+      remain -= n;
+      offset += n;
+      if (offset == f.size) { ++fragment; offset = 0; }
+    }
+    done = (len < mps) || (!remain && !zlp);
+    return len;
+  }
+
+  bool Done() const { return done; }
+
+private:
+  const TList* list = nullptr;
+  uint16_t mps = 64;
+  uint16_t remain = 0;     // байт ответа еще не передано
+  uint16_t offset = 0;     // смещение в текущем фрагменте
+  uint8_t fragment = 0;
+  bool zlp = false;
+  bool done = true;
+};
+
+} // namespace EP0
@@ -0,0 +1,479 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+
+//==============================================================================
+// Mass Storage Bulk-Only Transport + SCSI transparent command set
+// (MSC BOT 1.0, подмножество SPC-4 / SBC-3)
+//==============================================================================
+// Интерфейс (TInterface) - MSC_INTERFACE из профиля:
+//   DataInEp(), DataOutEp(), MaxPacketSize()
+//
+// Блочное устройство (TBlockDevice):
+//   static constexpr uint32_t BlockSize;
+//   uint64_t BlockCount() const;
+//   bool IsWriteProtected() const;
+//   bool Read(uint64_t lba, uint8_t* buf, uint32_t count);
+//   bool Write(uint64_t lba, const uint8_t* buf, uint32_t count);
+//   bool Flush();
+//
+// Транспорт (TTransport), вызовы неблокирующие:
+//   void Transmit(uint8_t ep, const uint8_t* buf, uint32_t len); -> OnTransmitted()
+//   void Receive(uint8_t ep, uint8_t* buf, uint32_t len);        -> OnReceived(len)
+//   void Stall(uint8_t ep);  CSW уходит после CLEAR_FEATURE(ENDPOINT_HALT)
+//
+// OnTransmitted/OnReceived вызываются из прерывания и только снимают флаги,
+// все обращения к носителю и транспорту выполняет Poll() в основном цикле.
+//
+// Конвейер: пока один буфер передается по USB, второй заполняется с носителя
+// (READ) или записывается на носитель, пока принимается следующий (WRITE).
+//==============================================================================
+namespace MSC
+{
+
+enum class SCSI_OP : uint8_t
+{
+  TEST_UNIT_READY=0x00, REQUEST_SENSE=0x03, INQUIRY=0x12, MODE_SENSE_6=0x1A,
+  START_STOP_UNIT=0x1B, PREVENT_ALLOW_MEDIUM_REMOVAL=0x1E, READ_FORMAT_CAPACITIES=0x23,
+  READ_CAPACITY_10=0x25, READ_10=0x28, WRITE_10=0x2A, VERIFY_10=0x2F,
+  SYNCHRONIZE_CACHE_10=0x35, MODE_SENSE_10=0x5A, READ_16=0x88, WRITE_16=0x8A,
+  SERVICE_ACTION_IN_16=0x9E
+};
+
+enum class CSW_STATUS : uint8_t { PASSED = 0, FAILED = 1, PHASE_ERROR = 2 };
+
+// Sense Key / ASC / ASCQ
+struct SENSE
+{
+  uint8_t key, asc, ascq;
+
+  static constexpr SENSE NoSense()            { return { 0x00, 0x00, 0x00 }; }
+  static constexpr SENSE InvalidOpcode()      { return { 0x05, 0x20, 0x00 }; }
+  static constexpr SENSE InvalidField()       { return { 0x05, 0x24, 0x00 }; }
+  static constexpr SENSE LbaOutOfRange()      { return { 0x05, 0x21, 0x00 }; }
+  static constexpr SENSE WriteProtected()     { return { 0x07, 0x27, 0x00 }; }
+  static constexpr SENSE UnrecoveredRead()    { return { 0x03, 0x11, 0x00 }; }
+  static constexpr SENSE WriteError()         { return { 0x03, 0x0C, 0x00 }; }
+  static constexpr SENSE MediumNotPresent()   { return { 0x02, 0x3A, 0x00 }; }
+};
+
+template<typename TInterface,
+         typename TTransport,
+         typename TBlockDevice,
+         uint32_t buffer_size = 16384,   // размер каждого из двух буферов, байт
+         bool pipelined = true>          // false - носитель и USB по очереди
+class BOT
+{
+  static constexpr uint32_t block_size = TBlockDevice::BlockSize;
+  static constexpr uint32_t batch = buffer_size / block_size;   // секторов на буфер
+  static constexpr uint8_t ep_in = TInterface::DataInEp();
+  static constexpr uint8_t ep_out = TInterface::DataOutEp();
+
+  static_assert((buffer_size >= block_size) && (buffer_size % block_size == 0), "Buffer must hold whole blocks");
+  static_assert(buffer_size % TInterface::MaxPacketSize() == 0, "Buffer must hold whole packets");
+
+  static constexpr uint32_t CBW_SIGNATURE = 0x43425355;
+  static constexpr uint32_t CSW_SIGNATURE = 0x53425355;
+  static constexpr uint32_t CBW_LENGTH = 31;
+  static constexpr int8_t NONE = -1;
+
+  enum class STATE : uint8_t { CBW, REPLY, READ, WRITE, CSW, STALLED };
+
+public:
+  BOT(TTransport& transport, TBlockDevice& device,
+      const char* vendor = "STM32", const char* product = "Mass Storage", const char* revision = "1.00")
+    : transport(transport), device(device)
+  {
+    Pad(inquiry_id, vendor, 8);
+    Pad(inquiry_id + 8, product, 16);
+    Pad(inquiry_id + 24, revision, 4);
+  }
+
+  // SET_CONFIGURATION / SET_INTERFACE(alt 0) / Bulk-Only Mass Storage Reset
+  void Start()
+  {
+    sense = SENSE::NoSense();
+    tx_busy = false;
+    ArmCBW();
+  }
+  void Reset() { Start(); }
+  static constexpr uint8_t MaxLun() { return 0; } // GET_MAX_LUN
+
+  // Прерывания контроллера
+  void OnTransmitted() { tx_busy = false; }
+  void OnReceived(uint32_t len) { rx_len = len; rx_busy = false; }
+
+  // Основной цикл
+  void Poll()
+  {
+    switch (state)
+    {
+      case STATE::CBW:   if (!rx_busy) ParseCBW(rx_len); break;
+      case STATE::REPLY: if (!tx_busy) Finish(CSW_STATUS::PASSED); break;
+      case STATE::READ:  PollRead(); break;
+      case STATE::WRITE: PollWrite(); break;
+      case STATE::CSW:   if (!tx_busy) ArmCBW(); break;
+      case STATE::STALLED: break;           // до Reset
+    }
+  }
+
+private:
+  //----------------------------------------------------------------------------
+  static uint16_t BE16(const uint8_t* p) { return uint16_t((p[0] << 8) | p[1]); }
+  static uint32_t BE32(const uint8_t* p) { return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | p[3]; }
+  static uint64_t BE64(const uint8_t* p) { return (uint64_t(BE32(p)) << 32) | BE32(p + 4); }
+  static uint32_t LE32(const uint8_t* p) { return (uint32_t(p[3]) << 24) | (uint32_t(p[2]) << 16) | (uint32_t(p[1]) << 8) | p[0]; }
+  static void PutBE32(uint8_t* p, uint32_t v) { p[0] = v >> 24; p[1] = v >> 16; p[2] = v >> 8; p[3] = v; }
+  static void PutBE64(uint8_t* p, uint64_t v) { PutBE32(p, uint32_t(v >> 32)); PutBE32(p + 4, uint32_t(v)); }
+  static void PutLE32(uint8_t* p, uint32_t v) { p[0] = v; p[1] = v >> 8; p[2] = v >> 16; p[3] = v >> 24; }
+  static void Pad(uint8_t* dst, const char* src, uint32_t n)
+  {
+    for (uint32_t i = 0; i < n; ++i) dst[i] = (src && *src) ? *src++ : ' ';
+  }
+
+  void StartTx(const uint8_t* data, uint32_t len) { tx_busy = true; transport.Transmit(ep_in, data, len); }
+  void StartRx(uint8_t* data, uint32_t len) { rx_busy = true; transport.Receive(ep_out, data, len); }
+
+  void ArmCBW()
+  {
+    state = STATE::CBW;
+    StartRx(buf[0], TInterface::MaxPacketSize());
+  }
+
+  //----------------------------------------------------------------------------
+  // Фаза команды
+  //----------------------------------------------------------------------------
+  void ParseCBW(uint32_t len)
+  {
+    const uint8_t* cbw = buf[0];
+    // Верный (BOT 6.2.1) и осмысленный: LUN есть, длина блока команды 1..16,
+    // резервные биты bmCBWFlags, bCBWLUN и bCBWCBLength нулевые
+    if ((len != CBW_LENGTH) || (LE32(cbw) != CBW_SIGNATURE) || (cbw[12] & 0x7F) ||
+        (cbw[13] > MaxLun()) || (cbw[14] < 1) || (cbw[14] > 16))
+    {
+      // Неверный CBW: обе точки в STALL до Reset (BOT 6.6.1)
+      transport.Stall(ep_in);
+      transport.Stall(ep_out);
+      state = STATE::STALLED;
+      return;
+    }
+    tag = LE32(cbw + 4);
+    expected = LE32(cbw + 8);
+    dir_in = cbw[12] & 0x80;
+    done = 0;
+    memcpy(cb, cbw + 15, sizeof(cb));
+
+    switch (SCSI_OP(cb[0]))
+    {
+      case SCSI_OP::TEST_UNIT_READY:
+      case SCSI_OP::PREVENT_ALLOW_MEDIUM_REMOVAL:
+      case SCSI_OP::START_STOP_UNIT:
+      case SCSI_OP::VERIFY_10:
+        Finish(CSW_STATUS::PASSED);
+        break;
+
+      case SCSI_OP::SYNCHRONIZE_CACHE_10:
+        if (device.Flush()) Finish(CSW_STATUS::PASSED);
+        else Fail(SENSE::WriteError());
+        break;
+
+      case SCSI_OP::REQUEST_SENSE:
+      {
+        uint8_t* r = Clear(18);
+        r[0] = 0x70;              // Current errors, fixed format
+        r[2] = sense.key;
+        r[7] = 10;                // Additional sense length
+        r[12] = sense.asc;
+        r[13] = sense.ascq;
+        sense = SENSE::NoSense();
+        Reply(18, cb[4]);
+        break;
+      }
+
+      case SCSI_OP::INQUIRY:
+      {
+        if (cb[1] & 0x01) { Fail(SENSE::InvalidField()); break; } // VPD страницы не поддерживаются
+        uint8_t* r = Clear(36);
+        r[0] = 0x00;              // Direct access block device
+        r[1] = 0x80;              // Removable
+        r[2] = 0x04;              // SPC-2
+        r[3] = 0x02;              // Response data format
+        r[4] = 36 - 5;            // Additional length
+        memcpy(r + 8, inquiry_id, sizeof(inquiry_id));
+        Reply(36, BE16(cb + 3));
+        break;
+      }
+
+      case SCSI_OP::MODE_SENSE_6:
+      {
+        uint8_t* r = Clear(4);
+        r[0] = 3;                 // Mode data length
+        r[2] = device.IsWriteProtected() ? 0x80 : 0x00;
+        Reply(4, cb[4]);
+        break;
+      }
+
+      case SCSI_OP::MODE_SENSE_10:
+      {
+        uint8_t* r = Clear(8);
+        r[1] = 6;                 // Mode data length
+        r[3] = device.IsWriteProtected() ? 0x80 : 0x00;
+        Reply(8, BE16(cb + 7));
+        break;
+      }
+
+      case SCSI_OP::READ_FORMAT_CAPACITIES:
+      {
+        uint8_t* r = Clear(12);
+        r[3] = 8;                 // Capacity list length
+        PutBE32(r + 4, Blocks32());
+        PutBE32(r + 8, block_size);
+        r[8] = 0x02;              // Formatted media
+        Reply(12, BE16(cb + 7));
+        break;
+      }
+
+      case SCSI_OP::READ_CAPACITY_10:
+      {
+        if (!device.BlockCount()) { Fail(SENSE::MediumNotPresent()); break; }
+        uint8_t* r = Clear(8);
+        PutBE32(r, LastLba32());
+        PutBE32(r + 4, block_size);
+        Reply(8, 8);
+        break;
+      }
+
+      case SCSI_OP::SERVICE_ACTION_IN_16:
+      {
+        if ((cb[1] & 0x1F) != 0x10) { Fail(SENSE::InvalidOpcode()); break; } // READ CAPACITY(16)
+        if (!device.BlockCount()) { Fail(SENSE::MediumNotPresent()); break; }
+        uint8_t* r = Clear(32);
+        PutBE64(r, device.BlockCount() - 1);
+        PutBE32(r + 8, block_size);
+        Reply(32, BE32(cb + 10));
+        break;
+      }
+
+      case SCSI_OP::READ_10:  StartRead(BE32(cb + 2), BE16(cb + 7)); break;
+      case SCSI_OP::READ_16:  StartRead(BE64(cb + 2), BE32(cb + 10)); break;
+      case SCSI_OP::WRITE_10: StartWrite(BE32(cb + 2), BE16(cb + 7)); break;
+      case SCSI_OP::WRITE_16: StartWrite(BE64(cb + 2), BE32(cb + 10)); break;
+
+      default:
+        Fail(SENSE::InvalidOpcode());
+        break;
+    }
+  }
+
+  uint32_t Blocks32() const
+  {
+    uint64_t n = device.BlockCount();
+    return (n > 0xFFFFFFFF) ? 0xFFFFFFFF : uint32_t(n);
+  }
+
+  // Последний LBA для READ CAPACITY(10): от 2^32 блоков - ровно 0xFFFFFFFF,
+  // тогда хост переходит на READ CAPACITY(16) (SBC-3). Пустой носитель сюда
+  // не доходит - NOT READY
+  uint32_t LastLba32() const
+  {
+    uint64_t n = device.BlockCount();
+    return (n > 0xFFFFFFFF) ? 0xFFFFFFFF : uint32_t(n - 1);
+  }
+
+  uint8_t* Clear(uint32_t n) { memset(buf[0], 0, n); return buf[0]; }
+
+  //----------------------------------------------------------------------------
+  // Короткие ответы: не больше, чем разрешили allocation length и dCBWDataTransferLength
+  //----------------------------------------------------------------------------
+  void Reply(uint32_t len, uint32_t allocation)
+  {
+    if (!dir_in && expected) { Phase(); return; }   // Ho <> Di
+    if (allocation < len) len = allocation;
+    if (!expected && len) { Phase(); return; }      // Hn < Di (BOT 6.7.1)
+    if (expected < len) len = expected;
+    if (!len) { Finish(CSW_STATUS::PASSED); return; }
+    done = len;
+    state = STATE::REPLY;
+    StartTx(buf[0], len);
+  }
+
+  void Fail(SENSE s)
+  {
+    sense = s;
+    Finish(CSW_STATUS::FAILED);
+  }
+
+  void Phase() { Finish(CSW_STATUS::PHASE_ERROR); }
+
+  //----------------------------------------------------------------------------
+  // Фаза статуса: недопереданные данные закрываются STALL соответствующей точки
+  //----------------------------------------------------------------------------
+  void Finish(CSW_STATUS status)
+  {
+    uint32_t residue = expected - done;
+    if (residue || (status == CSW_STATUS::PHASE_ERROR)) transport.Stall(dir_in ? ep_in : ep_out);
+    PutLE32(csw, CSW_SIGNATURE);
+    PutLE32(csw + 4, tag);
+    PutLE32(csw + 8, residue);
+    csw[12] = uint8_t(status);
+    state = STATE::CSW;
+    StartTx(csw, sizeof(csw));
+  }
+
+  bool CheckRange(uint64_t lba, uint32_t count)
+  {
+    if ((lba > device.BlockCount()) || (count > device.BlockCount() - lba))
+    {
+      Fail(SENSE::LbaOutOfRange());
+      return false;
+    }
+    return true;
+  }
+
+  void ResetPipe(uint64_t lba, uint32_t count)
+  {
+    this->lba = lba;
+    blocks = count;
+    total = count * block_size;
+    len[0] = len[1] = 0;
+    fill = flight = 0;
+    pending = NONE;
+    error = false;
+  }
+
+  //----------------------------------------------------------------------------
+  // READ: носитель -> buf[fill], buf[flight] -> USB
+  //----------------------------------------------------------------------------
+  void StartRead(uint64_t lba, uint32_t count)
+  {
+    if (!dir_in || (expected < uint64_t(count) * block_size)) { Phase(); return; } // Hi < Di, Ho <> Di
+    if (!CheckRange(lba, count)) return;
+    if (!count) { Finish(CSW_STATUS::PASSED); return; }
+    ResetPipe(lba, count);
+    state = STATE::READ;
+    PollRead();
+  }
+
+  void PollRead()
+  {
+    if ((pending != NONE) && !tx_busy)        // буфер ушел
+    {
+      done += len[pending];
+      len[pending] = 0;
+      pending = NONE;
+    }
+    Kick();                                   // USB запускается до обращения к носителю
+    if (blocks && !error && !len[fill] && (pipelined || pending == NONE))
+    {
+      uint32_t n = (blocks < batch) ? blocks : batch;
+      if (device.Read(lba, buf[fill], n))
+      {
+        len[fill] = n * block_size;
+        lba += n;
+        blocks -= n;
+        fill ^= 1;
+      }
+      else
+      {
+        sense = SENSE::UnrecoveredRead();
+        error = true;
+      }
+    }
+    Kick();
+    if ((pending == NONE) && !len[flight] && (error || (done == total)))
+      Finish(error ? CSW_STATUS::FAILED : CSW_STATUS::PASSED);
+  }
+
+  void Kick()                                 // следующий заполненный буфер в USB
+  {
+    if ((pending == NONE) && len[flight])
+    {
+      pending = flight;
+      flight ^= 1;
+      StartTx(buf[pending], len[pending]);
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // WRITE: USB -> buf[fill], buf[flight] -> носитель
+  //----------------------------------------------------------------------------
+  void StartWrite(uint64_t lba, uint32_t count)
+  {
+    if (dir_in || (expected < uint64_t(count) * block_size)) { Phase(); return; }  // Ho < Do, Hi <> Do
+    if (device.IsWriteProtected()) { Fail(SENSE::WriteProtected()); return; }
+    if (!CheckRange(lba, count)) return;
+    if (!count) { Finish(CSW_STATUS::PASSED); return; }
+    ResetPipe(lba, count);
+    state = STATE::WRITE;
+    PollWrite();
+  }
+
+  void PollWrite()
+  {
+    if ((pending != NONE) && !rx_busy)        // буфер принят
+    {
+      uint32_t n = rx_len;
+      if (n < requested) total = done + n - n % block_size; // хост закончил фазу данных раньше
+      len[pending] = n - n % block_size;
+      done += n;
+      pending = NONE;
+    }
+    if ((pending == NONE) && (done < total) && !len[fill] && (pipelined || !len[fill ^ 1]))
+    {
+      requested = (total - done < buffer_size) ? total - done : buffer_size;
+      pending = fill;
+      fill ^= 1;
+      StartRx(buf[pending], requested);
+    }
+    if (len[flight])                          // запись на носитель, пока принимается следующий
+    {
+      uint32_t n = len[flight] / block_size;
+      if (!error && !device.Write(lba, buf[flight], n))
+      {
+        sense = SENSE::WriteError();
+        error = true;
+      }
+      lba += n;
+      len[flight] = 0;
+      flight ^= 1;
+    }
+    if ((pending == NONE) && !len[0] && !len[1] && (done >= total))
+      Finish(error ? CSW_STATUS::FAILED : CSW_STATUS::PASSED);
+  }
+
+  //----------------------------------------------------------------------------
+  TTransport& transport;
+  TBlockDevice& device;
+
+  STATE state = STATE::STALLED;
+  std::atomic<bool> tx_busy{ false };
+  std::atomic<bool> rx_busy{ false };
+  std::atomic<uint32_t> rx_len{ 0 };
+
+  // Текущая команда
+  uint32_t tag = 0;
+  uint32_t expected = 0;   // dCBWDataTransferLength
+  uint32_t done = 0;       // передано по шине байт
+  bool dir_in = false;
+  uint8_t cb[16]{};
+  SENSE sense = SENSE::NoSense();
+
+  // Конвейер
+  uint64_t lba = 0;
+  uint32_t blocks = 0;     // осталось прочитать с носителя
+  uint32_t total = 0;       // байт в фазе данных
+  uint32_t requested = 0;   // запрошено у транспорта (WRITE)
+  uint32_t len[2]{};       // заполнено байт в буфере
+  uint8_t fill = 0;        // буфер для носителя (READ) / приема (WRITE)
+  uint8_t flight = 0;      // буфер для USB (READ) / носителя (WRITE)
+  int8_t pending = NONE;   // буфер в обмене с USB
+  bool error = false;
+
+  uint8_t inquiry_id[28]{};
+  uint8_t csw[13]{};
+  alignas(4) uint8_t buf[2][buffer_size]{};
+};
+
+} // namespace MSC
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <stddef.h>
+#include <atomic>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+//==============================================================================
+// Трассировка запросов EP0 и событий точек
+//==============================================================================
+// Политика - параметр шаблона EP0::CONTROL, EP0::CONTROL_TASK и
+// USB_EP::ENDPOINTS, по умолчанию NO_TRACE: пустые встроенные функции без
+// состояния, код без трассировки не меняется (при -O1 и выше).
+//
+// RING<size> пишет записи по 16 байт в кольцо в памяти (старые затираются),
+// запись резервируется fetch_add - без блокировок, из прерываний любого
+// приоритета. Время - счетчик тактов (CYCLES): на Cortex-M - DWT->CYCCNT,
+// его должно включить приложение. Транспорт сам пишет NAK через Nak(ep).
+//
+// Кольцо снимается целиком (BUFFER - заголовок и записи подряд), например
+//   (gdb) dump binary value trace.bin USB_TRACE::RING<256>::buffer
+// и разбирается Tools/usb_trace_decode.cpp. Запись, которую снимок застал
+// в середине, может оказаться испорченной
+//==============================================================================
+namespace USB_TRACE
+{
+
+enum class EVENT : uint8_t
+{
+  Setup = 1,        // data - пакет SETUP
+  Descriptor,       // data[0] - тип, data[1] - индекс, value - длина ответа
+  Complete,         // байт передано: data[0..3] (LE), value - то же, не больше 0xFFFF
+  Abort,            // передача снята (сброс шины, новый SETUP)
+  Stall,
+  Nak
+};
+
+struct RECORD
+{
+  uint32_t time;
+  EVENT event;
+  uint8_t ep;
+  uint16_t value;
+  uint8_t data[8];
+};
+static_assert(sizeof(RECORD) == 16, "Trace record is 16 bytes");
+
+constexpr uint32_t MAGIC = 0x54425355;   // "USBT"
+
+template<uint32_t size>
+struct BUFFER
+{
+  static_assert(size && !(size & (size - 1)), "Ring size must be a power of 2");
+
+  uint32_t magic = MAGIC;
+  uint32_t count = size;
+  std::atomic<uint32_t> head{0};        // всего записей, следующая - head % size
+  uint32_t clock_hz = 0;                // частота CYCLES, 0 - неизвестна
+  RECORD records[size]{};
+};
+static_assert(sizeof(std::atomic<uint32_t>) == 4, "Trace header layout");
+
+//==============================================================================
+// Счетчик тактов
+//==============================================================================
+struct CYCLES
+{
+  static uint32_t Now()
+  {
+#if defined(__x86_64__) || defined(__i386__)
+    return uint32_t(__rdtsc());
+#elif defined(__aarch64__)
+    uint64_t t;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(t));
+    return uint32_t(t);
+#elif defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_8M_MAIN__)
+    return *(volatile uint32_t*)0xE0001004;   // DWT->CYCCNT
+#else
+    return 0;
+#endif
+  }
+};
+
+//==============================================================================
+// Политики
+//==============================================================================
+struct NO_TRACE
+{
+  static constexpr bool enabled = false;
+  static void Setup(const uint8_t*) {}
+  static void Descriptor(uint8_t, uint8_t, uint16_t) {}
+  static void Complete(uint8_t, int32_t) {}
+  static void Stall(uint8_t) {}
+  static void Nak(uint8_t) {}
+};
+
+template<uint32_t size, typename TClock = CYCLES>
+struct RING
+{
+  static constexpr bool enabled = true;
+  static inline BUFFER<size> buffer;
+
+  static void Setup(const uint8_t* setup) { Put(EVENT::Setup, 0, 0, setup, 8); }
+
+  static void Descriptor(uint8_t type, uint8_t index, uint16_t length)
+  {
+    const uint8_t data[2] { type, index };
+    Put(EVENT::Descriptor, 0, length, data, 2);
+  }
+
+  // result < 0 - передача снята
+  static void Complete(uint8_t ep, int32_t result)
+  {
+    if (result < 0) { Put(EVENT::Abort, ep, 0, nullptr, 0); return; }
+    const uint8_t data[4] { uint8_t(result), uint8_t(result >> 8), uint8_t(result >> 16), uint8_t(result >> 24) };
+    Put(EVENT::Complete, ep, (result > 0xFFFF) ? 0xFFFF : uint16_t(result), data, 4);
+  }
+
+  static void Stall(uint8_t ep) { Put(EVENT::Stall, ep, 0, nullptr, 0); }
+  static void Nak(uint8_t ep) { Put(EVENT::Nak, ep, 0, nullptr, 0); }
+
+private:
+  static void Put(EVENT event, uint8_t ep, uint16_t value, const uint8_t* data, uint8_t len)
+  {
+    uint32_t time = TClock::Now();
+    RECORD& r = buffer.records[buffer.head.fetch_add(1, std::memory_order_relaxed) & (size - 1)];
+    r.time = time;
+    r.event = event;
+    r.ep = ep;
+    r.value = value;
+    memset(r.data, 0, sizeof(r.data));
+    if (len) memcpy(r.data, data, len);
+  }
+};
+
+} // namespace USB_TRACE
@@ -0,0 +1,129 @@
+// Модель шины по кадрам (Tools/bus_sim.hpp) для конфигураций профилей и
+// вариантов раскладки точек: пропускная способность, задержки по
+// перцентилям и загрузка периодического бюджета за секунды, без стенда.
+//
+//   g++ -std=c++17 -O2 Tools/bus_sim.cpp -o bus_sim
+//   ./bus_sim [seconds] [seed]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <iterator>
+
+#include "../Descriptors/usb_hid_descriptors.hpp"
+#include "../Descriptors/usb_cdc_descriptors.hpp"
+#include "../Descriptors/usb_winusb_descriptors.hpp"
+#include "../Descriptors/usb_msd_descriptors.hpp"
+#include "../Descriptors/usb_uac2_descriptors.hpp"
+#include "../Descriptors/usb_uvc_descriptors.hpp"
+#include "../Descriptors/usb_ncm_descriptors.hpp"
+#include "bus_sim.hpp"
+
+using namespace BUS_SIM;
+
+//==============================================================================
+// Варианты раскладки для сравнения с профилями
+//==============================================================================
+namespace LAYOUTS
+{
+
+using namespace USB_DESCRIPTORS;
+
+// WinUSB на HS: те же 3 пары Bulk, пакеты по 512
+constexpr DEVICE_CONFIGURATION_DESCRIPTOR
+< bConfigurationValue<1>,
+  iConfiguration<0>,
+  bmAttributes<cfg_Attr::SelfPowered>,
+  bMaxPower<100/2>,
+
+  VENDOR_BULK_INTERFACE<bInterfaceNumber<0>, USB_SPEED::HIGH, 3, 1, 4096>
+> WinUsbHighSpeed;
+
+// Отчеты HID по 64 байта с опросом каждый кадр вместо 2 байт раз в 20 мс
+constexpr DEVICE_CONFIGURATION_DESCRIPTOR
+< bConfigurationValue<1>,
+  iConfiguration<0>,
+  bmAttributes<cfg_Attr::SelfPowered>,
+  bMaxPower<100/2>,
+
+  INTERFACE
+  < bInterfaceNumber<0>,
+    bAlternateSetting<0>,
+    bInterfaceClass<3>,
+    bInterfaceSubClass<0>,
+    bInterfaceProtocol<0>,
+    iInterface<0>,
+
+    ENDPOINT_DESCRIPTOR<bEndpointAddress<1, epDIR::IN>, bmAttributes<epTYPE::Interrupt>, wMaxPacketSize<64>, bInterval<1>>,
+    ENDPOINT_DESCRIPTOR<bEndpointAddress<1, epDIR::OUT>, bmAttributes<epTYPE::Interrupt>, wMaxPacketSize<64>, bInterval<1>>
+  >
+> HidFastPolling;
+
+} // namespace LAYOUTS
+
+static double seconds = 10;
+static uint32_t seed = 1;
+
+static void Run(const char* title, SIMULATOR& sim)
+{
+  sim.Run(seconds, seed);
+  printf("%s\n", title);
+  sim.Report(stdout);
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc > 1) seconds = atof(argv[1]);
+  if (argc > 2) seed = atoi(argv[2]);
+  printf("%.1f s simulated per scenario, seed %u\n\n", seconds, seed);
+
+  {
+    SIMULATOR sim(CDC_PROFILE::Configuration_Descriptor, FULL_SPEED_HOST);
+    sim.Traffic(0x01, { MODEL::Saturated, 0, 0 });        // прошивка в порт
+    sim.Traffic(0x81, { MODEL::Poisson, 2000, 64 });      // ответы
+    sim.Traffic(0x82, { MODEL::Poisson, 10, 8 });         // SERIAL_STATE
+    Run("CDC FS: OUT saturated, IN 2000 x 64 B/s Poisson", sim);
+  }
+  {
+    SIMULATOR sim(MSD_PROFILE::Configuration_Descriptor, FULL_SPEED_HOST);
+    sim.Alternate(0, 0);                                  // BOT
+    sim.Traffic(0x81, { MODEL::Saturated, 0, 0 });
+    Run("\nMSD FS BOT: READ saturated", sim);
+  }
+  for (int hs = 0; hs < 2; ++hs)
+  {
+    SIMULATOR sim = hs ? SIMULATOR(LAYOUTS::WinUsbHighSpeed, HIGH_SPEED_HOST)
+                       : SIMULATOR(WINUSB_PROFILE::Configuration_Descriptor, FULL_SPEED_HOST);
+    for (uint8_t ep : { 0x81, 0x82, 0x83 }) sim.Traffic(ep, { MODEL::Saturated, 0, 0 });
+    Run(hs ? "\nWinUSB HS layout: 3 IN stripes saturated" : "\nWinUSB FS: 3 IN stripes saturated", sim);
+  }
+  for (int fast = 0; fast < 2; ++fast)
+  {
+    SIMULATOR sim = fast ? SIMULATOR(LAYOUTS::HidFastPolling, FULL_SPEED_HOST)
+                         : SIMULATOR(HID_PROFILE::Configuration_Descriptor, FULL_SPEED_HOST);
+    const uint32_t report = fast ? 64 : 2;
+    sim.Traffic(0x81, { MODEL::Poisson, 30, report });
+    sim.Traffic(0x01, { MODEL::Poisson, 5, report });
+    Run(fast ? "\nHID 64 B, bInterval 1: 30 reports/s Poisson" : "\nHID profile: 30 reports/s Poisson", sim);
+  }
+  {
+    SIMULATOR sim(UAC2_PROFILE::Configuration_Descriptor, HIGH_SPEED_HOST);
+    sim.Traffic(0x01, { MODEL::Constant, 8000, 192 });    // 192 кГц, 2 канала, 4 байта
+    sim.Traffic(0x81, { MODEL::Constant, 1000, 4 });      // feedback
+    Run("\nUAC2 HS: 192 kHz stereo stream", sim);
+  }
+  for (uint8_t alt : { 2, 4 })
+  {
+    SIMULATOR sim(UVC_PROFILE::Configuration_Descriptor, HIGH_SPEED_HOST);
+    sim.Alternate(1, alt);
+    sim.Traffic(0x81, { MODEL::Constant, 30, 1280 * 720 * 2 / 4 });  // MJPEG 720p30
+    Run(alt == 2 ? "\nUVC HS alt 2: MJPEG 1280x720 30 fps" : "\nUVC HS alt 4: MJPEG 1280x720 30 fps", sim);
+  }
+  {
+    SIMULATOR sim(NCM_PROFILE::Configuration_Descriptor, HIGH_SPEED_HOST);
+    sim.Traffic(0x01, { MODEL::Saturated, 0, 0 });
+    sim.Traffic(0x81, { MODEL::Poisson, 4000, 1514 });    // кадры Ethernet
+    sim.Traffic(0x82, { MODEL::Poisson, 1, 16 });
+    Run("\nNCM HS: OUT saturated, IN 4000 frames/s", sim);
+  }
+  return 0;
+}
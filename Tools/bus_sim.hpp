@@ -0,0 +1,367 @@
+#pragma once
+
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+#include <map>
+#include <random>
+#include <vector>
+#include <algorithm>
+
+#if (__cplusplus > 201703L)
+#include "../Descriptors/C++20/usb_descriptors.hpp"
+#else
+#include "../Descriptors/C++17/usb_descriptors.h"
+#endif
+#include "../Device/usb_descriptor_view.hpp"
+
+//==============================================================================
+// Планирование шины по кадрам: дискретно-событийная модель одной конфигурации
+//==============================================================================
+// Точки берутся из байтов конфигурации (USB_VIEW), время транзакций - формулы
+// BUS_TIME библиотеки, период опроса - POLLING. Хост в каждом (микро)кадре:
+//   SOF, затем периодические транзакции точек, чей опрос выпал на кадр, в
+//   пределах бюджета (90% FS, 80% HS), затем Bulk по кругу до конца кадра.
+// Bulk IN без данных отвечает NAK и занимает шину; если весь круг - NAK, хост
+// продолжает опрос до следующего поступления данных (время идет в NAK).
+// Источник данных точки - TRAFFIC (IN - устройство, OUT - хост), приемник
+// всегда готов. Сообщение длиннее пакета идет несколькими транзакциями,
+// задержка - от поступления сообщения до конца его последней транзакции
+//==============================================================================
+namespace BUS_SIM
+{
+
+using USB_DESCRIPTORS::epTYPE;
+using USB_DESCRIPTORS::USB_SPEED;
+
+enum class MODEL : uint8_t
+{
+  Idle,
+  Saturated,     // данные есть всегда
+  Constant,      // сообщение каждые 1/rate с
+  Poisson        // поток Пуассона со средней частотой rate
+};
+
+struct TRAFFIC
+{
+  MODEL model;
+  double rate;       // сообщений/с
+  uint32_t size;     // байт в сообщении
+};
+
+struct HOST
+{
+  USB_SPEED speed;
+  uint32_t host_delay;    // нс на транзакцию, как у PERIODIC_BANDWIDTH
+  bool balance;           // фазы периодических точек разносятся по кадрам
+};
+
+constexpr HOST FULL_SPEED_HOST { USB_SPEED::FULL, 1000, true };
+constexpr HOST HIGH_SPEED_HOST { USB_SPEED::HIGH, 5, true };
+
+struct ENDPOINT
+{
+  uint8_t address;
+  uint8_t interface, alternate;
+  epTYPE type;
+  uint16_t mps;
+  uint8_t mult;           // транзакций за микрокадр (HS high-bandwidth)
+  uint32_t period;        // (микро)кадров между опросами
+  uint32_t phase;
+  TRAFFIC traffic;
+
+  // Результат
+  uint64_t bytes, packets, naks, messages;
+  uint64_t backlog;       // сообщений в очереди в конце
+  double p50, p90, p99, max;   // задержка, мкс
+  double throughput;      // байт/с
+
+  bool IsIn() const { return address & 0x80; }
+  bool IsPeriodic() const { return (type == epTYPE::Interrupt) || (type == epTYPE::Isochronous); }
+};
+
+class SIMULATOR
+{
+public:
+  template<typename TConfiguration>
+  SIMULATOR(const TConfiguration& cfg, HOST host) : SIMULATOR(cfg.buf, uint16_t(sizeof(cfg.buf)), host) {}
+
+  SIMULATOR(const uint8_t* cfg, uint16_t size, HOST host) : cfg(cfg), size(size), host(host)
+  {
+    // По умолчанию у каждого интерфейса - старшая альтернативная настройка (поток включен)
+    for (auto itf : USB_VIEW::Descriptors<USB_VIEW::InterfaceView>(cfg, size))
+      alternate[itf.Number()] = std::max(alternate[itf.Number()], itf.AlternateSetting());
+  }
+
+  void Alternate(uint8_t itf, uint8_t alt) { alternate[itf] = alt; }
+  void Traffic(uint8_t address, TRAFFIC t) { traffic[address] = t; }
+
+  // Длительность (микро)кадра, нс
+  uint32_t FrameTime() const { return (host.speed == USB_SPEED::FULL) ? 1'000'000 : 125'000; }
+  uint32_t Budget() const { return FrameTime() / 10 * ((host.speed == USB_SPEED::FULL) ? 9 : 8); }
+
+  void Run(double seconds, uint32_t seed = 1)
+  {
+    Build();
+    rng.seed(seed);
+    std::vector<QUEUE> queues(endpoints.size());
+    for (size_t i = 0; i < endpoints.size(); ++i) queues[i].next = FirstArrival(endpoints[i].traffic);
+
+    frames = uint64_t(seconds * 1e9 / FrameTime());
+    periodic_max = periodic_sum = bulk_sum = nak_sum = overruns = 0;
+    const double sof = (host.speed == USB_SPEED::FULL) ? 2917 : 200;   // SOF: 35 бит FS, 96 бит HS
+    std::vector<size_t> bulk_eps;
+    for (size_t i = 0; i < endpoints.size(); ++i)
+      if (endpoints[i].type == epTYPE::Bulk) bulk_eps.push_back(i);
+    size_t bulk_next = 0;     // Bulk точка, с которой продолжится круг
+
+    for (uint64_t frame = 0; frame < frames; ++frame)
+    {
+      double start = double(frame) * FrameTime(), end = start + FrameTime();
+      double t = start + sof;
+
+      // Периодические: опрос по фазе, в пределах бюджета
+      double periodic = 0;
+      for (size_t i = 0; i < endpoints.size(); ++i)
+      {
+        auto& ep = endpoints[i];
+        if (!ep.IsPeriodic() || ((frame % ep.period) != ep.phase)) continue;
+        for (uint8_t k = 0; k < ep.mult; ++k)
+        {
+          Arrivals(queues[i], ep, t);
+          uint32_t n = Pending(queues[i], ep);
+          if (!n && !ep.IsIn()) break;                           // хосту нечего передать
+          double cost = Transaction(ep.type, ep.IsIn(), n);
+          if (periodic + cost > Budget()) { ++overruns; break; }
+          periodic += cost;
+          t += cost;
+          if (n) Deliver(queues[i], ep, n, t);
+          else if (ep.type == epTYPE::Interrupt) ++ep.naks;   // NAK, у Isochronous - пакет нулевой длины
+          else if (ep.IsIn()) ++ep.packets;
+          if (n < ep.mps) break;
+        }
+      }
+      periodic_sum += periodic;
+      periodic_max = std::max(periodic_max, periodic);
+
+      // Bulk по кругу до конца кадра
+      double bulk = 0, nak = 0;
+      while (!bulk_eps.empty())
+      {
+        bool progress = false, any = false, full = false;
+        double round_nak = 0;
+        // Круг начинается с точки, до которой не дошла очередь в прошлый раз
+        for (size_t j = 0; j < bulk_eps.size(); ++j, bulk_next = (bulk_next + 1) % bulk_eps.size())
+        {
+          size_t i = bulk_eps[bulk_next];
+          auto& ep = endpoints[i];
+          Arrivals(queues[i], ep, t);
+          uint32_t n = Pending(queues[i], ep);
+          if (!n && !ep.IsIn()) continue;          // хосту нечего передать
+          any = true;
+          double cost = Transaction(ep.type, ep.IsIn(), n);
+          if (t + cost > end) { full = true; break; }
+          t += cost;
+          if (n) { Deliver(queues[i], ep, n, t); bulk += cost; progress = true; }
+          else { ++ep.naks; nak += cost; round_nak += cost; }
+        }
+        if (full) break;
+        if (!progress)
+        {
+          // Круг пустой или из одних NAK: до поступления данных или конца кадра
+          double next = end;
+          for (size_t i : bulk_eps) next = std::min(next, queues[i].next);
+          if (next <= t) continue;
+          if (!any)
+          {
+            if (next >= end) break;
+            t = next;
+            continue;
+          }
+          uint64_t rounds = uint64_t((next - t) / round_nak);
+          for (size_t i : bulk_eps)
+            if (endpoints[i].IsIn() && !Pending(queues[i], endpoints[i])) endpoints[i].naks += rounds;
+          nak += rounds * round_nak;
+          t += rounds * round_nak;
+          if (t + round_nak > end) break;
+        }
+      }
+      bulk_sum += bulk;
+      nak_sum += nak;
+    }
+
+    for (size_t i = 0; i < endpoints.size(); ++i) Finish(queues[i], endpoints[i], seconds);
+  }
+
+  const std::vector<ENDPOINT>& Endpoints() const { return endpoints; }
+
+  // Доли кадра, %
+  double PeriodicUtilization() const { return frames ? periodic_sum / frames * 100 / FrameTime() : 0; }
+  double PeriodicPeak() const { return periodic_max * 100 / FrameTime(); }
+  double BulkUtilization() const { return frames ? bulk_sum / frames * 100 / FrameTime() : 0; }
+  double NakUtilization() const { return frames ? nak_sum / frames * 100 / FrameTime() : 0; }
+  uint64_t Overruns() const { return overruns; }
+
+  void Report(FILE* f) const
+  {
+    fprintf(f, "  EP  if/alt  type  mps x  period us  traffic          MB/s   packets     NAKs  msgs   p50 us   p90 us   p99 us   max us\n");
+    for (auto& ep : endpoints)
+    {
+      static const char* types[] { "ctrl", "iso ", "bulk", "int " };
+      static const char* models[] { "idle", "saturated", "constant", "poisson" };
+      char traffic[24];
+      if ((ep.traffic.model == MODEL::Idle) || (ep.traffic.model == MODEL::Saturated)) snprintf(traffic, sizeof(traffic), "%s", models[uint8_t(ep.traffic.model)]);
+      else snprintf(traffic, sizeof(traffic), "%s %gx%u", models[uint8_t(ep.traffic.model)], ep.traffic.rate, ep.traffic.size);
+      fprintf(f, "  %.2X  %2u/%-3u  %s %4u x%u  %9.0f  %-14s %7.3f %9llu %8llu %5llu", ep.address, ep.interface, ep.alternate,
+              types[uint8_t(ep.type)], ep.mps, ep.mult, double(ep.period) * FrameTime() / 1000, traffic, ep.throughput / 1e6,
+              (unsigned long long)ep.packets, (unsigned long long)ep.naks, (unsigned long long)ep.messages);
+      if (ep.messages && (ep.traffic.model != MODEL::Saturated)) fprintf(f, " %8.1f %8.1f %8.1f %8.1f", ep.p50, ep.p90, ep.p99, ep.max);
+      if (ep.backlog) fprintf(f, "  backlog %llu", (unsigned long long)ep.backlog);
+      fprintf(f, "\n");
+    }
+    fprintf(f, "  Frame: periodic %.1f%% (peak %.1f%%, budget %u%%), bulk %.1f%%, NAK %.1f%%%s\n",
+            PeriodicUtilization(), PeriodicPeak(), Budget() * 100 / FrameTime(), BulkUtilization(), NakUtilization(),
+            overruns ? ", PERIODIC BUDGET OVERRUN" : "");
+  }
+
+private:
+  struct QUEUE
+  {
+    std::vector<double> arrivals;  // время поступления сообщений в очереди
+    size_t head = 0;
+    uint32_t sent = 0;             // байт головного сообщения передано
+    double next = 0;               // следующее поступление, нс
+    std::vector<double> latency;   // мкс
+  };
+
+  void Build()
+  {
+    endpoints.clear();
+    int8_t itf = -1, alt = 0;
+    for (auto d : USB_VIEW::CONFIGURATION_BLOB(cfg, size))
+    {
+      if (USB_VIEW::InterfaceView::Match(d)) { USB_VIEW::InterfaceView v(d); itf = int8_t(v.Number()); alt = int8_t(v.AlternateSetting()); }
+      if (!USB_VIEW::EndpointView::Match(d) || (itf < 0) || (alternate[uint8_t(itf)] != alt)) continue;
+      USB_VIEW::EndpointView v(d);
+      ENDPOINT ep{};
+      ep.address = v.Address();
+      ep.interface = uint8_t(itf);
+      ep.alternate = uint8_t(alt);
+      ep.type = v.TransferType();
+      ep.mps = v.MaxPacketSize();
+      ep.mult = (host.speed == USB_SPEED::HIGH) && ep.IsPeriodic() ? v.Transactions() : 1;
+      ep.period = ep.IsPeriodic() ? Period(ep.type, v.Interval()) : 1;
+      auto it = traffic.find(ep.address);
+      ep.traffic = (it != traffic.end()) ? it->second : TRAFFIC { MODEL::Idle, 0, 0 };
+      endpoints.push_back(ep);
+    }
+    // Фазы: каждая периодическая точка - в наименее занятый кадр своего периода
+    std::vector<double> load(1024, 0);
+    for (auto& ep : endpoints)
+    {
+      if (!ep.IsPeriodic()) continue;
+      uint32_t period = std::min<uint32_t>(ep.period, uint32_t(load.size()));
+      ep.phase = 0;
+      if (host.balance)
+        for (uint32_t p = 1; p < period; ++p)
+          if (Load(load, p, period) < Load(load, ep.phase, period)) ep.phase = p;
+      double cost = ep.mult * Transaction(ep.type, ep.IsIn(), ep.mps);
+      for (uint32_t f = ep.phase; f < load.size(); f += period) load[f] += cost;
+    }
+  }
+
+  static double Load(const std::vector<double>& load, uint32_t phase, uint32_t period)
+  {
+    double m = 0;
+    for (uint32_t f = phase; f < load.size(); f += period) m = std::max(m, load[f]);
+    return m;
+  }
+
+  uint32_t Period(epTYPE type, uint8_t interval) const
+  {
+    using namespace USB_DESCRIPTORS;
+    uint32_t us;
+    if (host.speed == USB_SPEED::FULL)
+      us = (type == epTYPE::Interrupt) ? POLLING<epTYPE::Interrupt, USB_SPEED::FULL>::Period(interval)
+                                       : POLLING<epTYPE::Isochronous, USB_SPEED::FULL>::Period(interval);
+    else
+      us = (type == epTYPE::Interrupt) ? POLLING<epTYPE::Interrupt, USB_SPEED::HIGH>::Period(interval)
+                                       : POLLING<epTYPE::Isochronous, USB_SPEED::HIGH>::Period(interval);
+    return std::max<uint32_t>(1, us * 1000 / FrameTime());
+  }
+
+  double Transaction(epTYPE type, bool in, uint32_t bytes) const
+  {
+    using USB_DESCRIPTORS::BUS_TIME;
+    return (host.speed == USB_SPEED::FULL) ? BUS_TIME::FullSpeed(type, in, bytes, host.host_delay)
+                                           : BUS_TIME::HighSpeed(type, bytes, host.host_delay);
+  }
+
+  double Interval(const TRAFFIC& t)
+  {
+    if (t.model == MODEL::Poisson) return std::exponential_distribution<double>(t.rate)(rng) * 1e9;
+    return 1e9 / t.rate;
+  }
+
+  double FirstArrival(const TRAFFIC& t)
+  {
+    if ((t.model == MODEL::Idle) || (t.model == MODEL::Saturated) || (t.rate <= 0) || !t.size) return INFINITY;
+    return Interval(t);
+  }
+
+  void Arrivals(QUEUE& q, const ENDPOINT& ep, double t)
+  {
+    while (q.next <= t)
+    {
+      q.arrivals.push_back(q.next);
+      q.next += Interval(ep.traffic);
+    }
+  }
+
+  static uint32_t Pending(const QUEUE& q, const ENDPOINT& ep)
+  {
+    if (ep.traffic.model == MODEL::Saturated) return ep.mps;
+    if (q.head == q.arrivals.size()) return 0;
+    return std::min<uint32_t>(ep.mps, ep.traffic.size - q.sent);
+  }
+
+  void Deliver(QUEUE& q, ENDPOINT& ep, uint32_t n, double t)
+  {
+    ep.bytes += n;
+    ++ep.packets;
+    if (ep.traffic.model == MODEL::Saturated) { ++ep.messages; return; }
+    q.sent += n;
+    if (q.sent < ep.traffic.size) return;
+    q.latency.push_back((t - q.arrivals[q.head]) / 1000);
+    ++ep.messages;
+    q.sent = 0;
+    if (++q.head > 4096) { q.arrivals.erase(q.arrivals.begin(), q.arrivals.begin() + q.head); q.head = 0; }
+  }
+
+  static void Finish(QUEUE& q, ENDPOINT& ep, double seconds)
+  {
+    ep.throughput = ep.bytes / seconds;
+    ep.backlog = q.arrivals.size() - q.head;
+    auto& l = q.latency;
+    if (l.empty()) return;
+    std::sort(l.begin(), l.end());
+    auto at = [&](double p) { return l[std::min(l.size() - 1, size_t(p * l.size()))]; };
+    ep.p50 = at(0.50);
+    ep.p90 = at(0.90);
+    ep.p99 = at(0.99);
+    ep.max = l.back();
+  }
+
+  const uint8_t* cfg;
+  uint16_t size;
+  HOST host;
+  uint8_t alternate[256]{};
+  std::map<uint8_t, TRAFFIC> traffic;
+  std::vector<ENDPOINT> endpoints;
+  std::mt19937_64 rng;
+
+  uint64_t frames = 0, overruns = 0;
+  double periodic_sum = 0, periodic_max = 0, bulk_sum = 0, nak_sum = 0;
+};
+
+} // namespace BUS_SIM
@@ -0,0 +1,196 @@
+// Разбор и проверка готовых байтов конфигурации (Device/usb_descriptor_view.hpp)
+// на корпусе: конфигурации всех профилей, размноженные до заданного числа,
+// каждая K-я испорчена одной из типовых ошибок. Скорость Validate, обхода
+// типизированными представлениями и ручного цикла по bLength для сравнения.
+//
+//   g++ -std=c++17 -O2 Tools/descriptor_view_bench.cpp -o descriptor_view_bench
+//   ./descriptor_view_bench [configurations] [every K-th corrupted] [passes]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <iterator>
+#include <chrono>
+#include <vector>
+
+#include "../Descriptors/usb_hid_descriptors.hpp"
+#include "../Descriptors/usb_cdc_descriptors.hpp"
+#include "../Descriptors/usb_2cdc_descriptors.hpp"
+#include "../Descriptors/usb_winusb_descriptors.hpp"
+#include "../Descriptors/usb_msd_descriptors.hpp"
+#include "../Descriptors/usb_uac2_descriptors.hpp"
+#include "../Descriptors/usb_uvc_descriptors.hpp"
+#include "../Descriptors/usb_ncm_descriptors.hpp"
+#include "../Descriptors/usb_dfu_descriptors.hpp"
+#include "../Device/usb_descriptor_view.hpp"
+
+using namespace USB_VIEW;
+
+//==============================================================================
+// Образцы
+//==============================================================================
+struct SAMPLE
+{
+  const char* name;
+  const uint8_t* data;
+  uint16_t size;
+};
+
+template<typename T>
+static constexpr SAMPLE Sample(const char* name, const T& cfg) { return { name, cfg.buf, uint16_t(sizeof(cfg.buf)) }; }
+
+static const SAMPLE Samples[] =
+{
+  Sample("HID", HID_PROFILE::Configuration_Descriptor),
+  Sample("CDC", CDC_PROFILE::Configuration_Descriptor),
+  Sample("CDCx2", CDCx2_PROFILE::Configuration_Descriptor),
+  Sample("WinUSB", WINUSB_PROFILE::Configuration_Descriptor),
+  Sample("MSD", MSD_PROFILE::Configuration_Descriptor),
+  Sample("UAC2", UAC2_PROFILE::Configuration_Descriptor),
+  Sample("UVC", UVC_PROFILE::Configuration_Descriptor),
+  Sample("NCM", NCM_PROFILE::Configuration_Descriptor),
+  Sample("DFU", DFU_PROFILE::Configuration_Descriptor)
+};
+
+//==============================================================================
+// Порча: у каждой - ожидаемая ошибка
+//==============================================================================
+static uint16_t Find(const uint8_t* p, uint16_t size, DescriptorType type, uint16_t from = 0)
+{
+  for (uint16_t i = from; i < size; i += p[i])
+    if (p[i + 1] == uint8_t(type)) return i;
+  return 0xFFFF;
+}
+
+// Возвращает ожидаемую ошибку или None, если у образца нечего портить
+static VIEW_ERROR Corrupt(uint8_t* p, uint16_t size, uint32_t kind)
+{
+  uint16_t itf = Find(p, size, DescriptorType::INTERFACE);
+  uint16_t ep = Find(p, size, DescriptorType::ENDPOINT);
+  switch (kind % 5)
+  {
+    case 0: ++p[2]; return VIEW_ERROR::TotalLength;
+    case 1: ++p[4]; return VIEW_ERROR::NumInterfaces;
+    case 2: ++p[itf + 4]; return VIEW_ERROR::NumEndpoints;
+    case 3: p[itf] = 1; return VIEW_ERROR::DescriptorLength;
+    default:
+    {
+      if (ep == 0xFFFF) return VIEW_ERROR::None;
+      uint16_t next = Find(p, size, DescriptorType::ENDPOINT, ep + p[ep]);
+      // Вторая точка той же настройки получает адрес первой
+      if ((next == 0xFFFF) || (Find(p, size, DescriptorType::INTERFACE, ep) < next)) return VIEW_ERROR::None;
+      p[next + 2] = p[ep + 2];
+      return VIEW_ERROR::DuplicateEndpoint;
+    }
+  }
+}
+
+struct UNIT
+{
+  uint32_t offset;
+  uint16_t size;
+  VIEW_ERROR expected;
+};
+
+//==============================================================================
+// Обходы
+//==============================================================================
+// Типизированный: точки, их пакеты, Union CDC - за один проход
+static uint32_t TypedWalk(const uint8_t* p, uint16_t size)
+{
+  uint32_t sum = 0;
+  for (auto d : CONFIGURATION_BLOB(p, size))
+  {
+    if (EndpointView::Match(d)) { EndpointView ep(d); sum += ep.MaxPacketSize() + ep.IsIn(); }
+    else if (InterfaceView::Match(d)) sum += InterfaceView(d).NumEndpoints();
+    else if (CdcUnionView::Match(d)) sum += CdcUnionView(d).SubordinateInterface(0);
+  }
+  return sum;
+}
+
+// То же ручным циклом по смещениям, как до представлений
+static uint32_t RawWalk(const uint8_t* p, uint16_t size)
+{
+  uint32_t sum = 0;
+  uint8_t if_class = 0;
+  for (uint16_t i = 0; (i + 2 <= size) && (p[i] >= 2) && (p[i] <= size - i); i += p[i])
+  {
+    switch (DescriptorType(p[i + 1]))
+    {
+      case DescriptorType::ENDPOINT: sum += ((p[i + 4] | (p[i + 5] << 8)) & 0x7FF) + (p[i + 2] >> 7); break;
+      case DescriptorType::INTERFACE: if_class = p[i + 5]; sum += p[i + 4]; break;
+      case DescriptorType::CS_INTERFACE: if ((if_class == 2) && (p[i + 2] == 6)) sum += p[i + 4]; break;
+      default: break;
+    }
+  }
+  return sum;
+}
+
+using CLOCK = std::chrono::steady_clock;
+
+static double Since(CLOCK::time_point t0) { return std::chrono::duration<double>(CLOCK::now() - t0).count(); }
+
+int main(int argc, char* argv[])
+{
+  uint32_t units = (argc > 1) ? atoi(argv[1]) : 100000;
+  uint32_t every = (argc > 2) ? atoi(argv[2]) : 7;
+  uint32_t passes = (argc > 3) ? atoi(argv[3]) : 20;
+  if (!every) every = 1;
+
+  for (auto& s : Samples)
+  {
+    auto v = Validate(s.data, s.size);
+    printf("%-7s %4u bytes %s\n", s.name, s.size, v.Ok() ? "ok" : "INVALID");
+    if (!v.Ok()) return 1;
+  }
+
+  // Корпус одним буфером, как пришел бы с шины или из файла
+  std::vector<uint8_t> corpus;
+  std::vector<UNIT> index;
+  uint32_t corrupted = 0;
+  for (uint32_t i = 0; i < units; ++i)
+  {
+    auto& s = Samples[i % std::size(Samples)];
+    UNIT u { uint32_t(corpus.size()), s.size, VIEW_ERROR::None };
+    corpus.insert(corpus.end(), s.data, s.data + s.size);
+    if (!(i % every)) u.expected = Corrupt(&corpus[u.offset], u.size, i / every);
+    if (u.expected != VIEW_ERROR::None) ++corrupted;
+    index.push_back(u);
+  }
+  printf("Corpus %u configurations, %zu bytes, %u corrupted\n", units, corpus.size(), corrupted);
+
+  // Каждая испорченная найдена именно своей ошибкой, целые - без ошибок
+  uint32_t wrong = 0;
+  for (auto& u : index)
+    if (Validate(&corpus[u.offset], u.size).error != u.expected) ++wrong;
+  if (wrong) { printf("Validate: %u configurations misclassified\n", wrong); return 1; }
+
+  double bytes = double(corpus.size()) * passes;
+  double count = double(units) * passes;
+  volatile uint32_t sink = 0;
+
+  auto t0 = CLOCK::now();
+  uint32_t invalid = 0;
+  for (uint32_t n = 0; n < passes; ++n)
+    for (auto& u : index) invalid += !Validate(&corpus[u.offset], u.size).Ok();
+  double s = Since(t0);
+  sink = invalid;
+  printf("Validate   %8.1f MB/s %7.1f ns per configuration\n", bytes / s / 1e6, s / count * 1e9);
+
+  uint32_t typed = 0, raw = 0;
+  t0 = CLOCK::now();
+  for (uint32_t n = 0; n < passes; ++n)
+    for (auto& u : index) typed += TypedWalk(&corpus[u.offset], u.size);
+  s = Since(t0);
+  printf("Typed walk %8.1f MB/s %7.1f ns per configuration\n", bytes / s / 1e6, s / count * 1e9);
+
+  t0 = CLOCK::now();
+  for (uint32_t n = 0; n < passes; ++n)
+    for (auto& u : index) raw += RawWalk(&corpus[u.offset], u.size);
+  s = Since(t0);
+  printf("Raw walk   %8.1f MB/s %7.1f ns per configuration\n", bytes / s / 1e6, s / count * 1e9);
+
+  sink = sink + typed;
+  if (typed != raw) { printf("Typed and raw walks disagree: %u / %u\n", typed, raw); return 1; }
+  return 0;
+}
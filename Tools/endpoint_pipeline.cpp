@@ -0,0 +1,244 @@
+// Точки CDC как объекты с co_await (Device/usb_endpoint_async.hpp): эхо с
+// двумя приемами в очереди и SERIAL_STATE на Interrupt точке против хоста,
+// который режет сообщения на пакеты и собирает ответ обратно по коротким
+// пакетам - без ZLP соседние ответы слились бы. Куча не используется.
+//
+//   g++ -std=c++20 -O2 Tools/endpoint_pipeline.cpp -o endpoint_pipeline
+//   ./endpoint_pipeline [rounds]
+//
+// Запись в OUT точку не компилируется:
+//   g++ -std=c++20 -DMISUSE Tools/endpoint_pipeline.cpp
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <new>
+#include <chrono>
+#include <iterator>
+
+#include "../Descriptors/usb_cdc_descriptors.hpp"
+#include "../Device/usb_ep0_coroutine.hpp"
+#include "../Device/usb_endpoint_async.hpp"
+
+//==============================================================================
+// Счетчик обращений к куче
+//==============================================================================
+static size_t heap_calls = 0;
+
+void* operator new(size_t size)
+{
+  ++heap_calls;
+  if (void* p = malloc(size ? size : 1)) return p;
+  throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+//==============================================================================
+// Транспорт: один пакет в работе на точку, события подает хост
+//==============================================================================
+struct TRANSPORT
+{
+  struct PENDING
+  {
+    const uint8_t* tx;
+    uint8_t* rx;
+    uint32_t len;
+    bool busy;
+  };
+  PENDING ep[32]{};
+  uint32_t overlaps = 0;        // пакет поставлен поверх незавершенного
+
+  static uint8_t Index(uint8_t address) { return (address & 0x0F) | ((address & 0x80) >> 3); }
+
+  void Transmit(uint8_t address, const uint8_t* buf, uint32_t len) { Set(address, { buf, nullptr, len, true }); }
+  void Receive(uint8_t address, uint8_t* buf, uint32_t len) { Set(address, { nullptr, buf, len, true }); }
+
+  void Set(uint8_t address, PENDING p)
+  {
+    PENDING& e = ep[Index(address)];
+    overlaps += e.busy;
+    e = p;
+  }
+};
+
+using ENDPOINTS = USB_EP::ENDPOINTS<decltype(CDC_PROFILE::Configuration_Descriptor), TRANSPORT>;
+
+//==============================================================================
+// Приложение: сопрограммы с кадрами в самом объекте
+//==============================================================================
+struct APP
+{
+  static constexpr size_t frame_size = 512;
+
+  explicit APP(ENDPOINTS& eps) : eps(eps) {}
+  ~APP() { if (echo.handle) echo.handle.destroy(); }
+
+  void Start() { echo = Echo(); }
+
+  // Память кадра для EP0::TASK::promise_type
+  void* Frame(size_t size)
+  {
+    frame_used = size;
+    return (size <= frame_size) ? frame : nullptr;
+  }
+
+  // Прием в два буфера: пока ответ уходит, следующее сообщение уже
+  // принимается. После каждой пары - SERIAL_STATE (10 байт): пакеты 8 + 2, без ZLP
+  EP0::TASK Echo()
+  {
+    static constexpr uint8_t serial_state[10] { 0xA1, 0x20, 0, 0, 0, 0, 2, 0, 0x03, 0x00 };
+    auto& out = eps.Get<0x01>();
+    auto& in = eps.Get<0x81>();
+    auto& irq = eps.Get<0x82>();
+    for (;;)
+    {
+      auto r0 = out.Read(buf[0]);
+      auto r1 = out.Read(buf[1]);
+      int32_t n0 = co_await r0;
+      if (n0 < 0) co_return;
+      auto w0 = in.Write({ buf[0], size_t(n0) });
+      int32_t n1 = co_await r1;
+      if (n1 < 0) co_return;
+      auto w1 = in.Write({ buf[1], size_t(n1) });
+      auto s = irq.Write(serial_state);
+      if ((co_await w0 < 0) || (co_await w1 < 0) || (co_await s < 0)) co_return;
+      messages += 2;
+    }
+  }
+
+  ENDPOINTS& eps;
+  EP0::TASK echo;
+  uint8_t buf[2][1024];
+  uint32_t messages = 0;
+  alignas(std::max_align_t) uint8_t frame[frame_size];
+  size_t frame_used = 0;
+};
+
+#if defined(MISUSE)
+static void Misuse(ENDPOINTS& eps, uint8_t* data)
+{
+  (void)eps.Get<0x01>().Write({ data, 1 });           // OUT точка: Write нет
+  (void)eps.Get<0x05>();                               // нет такой точки
+}
+#endif
+
+//==============================================================================
+// Хост: сообщения пакетами по 64 с ZLP, ответы - до короткого пакета
+//==============================================================================
+constexpr uint16_t Messages[] = { 1, 63, 64, 65, 128, 200, 512, 1000, 0, 7, 192, 64 };
+
+struct HOST
+{
+  TRANSPORT& t;
+  ENDPOINTS& eps;
+  uint8_t tx[sizeof(Messages) / sizeof(Messages[0])][1024];
+  uint8_t rx[1024];
+  uint32_t rx_len = 0;
+  uint32_t replies = 0, errors = 0, packets = 0, irq_packets = 0, irq_bytes = 0;
+
+  HOST(TRANSPORT& t, ENDPOINTS& eps) : t(t), eps(eps)
+  {
+    for (size_t m = 0; m < std::size(Messages); ++m)
+      for (uint32_t i = 0; i < Messages[m]; ++i) tx[m][i] = uint8_t(m * 31 + i);
+  }
+
+  // Ответ на сообщение replies закончен коротким пакетом
+  void Reply()
+  {
+    size_t m = replies % std::size(Messages);
+    if ((rx_len != Messages[m]) || memcmp(rx, tx[m], rx_len)) ++errors;
+    ++replies;
+    rx_len = 0;
+  }
+
+  // Одно сообщение пакетами; пока точка не готова принять - обслуживает IN
+  void Send(size_t m)
+  {
+    uint32_t sent = 0;
+    bool last;
+    do
+    {
+      TRANSPORT::PENDING& out = t.ep[TRANSPORT::Index(0x01)];
+      while (!out.busy) if (!Poll()) { ++errors; return; }
+      uint32_t n = Messages[m] - sent;
+      if (n > 64) n = 64;
+      if (n > out.len) { ++errors; return; }            // переполнение буфера
+      memcpy(out.rx, tx[m] + sent, n);
+      sent += n;
+      last = (n < 64);
+      out.busy = false;
+      ++packets;
+      eps.OnReceived(0x01, n);
+    } while (!last);
+  }
+
+  // Забрать пакет IN, false - ничего нет
+  bool Poll()
+  {
+    TRANSPORT::PENDING& in = t.ep[TRANSPORT::Index(0x81)];
+    TRANSPORT::PENDING& irq = t.ep[TRANSPORT::Index(0x82)];
+    if (in.busy)
+    {
+      if (rx_len + in.len > sizeof(rx)) { ++errors; rx_len = 0; }
+      memcpy(rx + rx_len, in.tx, in.len);
+      rx_len += in.len;
+      in.busy = false;
+      ++packets;
+      bool shortp = in.len < 64;
+      eps.OnTransmitted(0x81);
+      if (shortp) Reply();
+      return true;
+    }
+    if (irq.busy)
+    {
+      irq.busy = false;
+      ++irq_packets;
+      irq_bytes += irq.len;
+      eps.OnTransmitted(0x82);
+      return true;
+    }
+    return false;
+  }
+
+  void Round()
+  {
+    for (size_t m = 0; m < std::size(Messages); ++m) Send(m);
+    while (Poll()) {}
+  }
+};
+
+int main(int argc, char* argv[])
+{
+  uint32_t rounds = (argc > 1) ? atoi(argv[1]) : 100000;
+  size_t heap_before = heap_calls;
+
+  TRANSPORT t;
+  ENDPOINTS eps(t);
+  APP app(eps);
+  HOST host(t, eps);
+  app.Start();
+  if (!app.echo.handle) { printf("Coroutine frame %zu bytes does not fit\n", app.frame_used); return 1; }
+  printf("Endpoints: %u, coroutine frame %zu bytes\n", ENDPOINTS::Count(), app.frame_used);
+
+  host.Round();
+  uint32_t irq_packets = host.irq_packets;
+  printf("Round: %u messages echoed, %u packets, SERIAL_STATE %u packets / %u bytes, errors %u\n",
+         host.replies, host.packets, irq_packets, host.irq_bytes, host.errors);
+
+  auto t0 = std::chrono::steady_clock::now();
+  for (uint32_t i = 1; i < rounds; ++i) host.Round();
+  double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+  uint32_t packets = host.packets;
+  printf("%u rounds: %u replies, %.1f ns per packet, errors %u, overlapping packets %u\n",
+         rounds, host.replies, (rounds > 1) ? ns / (packets - packets / rounds) : 0.0, host.errors, t.overlaps);
+
+  // Сброс шины: оба приема эха в работе завершаются ABORTED
+  eps.Abort();
+  bool stopped = app.echo.handle.done() && !eps.Get<0x01>().Busy();
+  printf("Abort: %s\n", stopped ? "coroutines finished" : "STILL RUNNING");
+  printf("Heap calls: %zu\n", heap_calls - heap_before);
+
+  bool ok = !host.errors && !t.overlaps && stopped && (host.replies == rounds * std::size(Messages)) && (heap_calls == heap_before);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,245 @@
+// EP0: сопрограмма (Device/usb_ep0_coroutine.hpp) против классического
+// автомата (Device/usb_ep0_control.hpp) на одной последовательности передач:
+// перечисление как у Linux, запросы класса CDC, прерванная хостом передача.
+// Пакеты обоих автоматов должны совпасть байт в байт, куча - не использоваться.
+// С trace.bin классический автомат проходит последовательность еще раз с
+// трассировкой (Device/usb_trace.hpp) - снимок для Tools/usb_trace_decode.cpp.
+//
+//   g++ -std=c++20 -O2 Tools/ep0_bench.cpp -o ep0_bench
+//   ./ep0_bench [sequences] [trace.bin]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <new>
+#include <chrono>
+#include <thread>
+#include <iterator>
+
+#include "../Descriptors/usb_cdc_descriptors.hpp"
+#include "../Device/usb_ep0_control.hpp"
+#include "../Device/usb_ep0_coroutine.hpp"
+#include "../Device/usb_trace.hpp"
+
+//==============================================================================
+// Счетчик обращений к куче
+//==============================================================================
+static size_t heap_calls = 0;
+
+void* operator new(size_t size)
+{
+  ++heap_calls;
+  if (void* p = malloc(size ? size : 1)) return p;
+  throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+//==============================================================================
+// Транспорт: запоминает последний запрос автомата, события подает хост
+//==============================================================================
+struct TRANSPORT
+{
+  const uint8_t* tx_buf = nullptr;
+  uint8_t* rx_buf = nullptr;
+  uint32_t tx_len = 0, rx_len = 0;
+  bool tx = false, rx = false, stall = false;
+  uint8_t address = 0;
+
+  void Transmit(uint8_t, const uint8_t* buf, uint32_t len) { tx_buf = buf; tx_len = len; tx = true; }
+  void Receive(uint8_t, uint8_t* buf, uint32_t len) { rx_buf = buf; rx_len = len; rx = true; }
+  void Stall(uint8_t) { stall = true; }
+  void SetAddress(uint8_t a) { address = a; }
+};
+
+//==============================================================================
+// Обработчик класса CDC ACM
+//==============================================================================
+struct CDC_HANDLER
+{
+  uint8_t line_coding[7] { 0x00, 0xC2, 0x01, 0x00, 0, 0, 8 };   // 115200 8N1
+  uint16_t line_state = 0;
+  uint8_t configuration = 0;
+
+  void Configured(uint8_t value) { configuration = value; }
+
+  int32_t Control(const uint8_t* setup, uint8_t* data, uint16_t len)
+  {
+    switch ((setup[0] << 8) | setup[1])
+    {
+      case 0x2120:                                  // SET_LINE_CODING
+        if (len != sizeof(line_coding)) return EP0::STALL;
+        memcpy(line_coding, data, len);
+        return 0;
+      case 0xA121:                                  // GET_LINE_CODING
+        if (len > sizeof(line_coding)) len = sizeof(line_coding);
+        memcpy(data, line_coding, len);
+        return len;
+      case 0x2122:                                  // SET_CONTROL_LINE_STATE
+        line_state = uint16_t(setup[2] | (setup[3] << 8));
+        return 0;
+      default:
+        return EP0::STALL;
+    }
+  }
+};
+
+//==============================================================================
+// Хост
+//==============================================================================
+struct TRANSFER
+{
+  uint8_t setup[8];
+  uint8_t data[8];          // данные OUT
+  bool abort;               // после первого пакета данных - новый SETUP
+};
+
+constexpr TRANSFER Sequence[] =
+{
+  { { 0x80, 0x06, 0x00, 0x01, 0x00, 0x00, 0x40, 0x00 }, {}, false },   // DEVICE 64
+  { { 0x00, 0x05, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00 }, {}, false },   // SET_ADDRESS 7
+  { { 0x80, 0x06, 0x00, 0x01, 0x00, 0x00, 0x12, 0x00 }, {}, false },   // DEVICE 18
+  { { 0x80, 0x06, 0x00, 0x06, 0x00, 0x00, 0x0A, 0x00 }, {}, false },   // DEVICE_QUALIFIER: STALL
+  { { 0x80, 0x06, 0x00, 0x02, 0x00, 0x00, 0x09, 0x00 }, {}, false },   // CONFIGURATION 9
+  { { 0x80, 0x06, 0x00, 0x02, 0x00, 0x00, 0xFF, 0x00 }, {}, true  },   // CONFIGURATION 255, прервана
+  { { 0x80, 0x06, 0x00, 0x02, 0x00, 0x00, 0xFF, 0x00 }, {}, false },   // CONFIGURATION 255
+  { { 0x80, 0x06, 0x00, 0x03, 0x00, 0x00, 0xFF, 0x00 }, {}, false },   // STRING 0
+  { { 0x80, 0x06, 0x02, 0x03, 0x09, 0x04, 0xFF, 0x00 }, {}, false },   // STRING 2
+  { { 0x80, 0x06, 0x01, 0x03, 0x09, 0x04, 0xFF, 0x00 }, {}, false },   // STRING 1
+  { { 0x80, 0x06, 0x03, 0x03, 0x09, 0x04, 0xFF, 0x00 }, {}, false },   // STRING 3
+  { { 0x00, 0x09, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00 }, {}, false },   // SET_CONFIGURATION 1
+  { { 0x80, 0x08, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00 }, {}, false },   // GET_CONFIGURATION
+  { { 0xA1, 0x21, 0x00, 0x00, 0x00, 0x00, 0x07, 0x00 }, {}, false },   // GET_LINE_CODING
+  { { 0x21, 0x20, 0x00, 0x00, 0x00, 0x00, 0x07, 0x00 }, { 0x80, 0x25, 0, 0, 0, 0, 8 }, false }, // SET_LINE_CODING 9600
+  { { 0x21, 0x22, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00 }, {}, false },   // SET_CONTROL_LINE_STATE
+  { { 0xA1, 0x21, 0x00, 0x00, 0x00, 0x00, 0x07, 0x00 }, {}, false },   // GET_LINE_CODING
+  { { 0x21, 0x7F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, {}, false },   // неизвестный: STALL
+};
+
+// FNV-1a по всем пакетам и результатам
+struct TRACE
+{
+  uint64_t hash = 1469598103934665603ull;
+  void Add(const uint8_t* p, uint32_t n) { for (uint32_t i = 0; i < n; ++i) hash = (hash ^ p[i]) * 1099511628211ull; }
+  void Add(int32_t v) { Add((const uint8_t*)&v, sizeof(v)); }
+};
+
+// Одна передача: длина данных или STALL
+template<typename TMachine>
+static int32_t Transfer(TMachine& ep0, TRANSPORT& t, const TRANSFER& x, TRACE& trace)
+{
+  const bool in = x.setup[0] & 0x80;
+  const uint16_t wLength = uint16_t(x.setup[6] | (x.setup[7] << 8));
+  int32_t done = 0;
+  t.tx = t.rx = t.stall = false;
+  ep0.Setup(x.setup);
+  for (bool first = true; ; first = false)
+  {
+    if (t.stall) return EP0::STALL;
+    if (t.tx)
+    {
+      t.tx = false;
+      trace.Add(t.tx_buf, t.tx_len);
+      done += in ? int32_t(t.tx_len) : 0;
+      if (first && x.abort) return -2;
+      ep0.OnTransmitted();
+      if (!in) return done;                         // статус IN
+    }
+    else if (t.rx)
+    {
+      t.rx = false;
+      if (in) { ep0.OnReceived(0); return done; }  // статус OUT
+      uint32_t n = (t.rx_len < wLength - uint32_t(done)) ? t.rx_len : wLength - done;
+      memcpy(t.rx_buf, x.data + done, n);
+      done += n;
+      ep0.OnReceived(uint16_t(n));
+    }
+    else return -3;                                 // автомат ничего не запросил
+  }
+}
+
+template<typename TMachine>
+static uint64_t Run(TMachine& ep0, TRANSPORT& t, CDC_HANDLER& cdc, bool print)
+{
+  TRACE trace;
+  for (auto& x : Sequence)
+  {
+    int32_t r = Transfer(ep0, t, x, trace);
+    trace.Add(r);
+    if (print)
+      printf("  %.2X %.2X %.4X %.4X: %s%d\n", x.setup[0], x.setup[1], x.setup[2] | (x.setup[3] << 8),
+             x.setup[6] | (x.setup[7] << 8), (r == EP0::STALL) ? "STALL " : (r == -2) ? "aborted " : "", r);
+  }
+  trace.Add(&t.address, 1);
+  trace.Add(cdc.line_coding, sizeof(cdc.line_coding));
+  trace.Add(&cdc.configuration, 1);
+  return trace.hash;
+}
+
+using CLOCK = std::chrono::steady_clock;
+
+template<typename TMachine>
+static double Measure(TMachine& ep0, TRANSPORT& t, CDC_HANDLER& cdc, uint32_t sequences, uint64_t& hash)
+{
+  auto t0 = CLOCK::now();
+  for (uint32_t i = 0; i < sequences; ++i) hash ^= Run(ep0, t, cdc, false);
+  return std::chrono::duration<double, std::nano>(CLOCK::now() - t0).count() / (double(sequences) * std::size(Sequence));
+}
+
+// Частота USB_TRACE::CYCLES по steady_clock, 0 - счетчика нет
+static uint32_t CyclesHz()
+{
+  uint32_t c0 = USB_TRACE::CYCLES::Now();
+  auto t0 = CLOCK::now();
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  uint32_t c1 = USB_TRACE::CYCLES::Now();
+  double s = std::chrono::duration<double>(CLOCK::now() - t0).count();
+  return uint32_t((c1 - c0) / s);
+}
+
+int main(int argc, char* argv[])
+{
+  uint32_t sequences = (argc > 1) ? atoi(argv[1]) : 200000;
+  if (sequences & 1) ++sequences;                   // четное число: хэши XOR сходятся
+
+  TRANSPORT t1, t2;
+  CDC_HANDLER cdc1, cdc2;
+  size_t heap_before = heap_calls;
+  EP0::CONTROL<TRANSPORT, CDC_HANDLER> classic(t1, CDC_PROFILE::Personality, cdc1);
+  EP0::CONTROL_TASK<TRANSPORT, CDC_HANDLER> coroutine(t2, CDC_PROFILE::Personality, cdc2);
+  if (!coroutine.Valid()) { printf("Coroutine frame %zu bytes does not fit\n", coroutine.FrameUsed()); return 1; }
+
+  printf("Sequence (coroutine):\n");
+  uint64_t h2 = Run(coroutine, t2, cdc2, true);
+  uint64_t h1 = Run(classic, t1, cdc1, false);
+  printf("Traces %s, address %u, line coding %u baud\n", (h1 == h2) ? "match" : "DIFFER", t2.address,
+         cdc2.line_coding[0] | (cdc2.line_coding[1] << 8) | (cdc2.line_coding[2] << 16));
+  printf("Objects: classic %zu bytes, coroutine %zu bytes (frame %zu of %zu)\n",
+         sizeof(classic), sizeof(coroutine), coroutine.FrameUsed(), size_t(256));
+
+  uint64_t m1 = 0, m2 = 0;
+  double ns1 = Measure(classic, t1, cdc1, sequences, m1);
+  double ns2 = Measure(coroutine, t2, cdc2, sequences, m2);
+  printf("Classic   %6.1f ns per transfer\n", ns1);
+  printf("Coroutine %6.1f ns per transfer\n", ns2);
+  printf("Heap calls: %zu\n", heap_calls - heap_before);
+  bool ok = (h1 == h2) && (m1 == m2) && (heap_calls == heap_before);
+
+  if (argc > 2)
+  {
+    using TRACE = USB_TRACE::RING<256>;
+    TRANSPORT t3;
+    CDC_HANDLER cdc3;
+    EP0::CONTROL<TRANSPORT, CDC_HANDLER, 256, TRACE> traced(t3, CDC_PROFILE::Personality, cdc3);
+    uint64_t m3 = 0;
+    double ns3 = Measure(traced, t3, cdc3, sequences, m3);
+    printf("Traced    %6.1f ns per transfer\n", ns3);
+    TRACE::buffer.head = 0;
+    TRACE::buffer.clock_hz = CyclesHz();
+    ok = ok && (Run(traced, t3, cdc3, false) == h1);
+    FILE* f = fopen(argv[2], "wb");
+    if (!f || (fwrite(&TRACE::buffer, sizeof(TRACE::buffer), 1, f) != 1)) ok = false;
+    if (f) fclose(f);
+    printf("Trace: %u records -> %s\n", TRACE::buffer.head.load(), argv[2]);
+  }
+  return ok ? 0 : 1;
+}
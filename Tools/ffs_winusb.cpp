@@ -0,0 +1,89 @@
+// WinUSB функция на Linux гаджете: дескрипторы и строки FunctionFS из тех же
+// типов, что и на контроллере. Без аргумента печатает блоки, с путем к ep0
+// смонтированной functionfs - записывает их (затем гаджет привязывается к UDC).
+//
+//   g++ -std=c++17 -O2 Tools/ffs_winusb.cpp -o ffs_winusb
+//   mount -t functionfs winusb /dev/ffs-winusb && ./ffs_winusb /dev/ffs-winusb/ep0
+
+#include <stdio.h>
+#include <iterator>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "../Descriptors/usb_winusb_descriptors.hpp"
+
+using WINUSB_PROFILE::Ffs_Descriptors;
+using WINUSB_PROFILE::Ffs_Strings;
+
+//==============================================================================
+// Сверка с uapi ядра
+//==============================================================================
+#if __has_include(<linux/usb/functionfs.h>)
+#include <stddef.h>
+#include <linux/usb/functionfs.h>
+
+static_assert(sizeof(usb_functionfs_descs_head_v2) == 12, "descs_head_v2 layout");
+static_assert(offsetof(usb_functionfs_descs_head_v2, length) == 4, "descs_head_v2 layout");
+static_assert(offsetof(usb_functionfs_descs_head_v2, flags) == 8, "descs_head_v2 layout");
+static_assert(sizeof(usb_functionfs_strings_head) == 16, "strings_head layout");
+static_assert(offsetof(usb_functionfs_strings_head, lang_count) == 12, "strings_head layout");
+
+static_assert(USB_DESCRIPTORS::FFS_DESCRIPTORS_MAGIC_V2 == FUNCTIONFS_DESCRIPTORS_MAGIC_V2, "Wrong magic");
+static_assert(USB_DESCRIPTORS::FFS_STRINGS_MAGIC == FUNCTIONFS_STRINGS_MAGIC, "Wrong magic");
+static_assert(uint32_t(USB_DESCRIPTORS::ffs_Flags::HasFsDesc) == FUNCTIONFS_HAS_FS_DESC &&
+              uint32_t(USB_DESCRIPTORS::ffs_Flags::HasHsDesc) == FUNCTIONFS_HAS_HS_DESC &&
+              uint32_t(USB_DESCRIPTORS::ffs_Flags::HasSsDesc) == FUNCTIONFS_HAS_SS_DESC &&
+              uint32_t(USB_DESCRIPTORS::ffs_Flags::HasMsOsDesc) == FUNCTIONFS_HAS_MS_OS_DESC &&
+              uint32_t(USB_DESCRIPTORS::ffs_Flags::VirtualAddr) == FUNCTIONFS_VIRTUAL_ADDR &&
+              uint32_t(USB_DESCRIPTORS::ffs_Flags::EventFd) == FUNCTIONFS_EVENTFD &&
+              uint32_t(USB_DESCRIPTORS::ffs_Flags::AllCtrlRecip) == FUNCTIONFS_ALL_CTRL_RECIP &&
+              uint32_t(USB_DESCRIPTORS::ffs_Flags::Config0Setup) == FUNCTIONFS_CONFIG0_SETUP, "Wrong flags");
+#endif
+
+static constexpr uint32_t le32(const uint8_t* p) { return p[0] | (p[1] << 8) | (p[2] << 16) | (uint32_t(p[3]) << 24); }
+
+// Заголовки разбираются так же, как их читает ядро
+static_assert(le32(Ffs_Descriptors.buf) == 3 && le32(Ffs_Descriptors.buf + 4) == sizeof(Ffs_Descriptors.buf),
+              "Wrong descriptors head");
+static_assert(le32(Ffs_Descriptors.buf + 8) == 3 &&                          // FS + HS
+              le32(Ffs_Descriptors.buf + 12) == 7 && le32(Ffs_Descriptors.buf + 16) == 7,   // 1 интерфейс + 6 точек
+              "Wrong descriptors counts");
+static_assert(le32(Ffs_Strings.buf) == 2 && le32(Ffs_Strings.buf + 4) == sizeof(Ffs_Strings.buf),
+              "Wrong strings head");
+
+// iInterface интерфейса FS (за заголовком) и HS (за 7 дескрипторами FS) - строка из блока
+constexpr uint8_t ffs_fs_iInterface = Ffs_Descriptors.buf[20 + 8];
+constexpr uint8_t ffs_hs_iInterface = Ffs_Descriptors.buf[20 + 9 + 6 * 7 + 8];
+static_assert(ffs_fs_iInterface && (ffs_fs_iInterface <= le32(Ffs_Strings.buf + 8)) &&
+              ffs_hs_iInterface && (ffs_hs_iInterface <= le32(Ffs_Strings.buf + 8)),
+              "iInterface outside the strings block");
+
+static void Print(const char* name, const uint8_t* buf, size_t size)
+{
+  printf("%s %u bytes:", name, unsigned(size));
+  for (size_t i = 0; i < size; i++) printf("%s%.2X", (i % 16) ? " " : "\n  ", buf[i]);
+  printf("\n");
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc < 2)
+  {
+    Print("Descriptors", Ffs_Descriptors.buf, sizeof(Ffs_Descriptors.buf));
+    Print("Strings", Ffs_Strings.buf, sizeof(Ffs_Strings.buf));
+    return 0;
+  }
+
+  int ep0 = open(argv[1], O_RDWR);
+  if (ep0 < 0) { perror(argv[1]); return 1; }
+  if ((write(ep0, Ffs_Descriptors.buf, sizeof(Ffs_Descriptors.buf)) != (ssize_t)sizeof(Ffs_Descriptors.buf)) ||
+      (write(ep0, Ffs_Strings.buf, sizeof(Ffs_Strings.buf)) != (ssize_t)sizeof(Ffs_Strings.buf)))
+  {
+    perror("ep0");
+    return 1;
+  }
+  printf("Descriptors written, bind the gadget to UDC\n");
+  pause();   // функция существует, пока ep0 открыт
+  close(ep0);
+  return 0;
+}
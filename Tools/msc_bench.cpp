@@ -0,0 +1,238 @@
+// BOT/SCSI движок на рабочей станции: образ через mmap, шина USB и носитель
+// моделируются в виртуальном времени (результат не зависит от числа ядер).
+//
+//   g++ -std=c++17 -O2 Tools/msc_bench.cpp -o msc_bench
+//   ./msc_bench [image] [image MB] [link MB/s] [media MB/s] [command KB]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <iterator>
+
+#include "../Descriptors/usb_msd_descriptors.hpp"
+#include "../Device/usb_msc_bot.hpp"
+#include "../Device/block_device_mmap.hpp"
+
+using MSD_PROFILE::MSD_INTERFACE;
+
+//==============================================================================
+// Виртуальное время, нс
+//==============================================================================
+struct CLOCK
+{
+  double now = 0;
+  uint32_t activity = 0;   // обращения движка к носителю и транспорту
+};
+
+//==============================================================================
+// Носитель: образ + время доступа
+//==============================================================================
+template<typename TDevice>
+class TIMED_DEVICE : public TDevice
+{
+public:
+  static constexpr uint32_t BlockSize = TDevice::BlockSize;
+
+  TIMED_DEVICE(CLOCK& clock, const char* path, uint64_t blocks, double mb_per_s)
+    : TDevice(path, blocks), clock(clock), ns_per_byte(1000.0 / mb_per_s) {}
+
+  bool Read(uint64_t lba, uint8_t* buf, uint32_t n) { Spend(n); return TDevice::Read(lba, buf, n); }
+  bool Write(uint64_t lba, const uint8_t* buf, uint32_t n) { Spend(n); return TDevice::Write(lba, buf, n); }
+
+private:
+  void Spend(uint32_t n) { clock.now += ns_per_byte * n * BlockSize; ++clock.activity; }
+
+  CLOCK& clock;
+  double ns_per_byte;
+};
+
+using DEVICE = TIMED_DEVICE<MMAP_BLOCK_DEVICE<512>>;
+
+//==============================================================================
+// Шина + хост: последовательность CBW -> данные -> CSW для каждой команды
+//==============================================================================
+class LINK
+{
+public:
+  struct COMMAND { uint8_t cbw[31]; uint8_t* data; uint32_t len; bool in; };
+
+  LINK(CLOCK& clock, double mb_per_s) : clock(clock), ns_per_byte(1000.0 / mb_per_s) {}
+
+  // TTransport: передача занимает шину, завершение - в момент done
+  void Transmit(uint8_t, const uint8_t* buf, uint32_t len) { Submit(in_op, const_cast<uint8_t*>(buf), len); }
+  void Receive(uint8_t, uint8_t* buf, uint32_t len) { Submit(out_op, buf, len); }
+  void Stall(uint8_t) { ++stalls; }
+
+  template<typename TEngine>
+  bool Run(TEngine& engine, COMMAND* commands, uint32_t count)
+  {
+    cmds = commands;
+    cmd_count = count;
+    index = pos = 0;
+    phase = PHASE::CBW;
+    ok = true;
+    while (ok && (index < cmd_count))
+    {
+      uint32_t activity = clock.activity;
+      engine.Poll();
+      if (Complete(engine)) continue;
+      if (clock.activity != activity) continue;
+      // Движок ждет шину: время до ближайшего завершения
+      double next = 1e300;
+      if (in_op.pending) next = in_op.done;
+      if (out_op.pending && (out_op.done < next)) next = out_op.done;
+      if (next == 1e300) { ok = false; break; }  // тупик
+      clock.now = next;
+    }
+    return ok && !stalls;
+  }
+
+private:
+  enum class PHASE : uint8_t { CBW, DATA, CSW };
+  struct OP { uint8_t* buf; uint32_t len; double done; bool pending; };
+
+  void Submit(OP& op, uint8_t* buf, uint32_t len)
+  {
+    op = { buf, len, 0, true };
+    ++clock.activity;
+    Schedule();
+  }
+
+  // Хост всегда готов: OUT занимает шину сразу, IN - когда хост его ожидает
+  void Schedule()
+  {
+    for (OP* op : { &out_op, &in_op })
+    {
+      if (!op->pending || op->done) continue;
+      uint32_t n = Length(*op);
+      if (!n) continue;
+      double start = (clock.now > bus_free) ? clock.now : bus_free;
+      op->done = bus_free = start + ns_per_byte * n;
+    }
+  }
+
+  uint32_t Length(const OP& op) const
+  {
+    const COMMAND& c = cmds[index];
+    bool out = &op == &out_op;
+    uint32_t avail = (phase == PHASE::CBW) ? (out ? 31 : 0)
+                   : (phase == PHASE::CSW) ? (out ? 0 : 13)
+                   : (out != c.in) ? c.len - pos : 0;
+    return (op.len < avail) ? op.len : avail;
+  }
+
+  template<typename TEngine>
+  bool Complete(TEngine& engine)
+  {
+    for (OP* op : { &out_op, &in_op })
+    {
+      if (!op->pending || !op->done || (op->done > clock.now)) continue;
+      COMMAND& c = cmds[index];
+      uint32_t n = Length(*op);
+      op->pending = false;
+      if (phase == PHASE::CBW) { memcpy(op->buf, c.cbw, n); phase = c.len ? PHASE::DATA : PHASE::CSW; }
+      else if (phase == PHASE::DATA)
+      {
+        if (c.in) memcpy(c.data + pos, op->buf, n);
+        else memcpy(op->buf, c.data + pos, n);
+        if ((pos += n) == c.len) phase = PHASE::CSW;
+      }
+      else
+      {
+        ok = (n == 13) && !memcmp(op->buf, "USBS", 4) && !memcmp(op->buf + 4, c.cbw + 4, 4) && (op->buf[12] == 0);
+        ++index;
+        pos = 0;
+        phase = PHASE::CBW;
+      }
+      if (op == &in_op) engine.OnTransmitted();
+      else engine.OnReceived(n);
+      Schedule();
+      return true;
+    }
+    return false;
+  }
+
+  CLOCK& clock;
+  double ns_per_byte;
+  double bus_free = 0;
+  OP in_op{}, out_op{};
+  uint32_t stalls = 0;
+
+  COMMAND* cmds = nullptr;
+  uint32_t cmd_count = 0, index = 0, pos = 0;
+  PHASE phase = PHASE::CBW;
+  bool ok = true;
+};
+
+//==============================================================================
+static void MakeCBW(uint8_t* cbw, uint32_t tag, uint8_t op, uint32_t lba, uint16_t blocks, bool in)
+{
+  uint32_t len = blocks * 512u;
+  memset(cbw, 0, 31);
+  memcpy(cbw, "USBC", 4);
+  memcpy(cbw + 4, &tag, 4);
+  memcpy(cbw + 8, &len, 4);
+  cbw[12] = in ? 0x80 : 0x00;
+  cbw[14] = 10;
+  cbw[15] = op;
+  cbw[17] = lba >> 24; cbw[18] = lba >> 16; cbw[19] = lba >> 8; cbw[20] = lba;
+  cbw[22] = blocks >> 8; cbw[23] = blocks;
+}
+
+template<bool pipelined>
+static void Bench(const char* image, uint32_t image_mb, double link, double media, uint32_t cmd_kb)
+{
+  using ENGINE = MSC::BOT<MSD_INTERFACE, LINK, DEVICE, 16384, pipelined>;
+
+  CLOCK clock;
+  DEVICE device(clock, image, uint64_t(image_mb) << 11, media);
+  if (!device.IsOpen()) { printf("Cannot open %s\n", image); exit(1); }
+  LINK bus(clock, link);
+  auto* engine = new ENGINE(bus, device);
+  engine->Start();
+
+  const uint16_t blocks = uint16_t(cmd_kb * 2);
+  const uint32_t count = uint32_t(device.BlockCount() / blocks);
+  const uint32_t bytes = blocks * 512u;
+  auto* data = new uint8_t[size_t(count) * bytes];
+  auto* cmds = new LINK::COMMAND[count];
+
+  for (auto op : { MSC::SCSI_OP::WRITE_10, MSC::SCSI_OP::READ_10 })
+  {
+    bool in = (op == MSC::SCSI_OP::READ_10);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+      uint8_t* p = data + size_t(i) * bytes;
+      for (uint32_t j = 0; j < bytes; ++j) p[j] = in ? 0 : uint8_t(i * 7 + j);
+      cmds[i].data = p;
+      cmds[i].len = bytes;
+      cmds[i].in = in;
+      MakeCBW(cmds[i].cbw, i, uint8_t(op), i * blocks, blocks, in);
+    }
+    double t0 = clock.now;
+    bool ok = bus.Run(*engine, cmds, count);
+    double ns = clock.now - t0;
+    for (uint32_t i = 0; ok && in && (i < count); ++i)
+      for (uint32_t j = 0; j < bytes; ++j)
+        if (data[size_t(i) * bytes + j] != uint8_t(i * 7 + j)) { ok = false; break; }
+    printf("%-10s %-5s %6.1f MB/s %s\n", pipelined ? "pipelined" : "serial", in ? "READ" : "WRITE",
+           double(count) * bytes / ns * 1000.0, ok ? "" : "FAILED");
+  }
+  delete[] cmds;
+  delete[] data;
+  delete engine;
+}
+
+int main(int argc, char* argv[])
+{
+  const char* image = (argc > 1) ? argv[1] : "msc_image.bin";
+  uint32_t image_mb = (argc > 2) ? atoi(argv[2]) : 32;
+  double link = (argc > 3) ? atof(argv[3]) : 40;    // практический предел HS bulk
+  double media = (argc > 4) ? atof(argv[4]) : 40;
+  uint32_t cmd_kb = (argc > 5) ? atoi(argv[5]) : 64;
+
+  printf("Image %s %u MB, link %.0f MB/s, media %.0f MB/s, %u KB per command\n",
+         image, image_mb, link, media, cmd_kb);
+  Bench<false>(image, image_mb, link, media, cmd_kb);
+  Bench<true>(image, image_mb, link, media, cmd_kb);
+  return 0;
+}
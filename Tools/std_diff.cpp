@@ -0,0 +1,424 @@
+// Дифференциальная проверка двух реализаций (Descriptors/C++17 и
+// Descriptors/C++20): каждый профиль и семейство случайных конфигураций
+// собираются обоими стандартами, байты дескрипторов сравниваются. Для каждой
+// единицы трансляции - время компиляции, пиковая память компилятора и размер
+// объектного файла (секции, попадающие в образ).
+//
+//   g++ -std=c++17 -O2 Tools/std_diff.cpp -o std_diff
+//   ./std_diff [random] [seed] [compiler]      (из корня репозитория)
+//       random:   число случайных конфигураций, по умолчанию 10
+//       compiler: по умолчанию g++
+//   Код возврата 1 - байты различаются или одна из сборок не удалась;
+//   исходники и вывод остаются во временном каталоге
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <elf.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+//==============================================================================
+// Запуск процесса: время, пиковая память всех его потомков (cc1plus, as)
+//==============================================================================
+struct RUN
+{
+  bool ok = false;
+  double seconds = 0;
+  long max_rss_kb = 0;
+};
+
+static RUN Run(const std::vector<std::string>& args, const std::string& out)
+{
+  RUN r;
+  int pipe_fd[2];
+  if (pipe(pipe_fd)) return r;
+  auto t0 = std::chrono::steady_clock::now();
+  pid_t pid = fork();
+  if (pid == 0)
+  {
+    // Промежуточный процесс: после ожидания в RUSAGE_CHILDREN - только эта команда
+    close(pipe_fd[0]);
+    pid_t cmd = fork();
+    if (cmd == 0)
+    {
+      int fd = open(out.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+      if (fd >= 0) { dup2(fd, 1); dup2(fd, 2); close(fd); }
+      std::vector<char*> argv;
+      for (auto& a : args) argv.push_back(const_cast<char*>(a.c_str()));
+      argv.push_back(nullptr);
+      execvp(argv[0], argv.data());
+      _exit(127);
+    }
+    int status = 0;
+    waitpid(cmd, &status, 0);
+    rusage u{};
+    getrusage(RUSAGE_CHILDREN, &u);
+    long rss = u.ru_maxrss;
+    if (write(pipe_fd[1], &rss, sizeof(rss)) != sizeof(rss)) _exit(126);
+    _exit(WIFEXITED(status) ? WEXITSTATUS(status) : 125);
+  }
+  close(pipe_fd[1]);
+  int status = 0;
+  waitpid(pid, &status, 0);
+  r.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  if (read(pipe_fd[0], &r.max_rss_kb, sizeof(r.max_rss_kb)) != sizeof(r.max_rss_kb)) r.max_rss_kb = 0;
+  close(pipe_fd[0]);
+  r.ok = WIFEXITED(status) && !WEXITSTATUS(status);
+  return r;
+}
+
+static std::string ReadFile(const std::string& path)
+{
+  std::string s;
+  if (FILE* f = fopen(path.c_str(), "rb"))
+  {
+    char buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) s.append(buf, n);
+    fclose(f);
+  }
+  return s;
+}
+
+static void WriteFile(const std::string& path, const std::string& s)
+{
+  if (FILE* f = fopen(path.c_str(), "wb")) { fwrite(s.data(), 1, s.size(), f); fclose(f); }
+}
+
+// Размер секций объектного файла, занимающих память (SHF_ALLOC), 0 - не ELF64
+static uint64_t AllocSize(const std::string& path)
+{
+  std::string o = ReadFile(path);
+  if ((o.size() < sizeof(Elf64_Ehdr)) || memcmp(o.data(), ELFMAG, SELFMAG) || (o[EI_CLASS] != ELFCLASS64)) return 0;
+  Elf64_Ehdr eh;
+  memcpy(&eh, o.data(), sizeof(eh));
+  uint64_t total = 0;
+  for (uint16_t i = 0; i < eh.e_shnum; ++i)
+  {
+    Elf64_Shdr sh;
+    uint64_t at = eh.e_shoff + uint64_t(i) * eh.e_shentsize;
+    if (at + sizeof(sh) > o.size()) return 0;
+    memcpy(&sh, o.data() + at, sizeof(sh));
+    if (sh.sh_flags & SHF_ALLOC) total += sh.sh_size;
+  }
+  return total;
+}
+
+//==============================================================================
+// Единицы трансляции: профиль или случайная конфигурация + вывод байтов
+//==============================================================================
+struct UNIT
+{
+  std::string name;
+  std::string source;
+};
+
+static const char* Prologue =
+  "#include <stdio.h>\n"
+  "#include <iterator>\n";
+
+static const char* DumpCode =
+  "static void Dump(const char* what, const uint8_t* p, size_t n)\n"
+  "{\n"
+  "  printf(\"%s:\", what);\n"
+  "  for (size_t i = 0; i < n; ++i) printf(\" %.2X\", p[i]);\n"
+  "  printf(\"\\n\");\n"
+  "}\n"
+  "static void Dump(const char* what, const USB_DESCRIPTORS::GATHER_LIST& list)\n"
+  "{\n"
+  "  printf(\"%s:\", what);\n"
+  "  for (uint8_t f = 0; f < list.count; ++f)\n"
+  "    for (uint16_t i = 0; i < list.fragments[f].size; ++i) printf(\" %.2X\", list.fragments[f].data[i]);\n"
+  "  printf(\"\\n\");\n"
+  "}\n";
+
+struct PROFILE_SOURCE { const char* name; const char* header; const char* ns; };
+
+static const PROFILE_SOURCE Profiles[] =
+{
+  { "HID", "usb_hid_descriptors.hpp", "HID_PROFILE" },
+  { "CDC", "usb_cdc_descriptors.hpp", "CDC_PROFILE" },
+  { "CDCx2", "usb_2cdc_descriptors.hpp", "CDCx2_PROFILE" },
+  { "WinUSB", "usb_winusb_descriptors.hpp", "WINUSB_PROFILE" },
+  { "MSD", "usb_msd_descriptors.hpp", "MSD_PROFILE" },
+  { "UAC2", "usb_uac2_descriptors.hpp", "UAC2_PROFILE" },
+  { "UVC", "usb_uvc_descriptors.hpp", "UVC_PROFILE" },
+  { "NCM", "usb_ncm_descriptors.hpp", "NCM_PROFILE" },
+  { "DFU", "usb_dfu_descriptors.hpp", "DFU_PROFILE" }
+};
+
+static UNIT ProfileUnit(const std::string& root, const PROFILE_SOURCE& p)
+{
+  std::string s = Prologue;
+  s += "#include \"" + root + "/Descriptors/" + p.header + "\"\n";
+  s += DumpCode;
+  s += "int main()\n{\n  using namespace " + std::string(p.ns) + ";\n"
+       "  const auto& p = Personality;\n"
+       "  Dump(\"device\", p.device, p.device[0]);\n"
+       "  Dump(\"configuration\", Configuration_Descriptor.buf, sizeof(Configuration_Descriptor.buf));\n"
+       "  char name[32];\n"
+       "  for (uint8_t i = 0; i < p.device[17]; ++i)\n"
+       "  {\n"
+       "    snprintf(name, sizeof(name), \"gathered %u\", i);\n"
+       "    Dump(name, p.configurations[i]);\n"
+       "  }\n"
+       "  for (uint8_t i = 0; i < p.strings_count; ++i)\n"
+       "  {\n"
+       "    snprintf(name, sizeof(name), \"string %u\", p.strings[i][0]);\n"
+       "    Dump(name, p.strings[i] + 1, p.strings[i][1]);\n"
+       "  }\n"
+       "  return 0;\n}\n";
+  return { p.name, s };
+}
+
+//==============================================================================
+// Случайные конфигурации из конструкций, общих для обоих деревьев
+//==============================================================================
+class RANDOM
+{
+public:
+  explicit RANDOM(uint64_t seed) : x(seed * 0x9E3779B97F4A7C15ull + 1) {}
+  uint32_t Next()
+  {
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return uint32_t(x >> 16);
+  }
+  uint32_t Range(uint32_t lo, uint32_t hi) { return lo + Next() % (hi - lo + 1); }
+  bool Chance(uint32_t percent) { return Range(1, 100) <= percent; }
+private:
+  uint64_t x;
+};
+
+class GENERATOR
+{
+public:
+  GENERATOR(RANDOM& rnd) : rnd(rnd) {}
+
+  std::string Configuration()
+  {
+    std::string blocks;
+    uint32_t count = rnd.Range(1, 4);
+    for (uint32_t i = 0; (i < count) && (ep < 14); ++i)
+    {
+      if (!blocks.empty()) blocks += ",\n\n";
+      switch (rnd.Range(0, 3))
+      {
+        case 0: blocks += Plain(); break;
+        case 1: blocks += Alternates(); break;
+        case 2: blocks += Cdc(); break;
+        default: blocks += VendorBulk(); break;
+      }
+    }
+    static const char* attributes[] = { "cfg_Attr::SelfPowered", "cfg_Attr::RemoteWakeup" };
+    std::string s =
+      "namespace GEN\n{\nusing namespace USB_DESCRIPTORS;\n\n"
+      "constexpr DEVICE_DESCRIPTOR\n"
+      "< bcdUSB<0x02'00>, bDeviceClass<" + N(rnd.Chance(50) ? 0 : 0xEF) + ">, bDeviceSubClass<" + N(rnd.Range(0, 2)) +
+      ">, bDeviceProtocol<" + N(rnd.Range(0, 1)) + ">,\n"
+      "  bMaxPacketSize0<" + N(8u << rnd.Range(0, 3)) + ">, idVendor<" + N(rnd.Range(1, 0xFFFF)) +
+      ">, idProduct<" + N(rnd.Range(0, 0xFFFF)) + ">, bcdDevice<" + N(rnd.Range(0, 0x9999)) + ">,\n"
+      "  iManufacturer<" + N(rnd.Range(0, 3)) + ">, iProduct<" + N(rnd.Range(0, 3)) + ">, iSerialNumber<" + N(rnd.Range(0, 3)) +
+      ">, bNumConfigurations<1> > Device_Descriptor;\n\n"
+      "constexpr DEVICE_CONFIGURATION_DESCRIPTOR\n"
+      "< bConfigurationValue<1>, iConfiguration<" + N(rnd.Range(0, 5)) + ">, bmAttributes<" + attributes[rnd.Range(0, 1)] +
+      ">, bMaxPower<" + N(rnd.Range(0, 250)) + ">,\n\n" + blocks + "\n> Configuration_Descriptor;\n\n"
+      "constexpr GATHER_LIST Configurations[] { GatherList<Configuration_Descriptor>() };\n"
+      "} // namespace GEN\n";
+    return s;
+  }
+
+private:
+  static std::string N(uint32_t v) { return std::to_string(v); }
+
+  std::string Endpoint(uint8_t number, bool in, const char* type, uint32_t mps, uint32_t interval, const char* extra = "")
+  {
+    return "ENDPOINT_DESCRIPTOR<bEndpointAddress<" + N(number) + (in ? ", epDIR::IN>" : ", epDIR::OUT>") +
+           ", bmAttributes<epTYPE::" + type + extra + ">, wMaxPacketSize<" + N(mps) + ">, bInterval<" + N(interval) + ">>";
+  }
+
+  std::string Interface(uint8_t number, uint8_t alt, uint32_t cls, uint32_t sub, uint32_t proto, const std::string& body)
+  {
+    return "  INTERFACE<bInterfaceNumber<" + N(number) + ">, bAlternateSetting<" + N(alt) + ">, bInterfaceClass<" + N(cls) +
+           ">, bInterfaceSubClass<" + N(sub) + ">, bInterfaceProtocol<" + N(proto) + ">, iInterface<" + N(rnd.Range(0, 5)) + ">" +
+           body + ">";
+  }
+
+  // Интерфейс с Bulk и Interrupt точками
+  std::string Plain()
+  {
+    std::string body;
+    uint32_t eps = rnd.Range(0, 3);
+    for (uint32_t i = 0; (i < eps) && (ep < 15); ++i)
+    {
+      bool bulk = rnd.Chance(50);
+      body += ",\n    " + (bulk ? Endpoint(++ep, rnd.Chance(50), "Bulk", 8u << rnd.Range(0, 3), 0)
+                               : Endpoint(++ep, rnd.Chance(50), "Interrupt", rnd.Range(1, 64), rnd.Range(1, 255)));
+    }
+    return Interface(itf++, 0, rnd.Range(0, 0xFF), rnd.Range(0, 0xFF), rnd.Range(0, 0xFF), body);
+  }
+
+  // Isochronous поток: настройка 0 без точек, далее - растущий пакет
+  std::string Alternates()
+  {
+    uint8_t number = itf++;
+    uint8_t address = ++ep;
+    bool in = rnd.Chance(50);
+    static const char* sync[] = { "", ", epSYNC::Asynchronous", ", epSYNC::Adaptive", ", epSYNC::Synchronous" };
+    const char* s = sync[rnd.Range(0, 3)];
+    std::string out = Interface(number, 0, 0xFE, 1, 0, "");
+    uint32_t alts = rnd.Range(1, 3), mps = 0;
+    for (uint32_t a = 1; a <= alts; ++a)
+    {
+      mps += rnd.Range(1, 300);
+      out += ",\n" + Interface(number, uint8_t(a), 0xFE, 1, 0, ",\n    " + Endpoint(address, in, "Isochronous", mps, 1, s));
+    }
+    return out;
+  }
+
+  // CDC ACM: управление + данные, иногда в IAD
+  std::string Cdc()
+  {
+    uint8_t comm = itf++, data = itf++;
+    uint8_t notify = ++ep, bulk = ++ep;
+    std::string s =
+      Interface(comm, 0, 2, 2, 1,
+        ",\n    CDC_HEADER_FUNCTIONAL_DESCRIPTOR<bDescriptorSubType<0>, bcdCDC<0x01'10>>,"
+        "\n    CDC_ACM_FUNCTIONAL_DESCRIPTOR<bDescriptorSubType<2>, bmCapabilities<" + N(rnd.Range(0, 15)) + ">>,"
+        "\n    CDC_UNION_FUNCTIONAL_DESCRIPTOR<bDescriptorSubType<6>, bControlInterface<" + N(comm) +
+        ">, bSubordinateInterface0<" + N(data) + ">>,"
+        "\n    CDC_CALL_MANAGEMENT_FUNCTIONAL_DESCRIPTOR<bDescriptorSubType<1>, bmCapabilities<0>, bDataInterface<" + N(data) + ">>,"
+        "\n    " + Endpoint(notify, true, "Interrupt", 8u << rnd.Range(0, 3), rnd.Range(1, 255))) + ",\n" +
+      Interface(data, 0, 0x0A, 0, 0,
+        ",\n    " + Endpoint(bulk, false, "Bulk", 64, 0) + ",\n    " + Endpoint(bulk, true, "Bulk", 64, 0));
+    if (rnd.Chance(50))
+      s = "  INTERFACE_ASSOCIATION<bFunctionClass<2>, bFunctionSubClass<2>, bFunctionProtocol<0>, iFunction<" +
+          N(rnd.Range(0, 5)) + ">,\n" + s + ">";
+    return s;
+  }
+
+  // Полосы по парам Bulk точек
+  std::string VendorBulk()
+  {
+    uint32_t pairs = rnd.Range(1, 3);
+    if (ep + pairs > 15) pairs = 15 - ep;
+    if (!pairs) return Plain();
+    uint8_t first = ep + 1;
+    ep += pairs;
+    return "  VENDOR_BULK_INTERFACE<bInterfaceNumber<" + N(itf++) + ">, USB_SPEED::FULL, " + N(pairs) + ", " + N(first) +
+           ", " + N(64u << rnd.Range(0, 8)) + ">";
+  }
+
+  RANDOM& rnd;
+  uint8_t itf = 0;
+  uint8_t ep = 0;
+};
+
+static UNIT RandomUnit(const std::string& root, uint32_t index, RANDOM& rnd)
+{
+  std::string s = Prologue;
+  s += "#if (__cplusplus > 201703L)\n#include \"" + root + "/Descriptors/C++20/usb_descriptors.hpp\"\n"
+       "#else\n#include \"" + root + "/Descriptors/C++17/usb_descriptors.h\"\n#endif\n\n";
+  GENERATOR gen(rnd);
+  s += gen.Configuration();
+  s += DumpCode;
+  s += "int main()\n{\n"
+       "  Dump(\"device\", GEN::Device_Descriptor.buf, sizeof(GEN::Device_Descriptor.buf));\n"
+       "  Dump(\"configuration\", GEN::Configuration_Descriptor.buf, sizeof(GEN::Configuration_Descriptor.buf));\n"
+       "  Dump(\"gathered\", GEN::Configurations[0]);\n"
+       "  return 0;\n}\n";
+  return { "random " + std::to_string(index), s };
+}
+
+//==============================================================================
+// Сборка единицы одним стандартом
+//==============================================================================
+struct BUILD
+{
+  RUN compile;
+  uint64_t object = 0;
+  bool ran = false;
+  std::string bytes;
+};
+
+static BUILD Build(const std::string& compiler, const std::string& dir, const std::string& base, const char* std,
+                   const std::string& source)
+{
+  BUILD b;
+  std::string path = dir + "/" + base + "." + std;
+  WriteFile(path + ".cpp", source);
+  b.compile = Run({ compiler, std::string("-std=") + std, "-O2", "-w", "-c", path + ".cpp", "-o", path + ".o" }, path + ".log");
+  if (!b.compile.ok) return b;
+  b.object = AllocSize(path + ".o");
+  if (!Run({ compiler, path + ".o", "-o", path + ".bin" }, path + ".link.log").ok) return b;
+  b.ran = Run({ path + ".bin" }, path + ".out").ok;
+  b.bytes = ReadFile(path + ".out");
+  return b;
+}
+
+int main(int argc, char* argv[])
+{
+  uint32_t random = (argc > 1) ? atoi(argv[1]) : 10;
+  uint32_t seed = (argc > 2) ? atoi(argv[2]) : 1;
+  std::string compiler = (argc > 3) ? argv[3] : "g++";
+
+  char cwd[4096];
+  struct stat st;
+  if (!getcwd(cwd, sizeof(cwd)) || stat("Descriptors/C++17/usb_descriptors.h", &st))
+  {
+    printf("Run from the repository root\n");
+    return 2;
+  }
+  std::string root = cwd;
+  char tmp[] = "/tmp/std_diff.XXXXXX";
+  if (!mkdtemp(tmp)) { printf("Cannot create temporary directory\n"); return 2; }
+  std::string dir = tmp;
+
+  std::vector<UNIT> units;
+  for (auto& p : Profiles) units.push_back(ProfileUnit(root, p));
+  RANDOM rnd(seed);
+  for (uint32_t i = 0; i < random; ++i) units.push_back(RandomUnit(root, i, rnd));
+
+  printf("%s, %u random configurations, seed %u\n\n", compiler.c_str(), random, seed);
+  printf("%-10s %-9s %17s %19s %17s\n", "", "", "compile s", "compiler MB", "object bytes");
+  printf("%-10s %-9s %8s %8s %9s %9s %8s %8s\n", "unit", "bytes", "C++17", "C++20", "C++17", "C++20", "C++17", "C++20");
+  uint32_t failures = 0;
+  double time17 = 0, time20 = 0;
+  long mem17 = 0, mem20 = 0;
+  for (size_t i = 0; i < units.size(); ++i)
+  {
+    std::string base = "unit" + std::to_string(i);
+    BUILD b17 = Build(compiler, dir, base, "c++17", units[i].source);
+    BUILD b20 = Build(compiler, dir, base, "c++20", units[i].source);
+    const char* verdict = (!b17.compile.ok || !b20.compile.ok) ? "NO BUILD"
+                        : (!b17.ran || !b20.ran) ? "NO RUN"
+                        : (b17.bytes != b20.bytes) ? "DIFFER" : "same";
+    if (strcmp(verdict, "same")) ++failures;
+    time17 += b17.compile.seconds;
+    time20 += b20.compile.seconds;
+    if (b17.compile.max_rss_kb > mem17) mem17 = b17.compile.max_rss_kb;
+    if (b20.compile.max_rss_kb > mem20) mem20 = b20.compile.max_rss_kb;
+    printf("%-10s %-9s %8.2f %8.2f %9.1f %9.1f %8llu %8llu\n", units[i].name.c_str(), verdict,
+           b17.compile.seconds, b20.compile.seconds, b17.compile.max_rss_kb / 1024.0, b20.compile.max_rss_kb / 1024.0,
+           (unsigned long long)b17.object, (unsigned long long)b20.object);
+  }
+  printf("\nTotal compile: C++17 %.2f s, C++20 %.2f s (%+.0f%%); peak compiler memory %.1f / %.1f MB\n",
+         time17, time20, time17 ? (time20 / time17 - 1) * 100 : 0.0, mem17 / 1024.0, mem20 / 1024.0);
+
+  if (failures)
+  {
+    printf("%u units failed, sources and output in %s\n", failures, dir.c_str());
+    return 1;
+  }
+  Run({ "rm", "-rf", dir }, "/dev/null");
+  printf("All units byte-identical\n");
+  return 0;
+}
@@ -0,0 +1,357 @@
+// Микробенчмарки горячих путей библиотеки на рабочей станции: поиск
+// дескриптора и стадия данных EP0 по каждому профилю, выдача строк, разбор
+// конфигурации видами (USB_VIEW), control передача целиком, очередь передач
+// точки (USB_EP) и запись трассировки. Для каждого - нс на операцию и, где
+// ядро дает счетчик (perf_event_open), инструкции на операцию.
+//
+//   g++ -std=c++20 -O2 Tools/usb_bench.cpp -o usb_bench
+//   ./usb_bench [--json] [filter] [ms]
+//       --json: результат одним объектом JSON для сравнения между сборками
+//       filter: только тесты, в имени которых есть эта подстрока
+//       ms:     время одного замера, по умолчанию 20; берется лучший из 5
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <iterator>
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "../Descriptors/usb_hid_descriptors.hpp"
+#include "../Descriptors/usb_cdc_descriptors.hpp"
+#include "../Descriptors/usb_2cdc_descriptors.hpp"
+#include "../Descriptors/usb_winusb_descriptors.hpp"
+#include "../Descriptors/usb_msd_descriptors.hpp"
+#include "../Descriptors/usb_uac2_descriptors.hpp"
+#include "../Descriptors/usb_uvc_descriptors.hpp"
+#include "../Descriptors/usb_ncm_descriptors.hpp"
+#include "../Descriptors/usb_dfu_descriptors.hpp"
+#include "../Device/usb_ep0_control.hpp"
+#include "../Device/usb_descriptor_view.hpp"
+#include "../Device/usb_endpoint_async.hpp"
+#include "../Device/usb_trace.hpp"
+
+struct PROFILE
+{
+  const char* name;
+  const USB_DESCRIPTORS::USB_PERSONALITY& personality;
+};
+
+static const PROFILE Profiles[] =
+{
+  { "HID", HID_PROFILE::Personality },
+  { "CDC", CDC_PROFILE::Personality },
+  { "CDCx2", CDCx2_PROFILE::Personality },
+  { "WinUSB", WINUSB_PROFILE::Personality },
+  { "MSD", MSD_PROFILE::Personality },
+  { "UAC2", UAC2_PROFILE::Personality },
+  { "UVC", UVC_PROFILE::Personality },
+  { "NCM", NCM_PROFILE::Personality },
+  { "DFU", DFU_PROFILE::Personality }
+};
+
+// Значение считается использованным - компилятор не выбросит вычисление
+template<typename T>
+static inline void Keep(const T& value) { asm volatile("" : : "r,m"(value) : "memory"); }
+
+//==============================================================================
+// Счетчик инструкций пользователя, -1 - недоступен
+//==============================================================================
+class INSTRUCTIONS
+{
+public:
+  INSTRUCTIONS()
+  {
+#if defined(__linux__)
+    perf_event_attr a{};
+    a.type = PERF_TYPE_HARDWARE;
+    a.size = sizeof(a);
+    a.config = PERF_COUNT_HW_INSTRUCTIONS;
+    a.disabled = 1;
+    a.exclude_kernel = 1;
+    a.exclude_hv = 1;
+    fd = int(syscall(__NR_perf_event_open, &a, 0, -1, -1, 0));
+#endif
+  }
+  ~INSTRUCTIONS()
+  {
+#if defined(__linux__)
+    if (fd >= 0) close(fd);
+#endif
+  }
+
+  bool Available() const { return fd >= 0; }
+
+  void Start()
+  {
+#if defined(__linux__)
+    if (fd < 0) return;
+    ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+    ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+  }
+
+  int64_t Stop()
+  {
+#if defined(__linux__)
+    if (fd < 0) return -1;
+    ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    uint64_t n = 0;
+    return (read(fd, &n, sizeof(n)) == sizeof(n)) ? int64_t(n) : -1;
+#else
+    return -1;
+#endif
+  }
+
+private:
+  int fd = -1;
+};
+
+//==============================================================================
+// Замер: вызовы партиями до ms миллисекунд, лучшая из 5 партий
+//==============================================================================
+struct RESULT
+{
+  std::string name;
+  double ns;              // на операцию
+  double instructions;    // на операцию, < 0 - нет счетчика
+  uint64_t ops;
+  uint32_t bytes;         // байт на операцию, 0 - не про данные
+};
+
+static std::vector<RESULT> Results;
+static const char* filter = "";
+static double ms = 20;
+static INSTRUCTIONS Counter;
+
+using CLOCK = std::chrono::steady_clock;
+
+// f() выполняет ops_per_call операций
+template<typename F>
+static void Bench(const std::string& name, uint32_t ops_per_call, uint32_t bytes, F&& f)
+{
+  if (!strstr(name.c_str(), filter)) return;
+  uint64_t calls = 1;
+  for (;;)
+  {
+    auto t0 = CLOCK::now();
+    for (uint64_t i = 0; i < calls; ++i) f();
+    if (std::chrono::duration<double, std::milli>(CLOCK::now() - t0).count() >= ms / 4) break;
+    calls *= 2;
+  }
+  calls *= 4;
+  double best = 1e300;
+  int64_t best_instructions = -1;
+  for (int rep = 0; rep < 5; ++rep)
+  {
+    Counter.Start();
+    auto t0 = CLOCK::now();
+    for (uint64_t i = 0; i < calls; ++i) f();
+    double ns = std::chrono::duration<double, std::nano>(CLOCK::now() - t0).count();
+    int64_t n = Counter.Stop();
+    if (ns < best) { best = ns; best_instructions = n; }
+  }
+  uint64_t ops = calls * ops_per_call;
+  Results.push_back({ name, best / ops, (best_instructions < 0) ? -1.0 : double(best_instructions) / ops, ops, bytes });
+}
+
+//==============================================================================
+// Дескрипторы и EP0
+//==============================================================================
+static void DescriptorBenches(const PROFILE& p)
+{
+  const auto& pers = p.personality;
+  const std::string name = p.name;
+  EP0::GET_DESCRIPTOR get(pers);
+
+  // Все дескрипторы профиля подряд: Device, конфигурации, строки
+  struct KEY { uint8_t type, index; };
+  std::vector<KEY> keys { { 1, 0 } };
+  for (uint8_t i = 0; i < pers.device[17]; ++i) keys.push_back({ 2, i });
+  for (uint8_t i = 0; i < pers.strings_count; ++i) keys.push_back({ 3, pers.strings[i][0] });
+  Bench("lookup/" + name, uint32_t(keys.size()), 0, [&]
+  {
+    for (auto& k : keys) Keep(get.Find(k.type, k.index));
+  });
+
+  // Конфигурация 0 целиком пакетами mps, как в прерывании EP0
+  const uint16_t total = pers.configurations[0].size;
+  uint8_t packet[64];
+  for (uint16_t mps : { 8, 64 })
+    Bench("ep0_stream/" + name + "/" + std::to_string(mps), 1, total, [&]
+    {
+      get.Start(2, 0, 0xFFFF, mps);
+      do Keep(get.Next(packet)); while (!get.Done());
+    });
+
+  // Строки: поиск и выдача на wLength 255, как запрашивает Windows
+  std::vector<uint8_t> indices;
+  for (uint8_t i = 0; i < pers.strings_count; ++i) indices.push_back(pers.strings[i][0]);
+  Bench("string/" + name, uint32_t(indices.size()), 0, [&]
+  {
+    for (uint8_t i : indices)
+    {
+      get.Start(3, i, 255, 64);
+      do Keep(get.Next(packet)); while (!get.Done());
+    }
+  });
+
+  // Разбор конфигурации: проверка и обход точек видами
+  std::vector<uint8_t> cfg;
+  const auto& list = pers.configurations[0];
+  for (uint8_t i = 0; i < list.count; ++i)
+    cfg.insert(cfg.end(), list.fragments[i].data, list.fragments[i].data + list.fragments[i].size);
+  Bench("validate/" + name, 1, total, [&] { Keep(USB_VIEW::Validate(cfg.data(), uint16_t(cfg.size())).error); });
+  Bench("view_endpoints/" + name, 1, total, [&]
+  {
+    uint32_t sum = 0;
+    for (auto ep : USB_VIEW::Descriptors<USB_VIEW::EndpointView>(cfg.data(), uint16_t(cfg.size())))
+      sum += ep.MaxPacketSize();
+    Keep(sum);
+  });
+}
+
+//==============================================================================
+// Control передача целиком: автомат EP0 против транспорта-заглушки
+//==============================================================================
+struct TRANSPORT
+{
+  bool tx = false, rx = false;
+  void Transmit(uint8_t, const uint8_t*, uint32_t) { tx = true; }
+  void Receive(uint8_t, uint8_t*, uint32_t) { rx = true; }
+  void Stall(uint8_t) {}
+  void SetAddress(uint8_t) {}
+};
+
+struct HANDLER
+{
+  void Configured(uint8_t) {}
+  int32_t Control(const uint8_t*, uint8_t*, uint16_t) { return EP0::STALL; }
+};
+
+template<typename TMachine>
+static void ControlTransfer(TMachine& ep0, TRANSPORT& t, const uint8_t* setup)
+{
+  t.tx = t.rx = false;
+  ep0.Setup(setup);
+  while (t.tx)
+  {
+    t.tx = false;
+    ep0.OnTransmitted();
+  }
+  if (t.rx) ep0.OnReceived(0);
+}
+
+static void ControlBenches()
+{
+  static constexpr uint8_t GetConfiguration[8] { 0x80, 0x06, 0x00, 0x02, 0x00, 0x00, 0xFF, 0x00 };
+  static constexpr uint8_t SetConfiguration[8] { 0x00, 0x09, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00 };
+  TRANSPORT t;
+  HANDLER h;
+  EP0::CONTROL<TRANSPORT, HANDLER> ep0(t, CDC_PROFILE::Personality, h);
+  EP0::CONTROL<TRANSPORT, HANDLER, 256, USB_TRACE::RING<1024>> traced(t, CDC_PROFILE::Personality, h);
+  Bench("control/get_configuration_descriptor", 1, CDC_PROFILE::Personality.configurations[0].size,
+        [&] { ControlTransfer(ep0, t, GetConfiguration); });
+  Bench("control/set_configuration", 1, 0, [&] { ControlTransfer(ep0, t, SetConfiguration); });
+  Bench("control/get_configuration_descriptor/traced", 1, CDC_PROFILE::Personality.configurations[0].size,
+        [&] { ControlTransfer(traced, t, GetConfiguration); });
+  Bench("trace/ring_setup", 1, 0, [&] { USB_TRACE::RING<1024>::Setup(GetConfiguration); });
+}
+
+//==============================================================================
+// Очередь передач точки: постановка и завершение без сопрограмм
+//==============================================================================
+struct EP_TRANSPORT
+{
+  uint32_t packets = 0;
+  void Transmit(uint8_t, const uint8_t*, uint32_t) { ++packets; }
+  void Receive(uint8_t, uint8_t*, uint32_t) { ++packets; }
+};
+
+static void EndpointBenches()
+{
+  using EPS = USB_EP::ENDPOINTS<decltype(CDC_PROFILE::Configuration_Descriptor), EP_TRANSPORT>;
+  EP_TRANSPORT t;
+  EPS eps(t);
+  auto& in = eps.Get<0x81>();
+  static uint8_t data[512];
+
+  Bench("endpoint/push_pop/64", 1, 64, [&]
+  {
+    auto w = in.Write({ data, 64 }, false);
+    eps.OnTransmitted(0x81);
+    Keep(w.Done());
+  });
+  // 4 передачи в очереди, затем все пакеты: цена очереди на передачу
+  Bench("endpoint/queue4/64", 4, 64, [&]
+  {
+    auto a = in.Write({ data, 64 }, false);
+    auto b = in.Write({ data, 64 }, false);
+    auto c = in.Write({ data, 64 }, false);
+    auto d = in.Write({ data, 64 }, false);
+    while (in.Busy()) eps.OnTransmitted(0x81);
+    Keep(d.Done());
+  });
+  // 512 байт: 8 пакетов и ZLP
+  Bench("endpoint/split_zlp/512", 1, 512, [&]
+  {
+    auto w = in.Write({ data, 512 });
+    while (in.Busy()) eps.OnTransmitted(0x81);
+    Keep(w.Done());
+  });
+}
+
+//==============================================================================
+// Вывод
+//==============================================================================
+static void Table()
+{
+  printf("%-46s %12s %12s %10s\n", "benchmark", "ns/op", "instr/op", "MB/s");
+  for (auto& r : Results)
+  {
+    char instr[32] = "-", mbs[32] = "-";
+    if (r.instructions >= 0) snprintf(instr, sizeof(instr), "%.1f", r.instructions);
+    if (r.bytes) snprintf(mbs, sizeof(mbs), "%.0f", r.bytes * 1e3 / r.ns);
+    printf("%-46s %12.2f %12s %10s\n", r.name.c_str(), r.ns, instr, mbs);
+  }
+  if (!Counter.Available()) printf("\ninstructions: perf_event_open unavailable\n");
+}
+
+static void Json()
+{
+  printf("{\n  \"compiler\": \"%s\",\n  \"standard\": %ld,\n  \"instructions\": %s,\n  \"benchmarks\": [\n",
+         __VERSION__, long(__cplusplus), Counter.Available() ? "true" : "false");
+  for (size_t i = 0; i < Results.size(); ++i)
+  {
+    auto& r = Results[i];
+    printf("    { \"name\": \"%s\", \"ns_per_op\": %.3f, ", r.name.c_str(), r.ns);
+    if (r.instructions >= 0) printf("\"instructions_per_op\": %.1f, ", r.instructions);
+    else printf("\"instructions_per_op\": null, ");
+    printf("\"bytes_per_op\": %u, \"ops\": %llu }%s\n", r.bytes, (unsigned long long)r.ops, (i + 1 < Results.size()) ? "," : "");
+  }
+  printf("  ]\n}\n");
+}
+
+int main(int argc, char* argv[])
+{
+  bool json = false;
+  int arg = 1;
+  if ((argc > arg) && !strcmp(argv[arg], "--json")) { json = true; ++arg; }
+  if (argc > arg) filter = argv[arg++];
+  if (argc > arg) ms = atof(argv[arg++]);
+
+  for (auto& p : Profiles) DescriptorBenches(p);
+  ControlBenches();
+  EndpointBenches();
+
+  if (json) Json();
+  else Table();
+  return Results.empty() ? 1 : 0;
+}
@@ -0,0 +1,302 @@
+#pragma once
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <map>
+#include <string>
+#include <vector>
+
+//==============================================================================
+// Control передачи EP0 из захвата шины
+//==============================================================================
+// Форматы:
+//   usbmon text (cat /sys/kernel/debug/usb/usbmon/1u, форматы 0u и 1u)
+//   pcap / pcapng, linktype 189 (USB_LINUX), 220 (USB_LINUX_MMAPPED) - Linux usbmon
+//   pcap / pcapng, linktype 249 (USBPCAP) - Windows USBPcap
+// Передача - пара SETUP и завершение, сопоставленные по тегу URB (IRP).
+// Текстовый usbmon хранит не больше 32 байт данных: data может быть короче length
+//==============================================================================
+namespace CAPTURE
+{
+
+struct CONTROL
+{
+  uint8_t setup[8];
+  int32_t status;              // 0, -EPIPE - STALL, прочие - ошибка на стороне хоста
+  uint32_t length;             // фактическая длина стадии данных
+  std::vector<uint8_t> data;   // захваченная часть ответа IN
+  double submit, complete;     // с, время захвата
+  uint16_t bus, device;
+
+  bool In() const { return setup[0] & 0x80; }
+  uint16_t wValue() const { return uint16_t(setup[2] | (setup[3] << 8)); }
+  uint16_t wIndex() const { return uint16_t(setup[4] | (setup[5] << 8)); }
+  uint16_t wLength() const { return uint16_t(setup[6] | (setup[7] << 8)); }
+};
+
+//==============================================================================
+// Сопоставление SETUP и завершения по тегу
+//==============================================================================
+class PAIRING
+{
+public:
+  explicit PAIRING(std::vector<CONTROL>& out) : out(out) {}
+
+  void Submit(uint64_t tag, const uint8_t* setup, double t, uint16_t bus, uint16_t device)
+  {
+    CONTROL c{};
+    memcpy(c.setup, setup, 8);
+    c.submit = t;
+    c.bus = bus;
+    c.device = device;
+    pending[tag] = c;
+  }
+
+  void Complete(uint64_t tag, int32_t status, uint32_t length, const uint8_t* data, uint32_t captured, double t)
+  {
+    auto it = pending.find(tag);
+    if (it == pending.end()) return;        // SETUP до начала захвата
+    CONTROL c = it->second;
+    pending.erase(it);
+    c.status = status;
+    c.length = length;
+    c.complete = t;
+    if (c.In() && data) c.data.assign(data, data + ((captured < length) ? captured : length));
+    out.push_back(c);
+  }
+
+private:
+  std::vector<CONTROL>& out;
+  std::map<uint64_t, CONTROL> pending;
+};
+
+//==============================================================================
+// usbmon text
+//==============================================================================
+// S Ci:1:005:0 s 80 06 0100 0000 0012 18 <
+// C Ci:1:005:0 0 18 = 12010002 00000040 83042a57 00020102 0301
+inline bool ParseUsbmonText(FILE* f, std::vector<CONTROL>& out)
+{
+  PAIRING pairing(out);
+  char line[1024];
+  bool any = false;
+  while (fgets(line, sizeof(line), f))
+  {
+    char* save = nullptr;
+    char* tok[64];
+    int n = 0;
+    for (char* t = strtok_r(line, " \t\r\n", &save); t && (n < 64); t = strtok_r(nullptr, " \t\r\n", &save)) tok[n++] = t;
+    if ((n < 5) || (tok[3][0] != 'C') || (tok[3][1] != 'i' && tok[3][1] != 'o')) continue;
+
+    // Адрес: Ci:bus:dev:ep (1u) или Ci:dev:ep (0u)
+    unsigned a[3]{};
+    int fields = sscanf(tok[3] + 3, "%u:%u:%u", &a[0], &a[1], &a[2]);
+    uint16_t bus = (fields == 3) ? a[0] : 0, device = (fields == 3) ? a[1] : a[0];
+    unsigned ep = (fields == 3) ? a[2] : a[1];
+    if (ep != 0) continue;
+
+    uint64_t tag = strtoull(tok[0], nullptr, 16);
+    double t = strtoull(tok[1], nullptr, 10) * 1e-6;
+    any = true;
+    if ((tok[2][0] == 'S') && (n >= 10) && !strcmp(tok[4], "s"))
+    {
+      uint8_t setup[8];
+      unsigned v[5];
+      for (int i = 0; i < 5; ++i) v[i] = unsigned(strtoul(tok[5 + i], nullptr, 16));
+      setup[0] = v[0]; setup[1] = v[1];
+      setup[2] = v[2]; setup[3] = v[2] >> 8;
+      setup[4] = v[3]; setup[5] = v[3] >> 8;
+      setup[6] = v[4]; setup[7] = v[4] >> 8;
+      pairing.Submit(tag, setup, t, bus, device);
+    }
+    else if (((tok[2][0] == 'C') || (tok[2][0] == 'E')) && (n >= 5))
+    {
+      int32_t status = int32_t(strtol(tok[4], nullptr, 10));
+      uint32_t length = (n > 5) ? uint32_t(strtoul(tok[5], nullptr, 10)) : 0;
+      std::vector<uint8_t> data;
+      if ((n > 6) && !strcmp(tok[6], "="))
+        for (int i = 7; i < n; ++i)
+          for (const char* p = tok[i]; p[0] && p[1]; p += 2)
+          {
+            char b[3] { p[0], p[1], 0 };
+            data.push_back(uint8_t(strtoul(b, nullptr, 16)));
+          }
+      if (tok[2][0] == 'E') length = 0;
+      pairing.Complete(tag, status, length, data.data(), uint32_t(data.size()), t);
+    }
+  }
+  return any;
+}
+
+//==============================================================================
+// pcap / pcapng
+//==============================================================================
+enum class LINKTYPE : uint32_t { USB_LINUX = 189, USB_LINUX_MMAPPED = 220, USBPCAP = 249 };
+
+class PACKET_READER
+{
+public:
+  explicit PACKET_READER(std::vector<CONTROL>& out) : pairing(out) {}
+
+  void Packet(LINKTYPE link, const uint8_t* p, uint32_t len, double t, bool swapped)
+  {
+    this->swapped = swapped;
+    if ((link == LINKTYPE::USB_LINUX) || (link == LINKTYPE::USB_LINUX_MMAPPED)) Usbmon(p, len, link == LINKTYPE::USB_LINUX ? 48 : 64);
+    else if (link == LINKTYPE::USBPCAP) UsbPcap(p, len, t);
+  }
+
+private:
+  uint16_t U16(const uint8_t* p) const { uint16_t v = uint16_t(p[0] | (p[1] << 8)); return swapped ? uint16_t((v >> 8) | (v << 8)) : v; }
+  uint32_t U32(const uint8_t* p) const { return swapped ? (uint32_t(U16(p)) << 16) | U16(p + 2) : uint32_t(U16(p)) | (uint32_t(U16(p + 2)) << 16); }
+  uint64_t U64(const uint8_t* p) const { return swapped ? (uint64_t(U32(p)) << 32) | U32(p + 4) : uint64_t(U32(p)) | (uint64_t(U32(p + 4)) << 32); }
+
+  // struct usbmon_packet (Documentation/usb/usbmon.rst), порядок байт хоста захвата
+  void Usbmon(const uint8_t* p, uint32_t len, uint32_t header)
+  {
+    if ((len < header) || (p[9] != 2) || (p[10] & 0x7F)) return;     // только control EP0
+    uint64_t tag = U64(p);
+    double t = double(int64_t(U64(p + 16))) + int32_t(U32(p + 24)) * 1e-6;
+    uint16_t bus = U16(p + 12), device = p[11];
+    if ((p[8] == 'S') && (p[14] == 0)) pairing.Submit(tag, p + 40, t, bus, device);
+    else if ((p[8] == 'C') || (p[8] == 'E'))
+    {
+      uint32_t captured = U32(p + 36);
+      if (captured > len - header) captured = len - header;
+      pairing.Complete(tag, (p[8] == 'E') ? -EPROTO : int32_t(U32(p + 28)), U32(p + 32), p + header, captured, t);
+    }
+  }
+
+  // USBPCAP_BUFFER_CONTROL_HEADER: всегда little endian
+  void UsbPcap(const uint8_t* p, uint32_t len, double t)
+  {
+    if ((len < 28) || (p[22] != 2) || (p[21] & 0x7F)) return;
+    uint16_t header = uint16_t(p[0] | (p[1] << 8));
+    if ((header < 28) || (header > len)) return;
+    uint64_t irp = 0;
+    for (int i = 7; i >= 0; --i) irp = (irp << 8) | p[2 + i];
+    uint32_t usbd = p[10] | (p[11] << 8) | (p[12] << 16) | (uint32_t(p[13]) << 24);
+    uint16_t bus = uint16_t(p[17] | (p[18] << 8)), device = uint16_t(p[19] | (p[20] << 8));
+    uint8_t stage = p[27];
+    if ((stage == 0) && !(p[16] & 1) && (len - header >= 8)) pairing.Submit(irp, p + header, t, bus, device);
+    else if ((stage == 3) && (p[16] & 1))
+    {
+      // USBD_STATUS_STALL_PID - STALL, остальные ошибки - как ошибки протокола
+      int32_t status = !usbd ? 0 : (usbd == 0xC0000004) ? -EPIPE : -EPROTO;
+      uint32_t length = p[23] | (p[24] << 8) | (p[25] << 16) | (uint32_t(p[26]) << 24);
+      pairing.Complete(irp, status, length, p + header, len - header, t);
+    }
+  }
+
+  PAIRING pairing;
+  bool swapped = false;
+};
+
+inline uint32_t Swap32(uint32_t v) { return (v >> 24) | ((v >> 8) & 0xFF00) | ((v << 8) & 0xFF0000) | (v << 24); }
+
+inline bool ParsePcap(const std::vector<uint8_t>& file, std::vector<CONTROL>& out)
+{
+  PACKET_READER reader(out);
+  auto u32 = [&](size_t o, bool sw) { uint32_t v; memcpy(&v, &file[o], 4); return sw ? Swap32(v) : v; };
+  uint32_t magic = u32(0, false);
+  bool sw = (magic == 0xD4C3B2A1) || (magic == 0x4D3CB2A1);
+  bool ns = (magic == 0xA1B23C4D) || (magic == 0x4D3CB2A1);
+  auto link = LINKTYPE(u32(20, sw));
+  for (size_t o = 24; o + 16 <= file.size(); )
+  {
+    uint32_t caplen = u32(o + 8, sw);
+    if (o + 16 + caplen > file.size()) break;
+    double t = u32(o, sw) + u32(o + 4, sw) * (ns ? 1e-9 : 1e-6);
+    reader.Packet(link, &file[o + 16], caplen, t, sw);
+    o += 16 + caplen;
+  }
+  return true;
+}
+
+inline bool ParsePcapng(const std::vector<uint8_t>& file, std::vector<CONTROL>& out)
+{
+  PACKET_READER reader(out);
+  struct INTERFACE { LINKTYPE link; double resolution; };
+  std::vector<INTERFACE> interfaces;
+  bool sw = false;
+  auto u16 = [&](size_t o) { uint16_t v; memcpy(&v, &file[o], 2); return sw ? uint16_t((v >> 8) | (v << 8)) : v; };
+  auto u32 = [&](size_t o) { uint32_t v; memcpy(&v, &file[o], 4); return sw ? Swap32(v) : v; };
+  for (size_t o = 0; o + 12 <= file.size(); )
+  {
+    uint32_t type = u32(o);
+    if (type == 0x0A0D0D0A)                 // Section Header: порядок байт секции
+    {
+      uint32_t bom;
+      memcpy(&bom, &file[o + 8], 4);
+      sw = (bom == 0x4D3C2B1A);
+      interfaces.clear();
+    }
+    uint32_t size = u32(o + 4);
+    if ((size < 12) || (o + size > file.size())) break;
+    if ((type == 1) && (size >= 20))        // Interface Description
+    {
+      INTERFACE itf { LINKTYPE(u16(o + 8)), 1e-6 };
+      for (size_t q = o + 16; q + 4 <= o + size - 4; )
+      {
+        uint16_t code = u16(q), len = u16(q + 2);
+        if (!code) break;
+        if ((code == 9) && len)             // if_tsresol
+        {
+          uint8_t r = file[q + 4];
+          itf.resolution = (r & 0x80) ? 1.0 / double(1ull << (r & 0x7F)) : 1.0;
+          if (!(r & 0x80)) for (uint8_t i = 0; i < r; ++i) itf.resolution /= 10;
+        }
+        q += 4 + ((len + 3u) & ~3u);
+      }
+      interfaces.push_back(itf);
+    }
+    else if ((type == 6) && (size >= 32))   // Enhanced Packet
+    {
+      uint32_t id = u32(o + 8);
+      uint32_t caplen = u32(o + 20);
+      if ((id < interfaces.size()) && (caplen <= size - 32))
+      {
+        double t = ((uint64_t(u32(o + 12)) << 32) | u32(o + 16)) * interfaces[id].resolution;
+        reader.Packet(interfaces[id].link, &file[o + 28], caplen, t, sw);
+      }
+    }
+    o += size;
+  }
+  return true;
+}
+
+//==============================================================================
+// Формат по содержимому файла. Пустая строка - ошибка
+//==============================================================================
+inline std::string Load(const char* path, std::vector<CONTROL>& out)
+{
+  FILE* f = fopen(path, "rb");
+  if (!f) return "";
+  std::vector<uint8_t> file;
+  uint8_t b[65536];
+  for (size_t n; (n = fread(b, 1, sizeof(b), f)) > 0; ) file.insert(file.end(), b, b + n);
+  std::string format;
+  uint32_t magic = 0;
+  if (file.size() >= 4) memcpy(&magic, file.data(), 4);
+  if ((magic == 0x0A0D0D0A) && (file.size() >= 28))
+  {
+    format = "pcapng";
+    ParsePcapng(file, out);
+  }
+  else if (((magic == 0xA1B2C3D4) || (magic == 0xD4C3B2A1) || (magic == 0xA1B23C4D) || (magic == 0x4D3CB2A1)) && (file.size() >= 24))
+  {
+    format = "pcap";
+    ParsePcap(file, out);
+  }
+  else
+  {
+    rewind(f);
+    if (ParseUsbmonText(f, out)) format = "usbmon text";
+  }
+  fclose(f);
+  return format;
+}
+
+} // namespace CAPTURE
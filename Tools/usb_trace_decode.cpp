@@ -0,0 +1,226 @@
+// Разбор снимка кольца трассировки (Device/usb_trace.hpp, USB_TRACE::BUFFER):
+// события по порядку с временем от первой записи и от предыдущей, SETUP -
+// запросом, дескрипторы - по именам DescriptorType библиотеки. В конце -
+// задержка от SETUP до конца передачи по видам запросов: то, что раньше
+// смотрели логическим анализатором.
+//
+//   g++ -std=c++17 -O2 Tools/usb_trace_decode.cpp -o usb_trace_decode
+//   ./usb_trace_decode trace.bin [MHz]
+//       MHz: частота счетчика тактов, если в снимке 0
+//
+// Снимок: (gdb) dump binary value trace.bin USB_TRACE::RING<256>::buffer
+// или ./ep0_bench 2 trace.bin
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if (__cplusplus > 201703L)
+#include "../Descriptors/C++20/usb_descriptors.hpp"
+#else
+#include "../Descriptors/C++17/usb_descriptors.h"
+#endif
+#include "../Device/usb_trace.hpp"
+
+using USB_TRACE::EVENT;
+using USB_TRACE::RECORD;
+
+//==============================================================================
+// Имена DescriptorType - из самого перечисления (имя значения в сигнатуре
+// шаблона), новые типы библиотеки появляются здесь без правки таблиц
+//==============================================================================
+template<DescriptorType type>
+constexpr std::string_view EnumName()
+{
+  // GCC: "... [with DescriptorType type = DescriptorType::DEVICE; ...]"
+  // Clang: "... [type = DescriptorType::DEVICE]", вне перечисления - "(DescriptorType)9"
+  std::string_view f = __PRETTY_FUNCTION__;
+  size_t begin = f.find("type = ");
+  if (begin == f.npos) return {};
+  begin += 7;
+  size_t end = f.find_first_of(";]", begin);
+  std::string_view v = f.substr(begin, end - begin);
+  size_t colon = v.rfind("::");
+  return (colon == v.npos) ? std::string_view{} : v.substr(colon + 2);
+}
+
+template<size_t... Is>
+static void FillNames(std::string_view* names, std::index_sequence<Is...>)
+{
+  ((names[Is] = EnumName<DescriptorType(Is)>()), ...);
+}
+
+static std::string DescriptorName(uint8_t type)
+{
+  static std::string_view names[256];
+  static bool filled = (FillNames(names, std::make_index_sequence<256>()), true);
+  (void)filled;
+  if (!names[type].empty()) return std::string(names[type]);
+  char s[8];
+  snprintf(s, sizeof(s), "0x%.2X", type);
+  return s;
+}
+
+static const char* RequestName(const uint8_t* setup)
+{
+  if (setup[0] & 0x60) return ((setup[0] & 0x60) == 0x20) ? "class" : "vendor";
+  switch (setup[1])
+  {
+    case 0x00: return "GET_STATUS";
+    case 0x01: return "CLEAR_FEATURE";
+    case 0x03: return "SET_FEATURE";
+    case 0x05: return "SET_ADDRESS";
+    case 0x06: return "GET_DESCRIPTOR";
+    case 0x07: return "SET_DESCRIPTOR";
+    case 0x08: return "GET_CONFIGURATION";
+    case 0x09: return "SET_CONFIGURATION";
+    case 0x0A: return "GET_INTERFACE";
+    case 0x0B: return "SET_INTERFACE";
+    default:   return "standard";
+  }
+}
+
+//==============================================================================
+// Снимок
+//==============================================================================
+struct TRACE
+{
+  uint32_t count = 0, head = 0, clock_hz = 0;
+  std::vector<RECORD> records;        // от старой к новой
+};
+
+static bool Load(const char* path, TRACE& t)
+{
+  FILE* f = fopen(path, "rb");
+  if (!f) return false;
+  uint32_t header[4];
+  bool ok = (fread(header, sizeof(header), 1, f) == 1) && (header[0] == USB_TRACE::MAGIC) && header[1];
+  if (ok)
+  {
+    t.count = header[1];
+    t.head = header[2];
+    t.clock_hz = header[3];
+    std::vector<RECORD> ring(t.count);
+    ok = fread(ring.data(), sizeof(RECORD), t.count, f) == t.count;
+    uint32_t n = (t.head < t.count) ? t.head : t.count;
+    for (uint32_t i = t.head - n; i != t.head; ++i) t.records.push_back(ring[i % t.count]);
+  }
+  fclose(f);
+  return ok;
+}
+
+//==============================================================================
+// Задержки по видам запросов
+//==============================================================================
+struct LATENCY
+{
+  std::string name;
+  uint32_t n = 0;
+  uint32_t min = ~0u, max = 0;
+  uint64_t sum = 0;
+  void Add(uint32_t v) { ++n; sum += v; if (v < min) min = v; if (v > max) max = v; }
+};
+
+static std::string Kind(const uint8_t* setup)
+{
+  std::string s = RequestName(setup);
+  if (!(setup[0] & 0x60) && (setup[1] == 0x06)) s += " " + DescriptorName(setup[3]);
+  return s;
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc < 2)
+  {
+    printf("usage: %s trace.bin [MHz]\n", argv[0]);
+    return 2;
+  }
+  TRACE t;
+  if (!Load(argv[1], t)) { printf("%s: not a trace snapshot\n", argv[1]); return 1; }
+  double hz = (argc > 2) ? atof(argv[2]) * 1e6 : t.clock_hz;
+  printf("%u records of %u written, clock %s\n\n", uint32_t(t.records.size()), t.head, hz ? "known" : "unknown (cycles)");
+
+  auto Time = [&](uint32_t cycles, char* s, size_t size)
+  {
+    if (hz) snprintf(s, size, "%10.3f us", cycles * 1e6 / hz);
+    else snprintf(s, size, "%10u cy", cycles);
+  };
+
+  std::vector<LATENCY> latency;
+  uint8_t setup[8]{};
+  uint32_t setup_time = 0;
+  bool open = false;
+  uint32_t first = t.records.empty() ? 0 : t.records[0].time, prev = first;
+  printf("    #          time         delta  event\n");
+  for (size_t i = 0; i < t.records.size(); ++i)
+  {
+    const RECORD& r = t.records[i];
+    char at[32], delta[32], what[128];
+    Time(r.time - first, at, sizeof(at));
+    Time(r.time - prev, delta, sizeof(delta));
+    prev = r.time;
+    bool done = false;
+    switch (r.event)
+    {
+      case EVENT::Setup:
+        memcpy(setup, r.data, 8);
+        setup_time = r.time;
+        open = true;
+        snprintf(what, sizeof(what), "SETUP      %.2X %.2X %.4X %.4X %.4X  %s", setup[0], setup[1],
+                 setup[2] | (setup[3] << 8), setup[4] | (setup[5] << 8), setup[6] | (setup[7] << 8), Kind(setup).c_str());
+        break;
+      case EVENT::Descriptor:
+        snprintf(what, sizeof(what), "DESCRIPTOR %s %u, %u bytes", DescriptorName(r.data[0]).c_str(), r.data[1], r.value);
+        break;
+      case EVENT::Complete:
+        done = (r.ep & 0x7F) == 0;
+        snprintf(what, sizeof(what), "COMPLETE   EP %.2X, %u bytes", r.ep,
+                 unsigned(r.data[0] | (r.data[1] << 8) | (r.data[2] << 16) | (uint32_t(r.data[3]) << 24)));
+        break;
+      case EVENT::Abort:
+        snprintf(what, sizeof(what), "ABORT      EP %.2X", r.ep);
+        if ((r.ep & 0x7F) == 0) open = false;
+        break;
+      case EVENT::Stall:
+        snprintf(what, sizeof(what), "STALL      EP %.2X", r.ep);
+        done = (r.ep & 0x7F) == 0;
+        break;
+      case EVENT::Nak:
+        snprintf(what, sizeof(what), "NAK        EP %.2X", r.ep);
+        break;
+      default:
+        snprintf(what, sizeof(what), "?          event %u (torn record)", unsigned(r.event));
+        break;
+    }
+    if (done && open)
+    {
+      open = false;
+      std::string kind = Kind(setup) + ((r.event == EVENT::Stall) ? " (STALL)" : "");
+      size_t k = 0;
+      while ((k < latency.size()) && (latency[k].name != kind)) ++k;
+      if (k == latency.size()) latency.push_back({ kind });
+      latency[k].Add(r.time - setup_time);
+      char l[32];
+      Time(r.time - setup_time, l, sizeof(l));
+      snprintf(what + strlen(what), sizeof(what) - strlen(what), "  [%s from SETUP]", l + strspn(l, " "));
+    }
+    printf("%5zu %s %s  %s\n", i, at, delta, what);
+  }
+
+  if (latency.empty()) return 0;
+  printf("\nSETUP to end of transfer:\n");
+  printf("  %-40s %5s %13s %13s %13s\n", "request", "n", "min", "avg", "max");
+  for (auto& l : latency)
+  {
+    char mn[32], avg[32], mx[32];
+    Time(l.min, mn, sizeof(mn));
+    Time(uint32_t(l.sum / l.n), avg, sizeof(avg));
+    Time(l.max, mx, sizeof(mx));
+    printf("  %-40s %5u %13s %13s %13s\n", l.name.c_str(), l.n, mn, avg, mx);
+  }
+  return 0;
+}
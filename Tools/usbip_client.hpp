@@ -0,0 +1,130 @@
+#pragma once
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+#include "usbip_protocol.hpp"
+
+//==============================================================================
+// Минимальный USB/IP клиент для стенда: без модуля vhci-hcd, URB синхронные
+//==============================================================================
+namespace USBIP
+{
+
+class CLIENT
+{
+public:
+  ~CLIENT() { Close(); }
+
+  // OP_REQ_DEVLIST на отдельном соединении, как usbip list -r. Число устройств
+  int DevList(uint16_t port, DEVICE_INFO* devices, int max)
+  {
+    int fd = Connect(port);
+    if (fd < 0) return -1;
+    uint8_t b[OP_HEADER_SIZE + 4];
+    Op(b, OP_REQ_DEVLIST);
+    int count = -1;
+    if (WriteAll(fd, b, OP_HEADER_SIZE) && ReadAll(fd, b, sizeof(b)) &&
+        (Get16(b + 2) == OP_REP_DEVLIST) && !Get32(b + 4))
+    {
+      count = int(Get32(b + 8));
+      for (int i = 0; i < count; ++i)
+      {
+        uint8_t d[DEVICE_SIZE], it[4];
+        DEVICE_INFO info;
+        if (!ReadAll(fd, d, sizeof(d))) { count = -1; break; }
+        info.Unpack(d);
+        for (uint8_t j = 0; j < info.bNumInterfaces; ++j)
+          if (!ReadAll(fd, it, sizeof(it))) { count = -1; break; }
+        if (count < 0) break;
+        if (i < max) devices[i] = info;
+      }
+    }
+    close(fd);
+    return count;
+  }
+
+  // OP_REQ_IMPORT: после него соединение несет URB
+  bool Import(uint16_t port, const char* busid, DEVICE_INFO& device)
+  {
+    Close();
+    fd = Connect(port);
+    if (fd < 0) return false;
+    uint8_t b[OP_HEADER_SIZE + BUSID_SIZE + DEVICE_SIZE]{};
+    Op(b, OP_REQ_IMPORT);
+    strncpy((char*)b + OP_HEADER_SIZE, busid, BUSID_SIZE - 1);
+    if (!WriteAll(fd, b, OP_HEADER_SIZE + BUSID_SIZE) || !ReadAll(fd, b, OP_HEADER_SIZE) ||
+        (Get16(b + 2) != OP_REP_IMPORT) || Get32(b + 4) || !ReadAll(fd, b, DEVICE_SIZE))
+    {
+      Close();
+      return false;
+    }
+    device.Unpack(b);
+    devid = (device.busnum << 16) | device.devnum;
+    return true;
+  }
+
+  // Результат URB: actual_length или status (-EPIPE - STALL)
+  int32_t Control(uint8_t bmRequestType, uint8_t bRequest, uint16_t wValue, uint16_t wIndex,
+                  uint8_t* data, uint16_t wLength)
+  {
+    uint8_t setup[8] { bmRequestType, bRequest, uint8_t(wValue), uint8_t(wValue >> 8),
+                       uint8_t(wIndex), uint8_t(wIndex >> 8), uint8_t(wLength), uint8_t(wLength >> 8) };
+    return Submit(bmRequestType & 0x80, setup, data, wLength);
+  }
+
+  int32_t Bulk(uint8_t ep, uint8_t* data, uint32_t len)
+  {
+    uint8_t setup[8]{};
+    return Submit(ep, setup, data, len);
+  }
+
+  void Close()
+  {
+    if (fd >= 0) close(fd);
+    fd = -1;
+  }
+
+private:
+  static void Op(uint8_t* b, uint16_t code)
+  {
+    Put16(b, VERSION);
+    Put16(b + 2, code);
+    Put32(b + 4, 0);
+  }
+
+  static int Connect(uint16_t port)
+  {
+    int s = socket(AF_INET, SOCK_STREAM, 0);
+    if (s < 0) return -1;
+    int on = 1;
+    setsockopt(s, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    sockaddr_in a{};
+    a.sin_family = AF_INET;
+    a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    a.sin_port = htons(port);
+    if (connect(s, (sockaddr*)&a, sizeof(a))) { close(s); return -1; }
+    return s;
+  }
+
+  int32_t Submit(uint8_t ep, const uint8_t* setup, uint8_t* data, uint32_t len)
+  {
+    bool in = ep & 0x80;
+    URB_HEADER h { CMD_SUBMIT, ++seqnum, devid, in ? DIR_IN : DIR_OUT, uint32_t(ep & 0x0F), { 0, len }, {} };
+    memcpy(h.setup, setup, 8);
+    if ((fd < 0) || !h.Write(fd) || (!in && len && !WriteAll(fd, data, len))) return -EIO;
+    URB_HEADER r;
+    if (!r.Read(fd) || (r.command != RET_SUBMIT) || (r.seqnum != seqnum)) return -EIO;
+    int32_t status = int32_t(r.u[0]);
+    uint32_t actual = r.u[1];
+    if (in && actual && ((actual > len) || !ReadAll(fd, data, actual))) return -EIO;
+    return status ? status : int32_t(actual);
+  }
+
+  int fd = -1;
+  uint32_t devid = 0;
+  uint32_t seqnum = 0;
+};
+
+} // namespace USBIP
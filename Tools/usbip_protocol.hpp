@@ -0,0 +1,160 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+//==============================================================================
+// USB/IP: общая часть сервера и клиента
+// (Documentation/usb/usbip_protocol.rst). Поля заголовков - big endian,
+// SETUP пакет и данные - как на шине
+//==============================================================================
+namespace USBIP
+{
+
+constexpr uint16_t VERSION = 0x0111;
+constexpr uint16_t PORT = 3240;
+
+constexpr uint16_t OP_REQ_DEVLIST = 0x8005;
+constexpr uint16_t OP_REP_DEVLIST = 0x0005;
+constexpr uint16_t OP_REQ_IMPORT  = 0x8003;
+constexpr uint16_t OP_REP_IMPORT  = 0x0003;
+
+constexpr uint32_t CMD_SUBMIT = 1;
+constexpr uint32_t CMD_UNLINK = 2;
+constexpr uint32_t RET_SUBMIT = 3;
+constexpr uint32_t RET_UNLINK = 4;
+
+constexpr uint32_t DIR_OUT = 0;
+constexpr uint32_t DIR_IN  = 1;
+
+// enum usb_device_speed ядра
+constexpr uint32_t SPEED_LOW = 1, SPEED_FULL = 2, SPEED_HIGH = 3, SPEED_SUPER = 5;
+
+constexpr uint32_t OP_HEADER_SIZE = 8;      // version, code, status
+constexpr uint32_t DEVICE_SIZE = 312;       // usbip_usb_device
+constexpr uint32_t URB_HEADER_SIZE = 48;    // usbip_header
+constexpr uint32_t BUSID_SIZE = 32;
+
+// Наибольший transfer_buffer_length: EP0 - wLength, прочие точки - с запасом
+// к URB ядра (usb-storage - до 240 КБ). Длиннее - клиент сломан, разрыв
+constexpr uint32_t MAX_EP0_URB = 0xFFFF;
+constexpr uint32_t MAX_URB = 1u << 20;
+
+// Ответ обработчика точки: STALL или число байт (0 - NAK)
+constexpr int32_t STALL = -1;
+
+inline void Put16(uint8_t* p, uint16_t v) { p[0] = v >> 8; p[1] = v; }
+inline void Put32(uint8_t* p, uint32_t v) { p[0] = v >> 24; p[1] = v >> 16; p[2] = v >> 8; p[3] = v; }
+inline uint16_t Get16(const uint8_t* p) { return uint16_t((p[0] << 8) | p[1]); }
+inline uint32_t Get32(const uint8_t* p) { return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | p[3]; }
+
+inline bool ReadAll(int fd, void* buf, size_t len)
+{
+  for (auto p = (uint8_t*)buf; len; )
+  {
+    ssize_t n = recv(fd, p, len, 0);
+    if (n <= 0) { if ((n < 0) && (errno == EINTR)) continue; return false; }
+    p += n;
+    len -= n;
+  }
+  return true;
+}
+
+inline bool WriteAll(int fd, const void* buf, size_t len)
+{
+  for (auto p = (const uint8_t*)buf; len; )
+  {
+    ssize_t n = send(fd, p, len, MSG_NOSIGNAL);
+    if (n <= 0) { if ((n < 0) && (errno == EINTR)) continue; return false; }
+    p += n;
+    len -= n;
+  }
+  return true;
+}
+
+//==============================================================================
+// usbip_usb_device
+//==============================================================================
+struct DEVICE_INFO
+{
+  char path[256];
+  char busid[BUSID_SIZE];
+  uint32_t busnum, devnum, speed;
+  uint16_t idVendor, idProduct, bcdDevice;
+  uint8_t bDeviceClass, bDeviceSubClass, bDeviceProtocol;
+  uint8_t bConfigurationValue, bNumConfigurations, bNumInterfaces;
+
+  void Pack(uint8_t* p) const
+  {
+    memcpy(p, path, 256);
+    memcpy(p + 256, busid, BUSID_SIZE);
+    Put32(p + 288, busnum);
+    Put32(p + 292, devnum);
+    Put32(p + 296, speed);
+    Put16(p + 300, idVendor);
+    Put16(p + 302, idProduct);
+    Put16(p + 304, bcdDevice);
+    p[306] = bDeviceClass;
+    p[307] = bDeviceSubClass;
+    p[308] = bDeviceProtocol;
+    p[309] = bConfigurationValue;
+    p[310] = bNumConfigurations;
+    p[311] = bNumInterfaces;
+  }
+
+  void Unpack(const uint8_t* p)
+  {
+    memcpy(path, p, 256);
+    memcpy(busid, p + 256, BUSID_SIZE);
+    path[255] = busid[BUSID_SIZE - 1] = 0;
+    busnum = Get32(p + 288);
+    devnum = Get32(p + 292);
+    speed = Get32(p + 296);
+    idVendor = Get16(p + 300);
+    idProduct = Get16(p + 302);
+    bcdDevice = Get16(p + 304);
+    bDeviceClass = p[306];
+    bDeviceSubClass = p[307];
+    bDeviceProtocol = p[308];
+    bConfigurationValue = p[309];
+    bNumConfigurations = p[310];
+    bNumInterfaces = p[311];
+  }
+};
+
+//==============================================================================
+// usbip_header: базовая часть и поля команды
+//   CMD_SUBMIT: transfer_flags, transfer_buffer_length, start_frame, number_of_packets, interval, setup
+//   RET_SUBMIT: status, actual_length, start_frame, number_of_packets, error_count
+//   CMD_UNLINK: unlink_seqnum;  RET_UNLINK: status
+//==============================================================================
+struct URB_HEADER
+{
+  uint32_t command, seqnum, devid, direction, ep;
+  uint32_t u[5];
+  uint8_t setup[8];
+
+  bool Read(int fd)
+  {
+    uint8_t b[URB_HEADER_SIZE];
+    if (!ReadAll(fd, b, sizeof(b))) return false;
+    uint32_t* f[] { &command, &seqnum, &devid, &direction, &ep, &u[0], &u[1], &u[2], &u[3], &u[4] };
+    for (uint8_t i = 0; i < 10; ++i) *f[i] = Get32(b + 4 * i);
+    memcpy(setup, b + 40, 8);
+    return true;
+  }
+
+  bool Write(int fd) const
+  {
+    uint8_t b[URB_HEADER_SIZE];
+    const uint32_t f[] { command, seqnum, devid, direction, ep, u[0], u[1], u[2], u[3], u[4] };
+    for (uint8_t i = 0; i < 10; ++i) Put32(b + 4 * i, f[i]);
+    memcpy(b + 40, setup, 8);
+    return WriteAll(fd, b, sizeof(b));
+  }
+};
+
+} // namespace USBIP
@@ -0,0 +1,248 @@
+// Стенд USB/IP без железа и без vhci-hcd: сервер с устройством из личности
+// профиля и минимальный клиент в одном процессе, обмен через 127.0.0.1.
+// Время перечисления всех личностей и bulk скорость BOT движка на образе.
+//
+//   g++ -std=c++17 -O2 -pthread Tools/usbip_rig.cpp -o usbip_rig
+//   ./usbip_rig [image] [image MB] [command KB]
+//       command KB: не больше USBIP::MAX_URB (1024)
+//   ./usbip_rig serve [image] [image MB]     MSD на порту 3240:
+//       modprobe vhci-hcd && usbip attach -r 127.0.0.1 -b 1-1
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <iterator>
+#include <chrono>
+#include <thread>
+
+#include "../Descriptors/usb_personalities.hpp"
+#include "../Device/usb_msc_bot.hpp"
+#include "../Device/block_device_mmap.hpp"
+#include "usbip_server.hpp"
+#include "usbip_client.hpp"
+
+using MSD_PROFILE::MSD_INTERFACE;
+using DEVICE = MMAP_BLOCK_DEVICE<512>;
+
+//==============================================================================
+// Обработчик без функций: только стандартные запросы EP0
+//==============================================================================
+struct NO_FUNCTIONS
+{
+  void Configured(uint8_t) {}
+  int32_t Control(const uint8_t*, uint8_t*, uint16_t) { return USBIP::STALL; }
+  int32_t In(uint8_t, uint8_t*, uint32_t) { return 0; }
+  int32_t Out(uint8_t, const uint8_t*, uint32_t) { return 0; }
+  void Poll() {}
+};
+
+//==============================================================================
+// BOT движок на точках USB/IP: TTransport движка и обработчик сервера
+//==============================================================================
+class BOT_LINK
+{
+public:
+  using ENGINE = MSC::BOT<MSD_INTERFACE, BOT_LINK, DEVICE>;
+
+  explicit BOT_LINK(DEVICE& device) : engine(*this, device) {}
+
+  // TTransport
+  void Transmit(uint8_t, const uint8_t* buf, uint32_t len) { tx = { const_cast<uint8_t*>(buf), len, 0, true }; }
+  void Receive(uint8_t, uint8_t* buf, uint32_t len) { rx = { buf, len, 0, true }; }
+  void Stall(uint8_t ep) { (ep & 0x80) ? halt_in = true : halt_out = true; }
+
+  // Обработчик USBIP::SERVER
+  void Configured(uint8_t value) { if (value) engine.Start(); }
+
+  int32_t Control(const uint8_t* setup, uint8_t* data, uint16_t len)
+  {
+    const uint8_t type = setup[0], request = setup[1];
+    if ((type == 0xA1) && (request == 0xFE) && len) { data[0] = ENGINE::MaxLun(); return 1; }  // GET_MAX_LUN
+    if ((type == 0x21) && (request == 0xFF)) { engine.Reset(); return 0; }     // Mass Storage Reset
+    if ((type == 0x02) && (request == 0x01))                                   // CLEAR_FEATURE(ENDPOINT_HALT)
+    {
+      (setup[4] & 0x80) ? halt_in = false : halt_out = false;
+      return 0;
+    }
+    if ((type == 0x01) && (request == 0x0B))                                   // SET_INTERFACE: движок знает только BOT (alt 0)
+      return ((setup[2] | setup[3]) || (setup[4] != MSD_INTERFACE::InterfaceNumber()) || setup[5]) ? USBIP::STALL : 0;
+    return USBIP::STALL;
+  }
+
+  int32_t In(uint8_t, uint8_t* buf, uint32_t len)
+  {
+    if (halt_in) return USBIP::STALL;
+    if (!tx.armed) return 0;
+    uint32_t n = Move(tx, len);
+    memcpy(buf, tx.buf + tx.pos - n, n);
+    if (tx.pos == tx.len) { tx.armed = false; engine.OnTransmitted(); }
+    return int32_t(n);
+  }
+
+  int32_t Out(uint8_t, const uint8_t* buf, uint32_t len)
+  {
+    if (halt_out) return USBIP::STALL;
+    if (!rx.armed) return 0;
+    uint32_t n = Move(rx, len);
+    memcpy(rx.buf + rx.pos - n, buf, n);
+    // Конец URB - конец передачи хоста
+    if ((rx.pos == rx.len) || (n == len)) { rx.armed = false; engine.OnReceived(rx.pos); }
+    return int32_t(n);
+  }
+
+  void Poll() { engine.Poll(); }
+
+private:
+  struct XFER { uint8_t* buf; uint32_t len, pos; bool armed; };
+
+  static uint32_t Move(XFER& x, uint32_t len)
+  {
+    uint32_t n = (x.len - x.pos < len) ? x.len - x.pos : len;
+    x.pos += n;
+    return n;
+  }
+
+  ENGINE engine;
+  XFER tx{}, rx{};
+  bool halt_in = false, halt_out = false;
+};
+
+//==============================================================================
+// Хост
+//==============================================================================
+using CLOCK = std::chrono::steady_clock;
+
+static double Since(CLOCK::time_point t0) { return std::chrono::duration<double>(CLOCK::now() - t0).count(); }
+
+// Как ядро: дескриптор устройства (64, затем полный), конфигурации (9, затем
+// wTotalLength), строки, SET_CONFIGURATION(1). Число control передач или -1
+static int Enumerate(USBIP::CLIENT& host)
+{
+  uint8_t dev[64], buf[1024];
+  int transfers = 0;
+  auto get = [&](uint8_t type, uint8_t index, uint16_t lang, uint8_t* b, uint16_t len)
+  {
+    ++transfers;
+    return host.Control(0x80, 0x06, uint16_t((type << 8) | index), lang, b, len);
+  };
+  if ((get(1, 0, 0, dev, 64) < 8) || (get(1, 0, 0, dev, 18) != 18)) return -1;
+  for (uint8_t i = 0; i < dev[17]; ++i)
+  {
+    if (get(2, i, 0, buf, 9) != 9) return -1;
+    uint16_t total = buf[2] | (buf[3] << 8);
+    if ((total > sizeof(buf)) || (get(2, i, 0, buf, total) != total)) return -1;
+  }
+  if (get(3, 0, 0, buf, 255) < 4) return -1;
+  uint16_t lang = buf[2] | (buf[3] << 8);
+  for (uint8_t index : { dev[14], dev[15], dev[16] })
+    if (index && (get(3, index, lang, buf, 255) < 2)) return -1;
+  ++transfers;
+  if (host.Control(0x00, 0x09, 1, 0, nullptr, 0) < 0) return -1;
+  return transfers;
+}
+
+static void EnumerationTime(const char* name, const USB_DESCRIPTORS::USB_PERSONALITY& personality, int runs)
+{
+  NO_FUNCTIONS functions;
+  USBIP::SERVER<NO_FUNCTIONS> server(personality, functions);
+  if (!server.Listen(0)) { printf("Cannot listen\n"); exit(1); }
+  std::thread device([&] { server.Serve(); server.Serve(); });
+
+  USBIP::CLIENT host;
+  USBIP::DEVICE_INFO info[1];
+  bool ok = (host.DevList(server.Port(), info, 1) == 1) && host.Import(server.Port(), server.BusId(), info[0]);
+  int transfers = 0;
+  auto t0 = CLOCK::now();
+  for (int i = 0; ok && (i < runs); ++i) ok = (transfers = Enumerate(host)) > 0;
+  double s = Since(t0);
+  host.Close();
+  device.join();
+  printf("%-8s %.4X:%.4X %2d control transfers, %7.1f us per enumeration %s\n", name,
+         info[0].idVendor, info[0].idProduct, transfers, s / runs * 1e6, ok ? "" : "FAILED");
+}
+
+static void MakeCBW(uint8_t* cbw, uint32_t tag, uint8_t op, uint32_t lba, uint16_t blocks, bool in)
+{
+  uint32_t len = blocks * 512u;
+  memset(cbw, 0, 31);
+  memcpy(cbw, "USBC", 4);
+  memcpy(cbw + 4, &tag, 4);
+  memcpy(cbw + 8, &len, 4);
+  cbw[12] = in ? 0x80 : 0x00;
+  cbw[14] = 10;
+  cbw[15] = op;
+  cbw[17] = lba >> 24; cbw[18] = lba >> 16; cbw[19] = lba >> 8; cbw[20] = lba;
+  cbw[22] = blocks >> 8; cbw[23] = blocks;
+}
+
+static void Throughput(DEVICE& image, uint32_t cmd_kb)
+{
+  BOT_LINK link(image);
+  USBIP::SERVER<BOT_LINK> server(MSD_PROFILE::Personality, link);
+  if (!server.Listen(0)) { printf("Cannot listen\n"); exit(1); }
+  std::thread device([&] { server.Serve(); });
+
+  USBIP::CLIENT host;
+  USBIP::DEVICE_INFO info;
+  uint8_t lun = 0xFF;
+  bool ok = host.Import(server.Port(), server.BusId(), info) && (Enumerate(host) > 0) &&
+            (host.Control(0xA1, 0xFE, 0, 0, &lun, 1) == 1) && (lun == 0);
+
+  const uint8_t in_ep = MSD_INTERFACE::DataInEp(), out_ep = MSD_INTERFACE::DataOutEp();
+  const uint16_t blocks = uint16_t(cmd_kb * 2);
+  const uint32_t count = uint32_t(image.BlockCount() / blocks);
+  const uint32_t bytes = blocks * 512u;
+  auto* data = new uint8_t[bytes];
+
+  for (auto op : { MSC::SCSI_OP::WRITE_10, MSC::SCSI_OP::READ_10 })
+  {
+    bool in = (op == MSC::SCSI_OP::READ_10);
+    auto t0 = CLOCK::now();
+    for (uint32_t i = 0; ok && (i < count); ++i)
+    {
+      uint8_t cbw[31], csw[13];
+      MakeCBW(cbw, i, uint8_t(op), i * blocks, blocks, in);
+      for (uint32_t j = 0; !in && (j < bytes); ++j) data[j] = uint8_t(i * 7 + j);
+      ok = (host.Bulk(out_ep, cbw, sizeof(cbw)) == sizeof(cbw)) &&
+           (host.Bulk(in ? in_ep : out_ep, data, bytes) == int32_t(bytes)) &&
+           (host.Bulk(in_ep, csw, sizeof(csw)) == sizeof(csw)) &&
+           !memcmp(csw, "USBS", 4) && !memcmp(csw + 4, cbw + 4, 4) && (csw[12] == 0);
+      for (uint32_t j = 0; ok && in && (j < bytes); ++j) ok = (data[j] == uint8_t(i * 7 + j));
+    }
+    double s = Since(t0);
+    printf("MSD BOT  %-5s %7.1f MB/s %s\n", in ? "READ" : "WRITE", double(count) * bytes / s / 1e6, ok ? "" : "FAILED");
+  }
+  delete[] data;
+  host.Close();
+  device.join();
+}
+
+int main(int argc, char* argv[])
+{
+  bool serve = (argc > 1) && !strcmp(argv[1], "serve");
+  if (serve) { --argc; ++argv; }
+  const char* path = (argc > 1) ? argv[1] : "msc_image.bin";
+  uint32_t image_mb = (argc > 2) ? atoi(argv[2]) : 16;
+  uint32_t cmd_kb = (argc > 3) ? atoi(argv[3]) : 64;
+  if (cmd_kb > (USBIP::MAX_URB >> 10)) cmd_kb = USBIP::MAX_URB >> 10;
+
+  DEVICE image(path, uint64_t(image_mb) << 11);
+  if (!image.IsOpen()) { printf("Cannot open %s\n", path); return 1; }
+
+  if (serve)
+  {
+    BOT_LINK link(image);
+    USBIP::SERVER<BOT_LINK> server(MSD_PROFILE::Personality, link);
+    if (!server.Listen()) { printf("Cannot listen on %u\n", USBIP::PORT); return 1; }
+    printf("MSD %s %u MB on 127.0.0.1:%u, bus id %s\n", path, image_mb, server.Port(), server.BusId());
+    while (true) server.Serve();
+  }
+
+  const char* names[] { "HID", "CDC", "WinUSB", "MSD" };
+  static_assert(std::size(names) == std::size(Personalities), "Personality names mismatch");
+  for (size_t i = 0; i < std::size(Personalities); ++i)
+    EnumerationTime(names[i], Personalities[i], 1000);
+
+  printf("Image %s %u MB, %u KB per command\n", path, image_mb, cmd_kb);
+  Throughput(image, cmd_kb);
+  return 0;
+}
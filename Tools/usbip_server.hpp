@@ -0,0 +1,297 @@
+#pragma once
+
+#include <poll.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <deque>
+#include <vector>
+
+#if (__cplusplus > 201703L)
+#include "../Descriptors/C++20/usb_descriptors.hpp"
+#else
+#include "../Descriptors/C++17/usb_descriptors.h"
+#endif
+#include "../Device/usb_ep0_descriptors.hpp"
+#include "../Device/usb_descriptor_view.hpp"
+#include "usbip_protocol.hpp"
+
+//==============================================================================
+// USB/IP сервер: устройство из личности профиля (USB_PERSONALITY) на сокете
+// 127.0.0.1. Стандартные запросы EP0 обслуживает сам, остальное - обработчик
+//==============================================================================
+// Обработчик (THandler), вызывается из потока Serve():
+//   void Configured(uint8_t value);                                SET_CONFIGURATION
+//   int32_t Control(const uint8_t* setup, uint8_t* data, uint16_t len);
+//                   прочие запросы EP0: длина ответа IN (OUT - 0) или STALL
+//   int32_t In(uint8_t ep, uint8_t* buf, uint32_t len);   выдано байт, 0 - NAK
+//   int32_t Out(uint8_t ep, const uint8_t* buf, uint32_t len); принято байт, 0 - NAK
+//   void Poll();                                                   основной цикл
+//
+// URB на точку, которую обработчик не готов обслужить, ждет в очереди. IN
+// завершается коротким пакетом (выдано не кратно wMaxPacketSize) или полным
+// буфером, OUT - когда обработчик принял все данные. URB длиннее MAX_URB
+// (EP0 - MAX_EP0_URB) рвет соединение
+//==============================================================================
+namespace USBIP
+{
+
+template<typename THandler>
+class SERVER
+{
+public:
+  SERVER(const USB_DESCRIPTORS::USB_PERSONALITY& personality, THandler& handler, uint32_t speed = SPEED_FULL)
+    : personality(personality), handler(handler), speed(speed), descriptors(personality) {}
+
+  ~SERVER() { if (listener >= 0) close(listener); }
+
+  // port 0 - любой свободный, см. Port()
+  bool Listen(uint16_t port = PORT)
+  {
+    listener = socket(AF_INET, SOCK_STREAM, 0);
+    if (listener < 0) return false;
+    int on = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    sockaddr_in a{};
+    a.sin_family = AF_INET;
+    a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    a.sin_port = htons(port);
+    socklen_t len = sizeof(a);
+    if (bind(listener, (sockaddr*)&a, sizeof(a)) || listen(listener, 1) ||
+        getsockname(listener, (sockaddr*)&a, &len)) return false;
+    this->port = ntohs(a.sin_port);
+    return true;
+  }
+
+  uint16_t Port() const { return port; }
+  static constexpr const char* BusId() { return "1-1"; }
+
+  // Одно соединение: OP_REQ_DEVLIST или OP_REQ_IMPORT и затем URB до закрытия.
+  // true - устройство было импортировано
+  bool Serve()
+  {
+    int fd = accept(listener, nullptr, nullptr);
+    if (fd < 0) return false;
+    int on = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    bool imported = false;
+    uint8_t op[OP_HEADER_SIZE];
+    if (ReadAll(fd, op, sizeof(op)) && (Get16(op) == VERSION))
+    {
+      if (Get16(op + 2) == OP_REQ_DEVLIST) DevList(fd);
+      else if (Get16(op + 2) == OP_REQ_IMPORT) imported = Import(fd);
+    }
+    close(fd);
+    return imported;
+  }
+
+private:
+  struct URB
+  {
+    uint32_t seqnum;
+    uint8_t ep;              // с битом направления
+    uint32_t done;
+    std::vector<uint8_t> buf;
+  };
+
+  //----------------------------------------------------------------------------
+  // OP_REQ_DEVLIST / OP_REQ_IMPORT
+  //----------------------------------------------------------------------------
+  DEVICE_INFO Info() const
+  {
+    const uint8_t* d = personality.device;
+    DEVICE_INFO info{};
+    strcpy(info.path, "/sys/devices/usbip/usb1/1-1");
+    strcpy(info.busid, BusId());
+    info.busnum = 1;
+    info.devnum = 2;
+    info.speed = speed;
+    info.idVendor = d[8] | (d[9] << 8);
+    info.idProduct = d[10] | (d[11] << 8);
+    info.bcdDevice = d[12] | (d[13] << 8);
+    info.bDeviceClass = d[4];
+    info.bDeviceSubClass = d[5];
+    info.bDeviceProtocol = d[6];
+    info.bConfigurationValue = configuration;
+    info.bNumConfigurations = d[17];
+    info.bNumInterfaces = Configuration(0)[4];
+    return info;
+  }
+
+  void DevList(int fd)
+  {
+    auto cfg = Configuration(0);
+    uint8_t b[OP_HEADER_SIZE + 4 + DEVICE_SIZE];
+    Put16(b, VERSION);
+    Put16(b + 2, OP_REP_DEVLIST);
+    Put32(b + 4, 0);
+    Put32(b + 8, 1);
+    Info().Pack(b + 12);
+    if (!WriteAll(fd, b, sizeof(b))) return;
+    // bInterfaceClass, bInterfaceSubClass, bInterfaceProtocol, padding - для alt 0
+    for (auto itf : USB_VIEW::Descriptors<USB_VIEW::InterfaceView>(cfg.data(), uint16_t(cfg.size())))
+    {
+      if (itf.AlternateSetting()) continue;
+      uint8_t it[4] { itf.Class(), itf.SubClass(), itf.Protocol(), 0 };
+      if (!WriteAll(fd, it, sizeof(it))) return;
+    }
+  }
+
+  bool Import(int fd)
+  {
+    char busid[BUSID_SIZE];
+    if (!ReadAll(fd, busid, sizeof(busid))) return false;
+    busid[BUSID_SIZE - 1] = 0;
+    bool ok = !strcmp(busid, BusId());
+    uint8_t b[OP_HEADER_SIZE + DEVICE_SIZE];
+    Put16(b, VERSION);
+    Put16(b + 2, OP_REP_IMPORT);
+    Put32(b + 4, ok ? 0 : 1);
+    Info().Pack(b + 8);
+    if (!WriteAll(fd, b, ok ? sizeof(b) : OP_HEADER_SIZE) || !ok) return false;
+    configuration = 0;
+    Run(fd);
+    return true;
+  }
+
+  //----------------------------------------------------------------------------
+  // Поток URB
+  //----------------------------------------------------------------------------
+  void Run(int fd)
+  {
+    pollfd p { fd, POLLIN, 0 };
+    while (true)
+    {
+      p.revents = 0;
+      if (poll(&p, 1, urbs.empty() ? 10 : 0) < 0) break;
+      if (p.revents & (POLLERR | POLLHUP | POLLNVAL)) break;
+      if ((p.revents & POLLIN) && !Command(fd)) break;
+      handler.Poll();
+      if (!Complete(fd)) break;
+    }
+    urbs.clear();
+  }
+
+  bool Command(int fd)
+  {
+    URB_HEADER h;
+    if (!h.Read(fd)) return false;
+    if (h.command == CMD_UNLINK)
+    {
+      uint32_t status = 0;
+      for (auto u = urbs.begin(); u != urbs.end(); ++u)
+        if (u->seqnum == h.u[0]) { urbs.erase(u); status = uint32_t(-ECONNRESET); break; }
+      URB_HEADER r { RET_UNLINK, h.seqnum, 0, 0, 0, { status }, {} };
+      return r.Write(fd);
+    }
+    if (h.command != CMD_SUBMIT) return false;
+    if ((h.ep > 15) || (h.u[1] > (h.ep ? MAX_URB : MAX_EP0_URB))) return false;
+
+    URB urb { h.seqnum, uint8_t(h.ep | (h.direction == DIR_IN ? 0x80 : 0)), 0, std::vector<uint8_t>(h.u[1]) };
+    if ((h.direction == DIR_OUT) && h.u[1] && !ReadAll(fd, urb.buf.data(), h.u[1])) return false;
+    if (h.ep) { urbs.push_back(std::move(urb)); return true; }
+
+    int32_t n = Setup(h.setup, urb.buf.data(), uint16_t(urb.buf.size()));
+    if ((n != STALL) && (h.direction == DIR_OUT)) n = int32_t(urb.buf.size());
+    return Reply(fd, urb, n);
+  }
+
+  // Первый URB каждой точки - обработчику
+  bool Complete(int fd)
+  {
+    uint32_t busy = 0;          // точки, у которых раньше в очереди есть незавершенный URB
+    for (auto u = urbs.begin(); u != urbs.end(); )
+    {
+      uint32_t bit = 1u << ((u->ep & 0x0F) | ((u->ep & 0x80) >> 3));
+      if (busy & bit) { ++u; continue; }
+      uint32_t left = uint32_t(u->buf.size()) - u->done;
+      int32_t n = (u->ep & 0x80) ? handler.In(u->ep, u->buf.data() + u->done, left)
+                                 : handler.Out(u->ep, u->buf.data() + u->done, left);
+      bool end = (n == STALL) || (uint32_t(n) == left) ||
+                 ((u->ep & 0x80) && n && (n % MaxPacketSize(u->ep)));
+      if (n > 0) u->done += n;
+      if (!end) { busy |= bit; ++u; continue; }
+      if (!Reply(fd, *u, (n == STALL) ? STALL : int32_t(u->done))) return false;
+      u = urbs.erase(u);
+    }
+    return true;
+  }
+
+  bool Reply(int fd, const URB& urb, int32_t n)
+  {
+    bool in = urb.ep & 0x80;
+    uint32_t len = (n == STALL) ? 0 : uint32_t(n);
+    URB_HEADER r { RET_SUBMIT, urb.seqnum, 0, 0, 0, { (n == STALL) ? uint32_t(-EPIPE) : 0, len }, {} };
+    return r.Write(fd) && (!in || !len || WriteAll(fd, urb.buf.data(), len));
+  }
+
+  //----------------------------------------------------------------------------
+  // EP0
+  //----------------------------------------------------------------------------
+  int32_t Setup(const uint8_t* setup, uint8_t* data, uint16_t len)
+  {
+    const uint8_t type = setup[0], request = setup[1];
+    const uint16_t value = setup[2] | (setup[3] << 8);
+    if ((type & 0x7F) == 0)   // стандартный, к устройству
+      switch (request)
+      {
+        case 0x00:            // GET_STATUS
+          if (len < 2) return STALL;
+          data[0] = data[1] = 0;
+          return 2;
+        case 0x05: return 0;  // SET_ADDRESS
+        case 0x06:            // GET_DESCRIPTOR
+          if (((setup[6] | (setup[7] << 8)) > len) || !descriptors.Setup(setup, 64)) return STALL;
+          return Read(descriptors, data);
+        case 0x08:            // GET_CONFIGURATION
+          if (len < 1) return STALL;
+          data[0] = configuration;
+          return 1;
+        case 0x09:            // SET_CONFIGURATION
+          if (value > personality.device[17]) return STALL;
+          configuration = uint8_t(value);
+          ep_config = configuration ? Configuration(configuration - 1) : std::vector<uint8_t>();
+          handler.Configured(configuration);
+          return 0;
+      }
+    return handler.Control(setup, data, len);
+  }
+
+  // Стадия данных EP0 пакетами, как на контроллере; ответ не длиннее wLength
+  template<typename TStream>
+  static int32_t Read(TStream& stream, uint8_t* data)
+  {
+    int32_t n = 0;
+    do n += stream.Next(data + n); while (!stream.Done());
+    return n;
+  }
+
+  std::vector<uint8_t> Configuration(uint8_t index) const
+  {
+    auto& list = personality.configurations[index];
+    std::vector<uint8_t> cfg(list.size);
+    EP0::GATHER_STREAM<USB_DESCRIPTORS::GATHER_LIST> stream;
+    stream.Start(list, list.size, 64);
+    Read(stream, cfg.data());
+    return cfg;
+  }
+
+  uint16_t MaxPacketSize(uint8_t ep) const
+  {
+    for (auto e : USB_VIEW::Descriptors<USB_VIEW::EndpointView>(ep_config.data(), uint16_t(ep_config.size())))
+      if (e.Address() == ep) return e.MaxPacketSize();
+    return 64;
+  }
+
+  const USB_DESCRIPTORS::USB_PERSONALITY& personality;
+  THandler& handler;
+  uint32_t speed;
+  EP0::GET_DESCRIPTOR descriptors;
+  int listener = -1;
+  uint16_t port = 0;
+  uint8_t configuration = 0;
+  std::vector<uint8_t> ep_config;   // текущая конфигурация, для wMaxPacketSize
+  std::deque<URB> urbs;
+};
+
+} // namespace USBIP
@@ -0,0 +1,247 @@
+// Перечисление реального хоста из захвата (usbmon text, pcap/pcapng usbmon или
+// USBPcap) на GET_DESCRIPTOR библиотеки (Device/usb_ep0_descriptors.hpp) для
+// выбранного профиля. Ответы сравниваются с захватом, для каждого запроса -
+// время обработки на рабочей станции и время ответа в захвате.
+// Linux, Windows и macOS по-разному запрашивают дескрипторы (wLength 64/255/9,
+// порядок строк) - жалоба "на хосте X долго" становится воспроизводимой.
+//
+//   g++ -std=c++17 -O2 Tools/usbmon_replay.cpp -o usbmon_replay
+//   ./usbmon_replay capture profile [device] [runs]
+//       profile: HID CDC CDCx2 WinUSB MSD UAC2 UVC NCM DFU
+//       device:  адрес на шине, по умолчанию - из первого SET_ADDRESS
+//   Код возврата 1 - ответ библиотеки отличается от захвата
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <iterator>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "../Descriptors/usb_hid_descriptors.hpp"
+#include "../Descriptors/usb_cdc_descriptors.hpp"
+#include "../Descriptors/usb_2cdc_descriptors.hpp"
+#include "../Descriptors/usb_winusb_descriptors.hpp"
+#include "../Descriptors/usb_msd_descriptors.hpp"
+#include "../Descriptors/usb_uac2_descriptors.hpp"
+#include "../Descriptors/usb_uvc_descriptors.hpp"
+#include "../Descriptors/usb_ncm_descriptors.hpp"
+#include "../Descriptors/usb_dfu_descriptors.hpp"
+#include "../Device/usb_ep0_descriptors.hpp"
+#include "usb_capture.hpp"
+
+struct PROFILE
+{
+  const char* name;
+  const USB_DESCRIPTORS::USB_PERSONALITY& personality;
+};
+
+static const PROFILE Profiles[] =
+{
+  { "HID", HID_PROFILE::Personality },
+  { "CDC", CDC_PROFILE::Personality },
+  { "CDCx2", CDCx2_PROFILE::Personality },
+  { "WinUSB", WINUSB_PROFILE::Personality },
+  { "MSD", MSD_PROFILE::Personality },
+  { "UAC2", UAC2_PROFILE::Personality },
+  { "UVC", UVC_PROFILE::Personality },
+  { "NCM", NCM_PROFILE::Personality },
+  { "DFU", DFU_PROFILE::Personality }
+};
+
+//==============================================================================
+// Время: steady_clock и, где есть, счетчик TSC
+//==============================================================================
+using CLOCK = std::chrono::steady_clock;
+
+static uint64_t Ticks()
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+//==============================================================================
+// Запрос и результат повтора
+//==============================================================================
+static const char* DescriptorName(uint8_t type)
+{
+  switch (type)
+  {
+    case 0x01: return "DEVICE";
+    case 0x02: return "CONFIGURATION";
+    case 0x03: return "STRING";
+    case 0x06: return "DEVICE_QUALIFIER";
+    case 0x07: return "OTHER_SPEED";
+    case 0x0F: return "BOS";
+    case 0x21: return "HID";
+    case 0x22: return "REPORT";
+    default:   return "?";
+  }
+}
+
+static const char* RequestName(const CAPTURE::CONTROL& c)
+{
+  if (c.setup[0] & 0x60) return ((c.setup[0] & 0x60) == 0x20) ? "class" : "vendor";
+  switch (c.setup[1])
+  {
+    case 0x00: return "GET_STATUS";
+    case 0x01: return "CLEAR_FEATURE";
+    case 0x03: return "SET_FEATURE";
+    case 0x05: return "SET_ADDRESS";
+    case 0x06: return "GET_DESCRIPTOR";
+    case 0x08: return "GET_CONFIGURATION";
+    case 0x09: return "SET_CONFIGURATION";
+    case 0x0A: return "GET_INTERFACE";
+    case 0x0B: return "SET_INTERFACE";
+    default:   return "standard";
+  }
+}
+
+// Ответ библиотеки: false - STALL
+static bool Dispatch(EP0::GET_DESCRIPTOR& get, const uint8_t* setup, uint16_t mps, uint8_t* data, uint16_t& len)
+{
+  len = 0;
+  if (!get.Setup(setup, mps)) return false;
+  do len += get.Next(data + len); while (!get.Done());
+  return true;
+}
+
+struct RESULT
+{
+  const CAPTURE::CONTROL* c;
+  bool stall;
+  uint16_t length;
+  const char* verdict;
+  double ns_min, ns_median, ns_max;
+  double ticks;
+};
+
+int main(int argc, char* argv[])
+{
+  if (argc < 3)
+  {
+    printf("usage: %s capture profile [device] [runs]\n", argv[0]);
+    return 2;
+  }
+  const PROFILE* profile = nullptr;
+  for (auto& p : Profiles)
+    if (!strcasecmp(p.name, argv[2])) profile = &p;
+  if (!profile) { printf("Unknown profile %s\n", argv[2]); return 2; }
+  int device = (argc > 3) ? atoi(argv[3]) : -1;
+  uint32_t runs = (argc > 4) ? atoi(argv[4]) : 21;
+  if (!runs) runs = 1;
+
+  std::vector<CAPTURE::CONTROL> all;
+  std::string format = CAPTURE::Load(argv[1], all);
+  if (format.empty()) { printf("Cannot read %s\n", argv[1]); return 2; }
+
+  // Устройство: адрес из первого SET_ADDRESS, иначе - с наибольшим числом GET_DESCRIPTOR
+  uint16_t bus = 0;
+  if (device < 0)
+    for (auto& c : all)
+      if ((c.setup[0] == 0x00) && (c.setup[1] == 0x05) && !c.status) { device = c.wValue(); bus = c.bus; break; }
+  if (device < 0)
+  {
+    uint32_t count[128]{};
+    uint16_t best = 0;
+    for (auto& c : all)
+      if ((c.setup[1] == 0x06) && c.device && (c.device < 128) && (++count[c.device] > count[best]))
+      {
+        best = c.device;
+        bus = c.bus;
+      }
+    if (best) device = best;
+  }
+  if (device < 0) { printf("No enumeration in %s\n", argv[1]); return 2; }
+  if (!bus)
+    for (auto& c : all)
+      if (c.device == device) { bus = c.bus; break; }
+
+  // До SET_ADDRESS устройство отвечает по адресу 0
+  std::vector<const CAPTURE::CONTROL*> sequence;
+  for (auto& c : all)
+    if ((c.bus == bus) && ((c.device == device) || !c.device)) sequence.push_back(&c);
+  printf("%s: %s, %zu control transfers, device %u:%03u - %zu, profile %s\n", argv[1], format.c_str(),
+         all.size(), bus, device, sequence.size(), profile->name);
+
+  EP0::GET_DESCRIPTOR get(profile->personality);
+  const uint16_t mps = profile->personality.device[7];
+  std::vector<RESULT> results;
+  uint32_t differ = 0, replayed = 0, skipped = 0;
+  uint8_t data[65536];
+  double total_ns = 0, host_us = 0;
+
+  for (auto* c : sequence)
+  {
+    RESULT r { c, false, 0, "", 0, 0, 0, 0 };
+    bool standard_get = (c->setup[0] == 0x80) && (c->setup[1] == 0x06);
+    if (!standard_get || ((c->status != 0) && (c->status != -EPIPE)))
+    {
+      r.verdict = standard_get ? "host error" : "not replayed";
+      ++skipped;
+      results.push_back(r);
+      continue;
+    }
+    ++replayed;
+    r.stall = !Dispatch(get, c->setup, mps, data, r.length);
+
+    // Совпадение: STALL с STALL, длина и захваченная часть байтов
+    bool captured_stall = (c->status == -EPIPE);
+    if (r.stall != captured_stall) r.verdict = r.stall ? "DIFF: stall" : "DIFF: expected stall";
+    else if (!r.stall && (r.length != c->length)) r.verdict = "DIFF: length";
+    else if (!r.stall && memcmp(data, c->data.data(), c->data.size())) r.verdict = "DIFF: bytes";
+    else r.verdict = "ok";
+    if (r.verdict[0] == 'D') ++differ;
+
+    // Время: серии по 1000 повторов, мин/медиана/макс по сериям
+    std::vector<double> ns;
+    uint64_t ticks = 0;
+    for (uint32_t run = 0; run < runs; ++run)
+    {
+      uint16_t len;
+      auto t0 = CLOCK::now();
+      uint64_t k0 = Ticks();
+      for (int i = 0; i < 1000; ++i) Dispatch(get, c->setup, mps, data, len);
+      ticks += Ticks() - k0;
+      ns.push_back(std::chrono::duration<double, std::nano>(CLOCK::now() - t0).count() / 1000);
+    }
+    std::sort(ns.begin(), ns.end());
+    r.ns_min = ns.front();
+    r.ns_median = ns[ns.size() / 2];
+    r.ns_max = ns.back();
+    r.ticks = double(ticks) / runs / 1000;
+    total_ns += r.ns_median;
+    host_us += (c->complete - c->submit) * 1e6;
+    results.push_back(r);
+  }
+
+  printf("  #  request           descriptor         wLength  capture  library  %-20s  ns min/med/max       ticks  host us\n", "result");
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    auto& r = results[i];
+    auto& c = *r.c;
+    char capture[16], library[16];
+    if (c.status == -EPIPE) snprintf(capture, sizeof(capture), "STALL");
+    else if (c.status) snprintf(capture, sizeof(capture), "%d", int(c.status));
+    else snprintf(capture, sizeof(capture), "%u", unsigned(c.length));
+    if (r.ns_median <= 0) snprintf(library, sizeof(library), "-");
+    else if (r.stall) snprintf(library, sizeof(library), "STALL");
+    else snprintf(library, sizeof(library), "%u", r.length);
+    char descriptor[24] = "";
+    if (c.setup[1] == 0x06) snprintf(descriptor, sizeof(descriptor), "%s %u", DescriptorName(c.setup[3]), c.setup[2]);
+    printf("%3zu  %-17s %-18s %7u  %7s  %7s  %-20s", i + 1, RequestName(c), descriptor, c.wLength(), capture, library, r.verdict);
+    if (r.ns_median > 0) printf("  %5.1f/%5.1f/%5.1f  %6.0f", r.ns_min, r.ns_median, r.ns_max, r.ticks);
+    else printf("  %17s  %6s", "", "");
+    printf("  %7.0f\n", (c.complete - c.submit) * 1e6);
+  }
+  printf("GET_DESCRIPTOR replayed %u, differ %u, other requests %u\n", replayed, differ, skipped);
+  printf("Library %.2f us for the sequence, host saw %.0f us\n", total_ns / 1e3, host_us);
+  return differ ? 1 : 0;
+}
@@ -1,30 +1,85 @@
 #include <stdio.h>
+#include "Device/usb_ep0_stream.hpp"
+#include "Device/usb_descriptor_view.hpp"
 
 #define CUSTOM_HID
 //#define CDC
 //#define CDCx2
 //#define WIN_USB
 //#define MSD
+//#define UAC2
+//#define UVC
+//#define NCM
+//#define DFU
+//#define PERSONALITIES   // вместе с одним из профилей
 
 
 #ifdef CUSTOM_HID
 #include "Descriptors/usb_hid_descriptors.hpp"
+using namespace HID_PROFILE;
 #endif
 
 #ifdef CDC
 #include "Descriptors/usb_cdc_descriptors.hpp"
+using namespace CDC_PROFILE;
 #endif
 
 #ifdef CDCx2
 #include "Descriptors/usb_2cdc_descriptors.hpp"
+using namespace CDCx2_PROFILE;
 #endif
 
 #ifdef WIN_USB
 #include "Descriptors/usb_winusb_descriptors.hpp"
+using namespace WINUSB_PROFILE;
 #endif
 
 #ifdef MSD
 #include "Descriptors/usb_msd_descriptors.hpp"
+using namespace MSD_PROFILE;
+#endif
+
+#ifdef UAC2
+#include "Descriptors/usb_uac2_descriptors.hpp"
+using namespace UAC2_PROFILE;
+#endif
+
+#ifdef UVC
+#include "Descriptors/usb_uvc_descriptors.hpp"
+using namespace UVC_PROFILE;
+#endif
+
+#ifdef NCM
+#include "Descriptors/usb_ncm_descriptors.hpp"
+using namespace NCM_PROFILE;
+#endif
+
+#ifdef DFU
+#include "Descriptors/usb_dfu_descriptors.hpp"
+using namespace DFU_PROFILE;
+#endif
+
+#ifdef PERSONALITIES
+#include "Descriptors/usb_personalities.hpp"
+#endif
+
+// Байты конфигурации глазами хоста: длины и счетчики согласованы
+static_assert(USB_VIEW::Validate(Configuration_Descriptor.buf).Ok(), "Configuration descriptor is inconsistent");
+
+#if defined(NCM) || defined(CDCx2)
+// GET_DESCRIPTOR(CONFIGURATION) пакетами EP0 из списка фрагментов
+static void PrintGathered(const GATHER_LIST& list)
+{
+  EP0::GATHER_STREAM<GATHER_LIST> stream;
+  uint8_t packet[64];
+  stream.Start(list, 0xFFFF, sizeof(packet));
+  do
+  {
+    uint16_t len = stream.Next(packet);
+    for(uint16_t i = 0; i < len; i++) 
+      printf("%.2X ", packet[i]);
+  } while(!stream.Done());
+}
 #endif
 
 int main()
@@ -42,6 +97,61 @@ int main()
   for(auto &x : HidReportDescriptor.buf) 
     printf("%.2X ", x);
 #endif
+
+#ifdef WIN_USB
+  printf("\nStripe info %i bytes:\n", sizeof(Stripe_Info));
+  for(auto &x : Stripe_Info.buf) 
+    printf("%.2X ", x);
+
+  printf("\nFunctionFS descriptors %i bytes:\n", sizeof(Ffs_Descriptors));
+  for(auto &x : Ffs_Descriptors.buf) 
+    printf("%.2X ", x);
+
+  printf("\nFunctionFS strings %i bytes:\n", sizeof(Ffs_Strings));
+  for(auto &x : Ffs_Strings.buf) 
+    printf("%.2X ", x);
+#endif
+
+#ifdef NCM
+  printf("\nNTB parameters %i bytes:\n", sizeof(Ntb_Parameters));
+  for(auto &x : Ntb_Parameters.buf) 
+    printf("%.2X ", x);
+
+  for(uint8_t i = 0; i < CONFIGURATIONS::Count(); i++)
+  {
+    auto cfg = CONFIGURATIONS::Descriptor(i);
+    printf("\nConfiguration %i descriptor %i bytes:\n", i + 1, cfg.size);
+    PrintGathered(cfg);
+    auto prg = CONFIGURATIONS::Program(i + 1);
+    for(uint8_t j = 0; j < prg.count; j++)
+      printf("\n  EP %.2X attr %.2X size %3u buffer %.4X%s", prg.ep[j].address, prg.ep[j].attributes,
+             prg.ep[j].size, prg.ep[j].buffer, prg.ep[j].enable ? " enable" : "");
+  }
+#endif
+
+#ifdef CDCx2
+  for(uint8_t i = 0; i < CONFIGURATIONS::Count(); i++)
+  {
+    auto cfg = CONFIGURATIONS::Descriptor(i);
+    printf("\nConfiguration %i descriptor %i bytes, %i fragments:\n", i + 1, cfg.size, cfg.count);
+    PrintGathered(cfg);
+  }
+  printf("\nVCP 0 fragment shared: %s",
+         (CONFIGURATIONS::Descriptor(0).fragments[1].data == CONFIGURATIONS::Descriptor(1).fragments[1].data) ? "yes" : "no");
+#endif
+
+#ifdef PERSONALITIES
+  for(auto &x : Personalities)
+    printf("\nPersonality: device %.4X:%.4X, configuration %u bytes, %u strings",
+           x.device[8] | (x.device[9] << 8), x.device[10] | (x.device[11] << 8),
+           x.configurations[0].size, x.strings_count);
+#endif
+
+  using BW_FS = PERIODIC_BANDWIDTH<decltype(Configuration_Descriptor), USB_SPEED::FULL>;
+  using BW_HS = PERIODIC_BANDWIDTH<decltype(Configuration_Descriptor), USB_SPEED::HIGH>;
+  printf("\nPeriodic bandwidth FS: %u/%u ns (%u%%), HS: %u/%u ns (%u%%)",
+         BW_FS::Reserved(), BW_FS::Budget(), BW_FS::Utilization(),
+         BW_HS::Reserved(), BW_HS::Budget(), BW_HS::Utilization());
   
   Configuration_Descriptor.GetDescriptorList().GetEndpoints().foreach
   (